@@ -1,6 +1,9 @@
 #include "cstring.h"
 #include "utest/utest.h"
 #include <wchar.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#endif
 
 static const char literal[]     = "abcde";
 static const wchar_t wliteral[] = L"abcde";
@@ -45,6 +48,42 @@ UTEST(string, cstring_init) {
     cstring_free(wstr);
 }
 
+UTEST(string, cstring_local) {
+    cstring_local(str, char, 15);
+    const char *const buf = str;
+
+    ASSERT_EQ(cstring_size(str), 0U);
+    ASSERT_EQ(cstring_capacity(str), 15U);
+    ASSERT_STREQ(str, "");
+
+    cstring_assign(str, "abc", 3);
+    cstring_append(str, "defghijklmno", 12);
+    ASSERT_EQ(str, buf);
+    ASSERT_STREQ(str, "abcdefghijklmno");
+    cstring_pop_back(str);
+    cstring_shrink_to_fit(str);
+    ASSERT_EQ(cstring_capacity(str), 15U);
+    cstring_push_back(str, 'o');
+    ASSERT_EQ(cstring_size(str), 15U);
+    ASSERT_EQ(cstring_capacity(str), 15U);
+
+    /* spill to the heap */
+    cstring_push_back(str, 'p');
+    ASSERT_NE(str, buf);
+    ASSERT_TRUE(cstring_get_allocator(str) == NULL);
+    ASSERT_STREQ(str, "abcdefghijklmnop");
+    cstring_free(str);
+
+    /* -- wide string -- */
+
+    {
+        cstring_local(wstr, wchar_t, 4);
+        cstring_assign(wstr, L"abcd", 4);
+        ASSERT_TRUE(wcseq(wstr, L"abcd"));
+        cstring_free(wstr);
+    }
+}
+
 UTEST(string, cstring_assign_clear) {
     cstring_string_type(char) str = NULL;
 
@@ -244,6 +283,69 @@ UTEST(string, cstring_reserve) {
     cstring_free(wstr);
 }
 
+UTEST(string, cstring_growth_policy) {
+    size_t i, cap, reallocs = 0;
+    cstring_string_type(char) str = NULL;
+
+    cstring_push_back(str, 'a');
+    cap = cstring_capacity(str);
+    for (i = 1; i < 100000; ++i) {
+        cstring_push_back(str, 'a');
+        if (cstring_capacity(str) != cap) {
+            ASSERT_GT(cstring_capacity(str), cap);
+            cap = cstring_capacity(str);
+            ++reallocs;
+        }
+    }
+    ASSERT_EQ(cstring_size(str), 100000U);
+    ASSERT_GE(cstring_capacity(str), cstring_size(str));
+    ASSERT_LT(reallocs, 40U);
+
+    cstring_reserve(str, 200000);
+    ASSERT_EQ(cstring_capacity(str), 200000U);
+
+    cstring_free(str);
+
+    /* -- wide string -- */
+
+    cstring_string_type(wchar_t) wstr = NULL;
+    reallocs                          = 0;
+
+    cstring_assign(wstr, L"a", 1);
+    cap = cstring_capacity(wstr);
+    for (i = 1; i < 100000; ++i) {
+        cstring_append(wstr, L"a", 1);
+        if (cstring_capacity(wstr) != cap) {
+            cap = cstring_capacity(wstr);
+            ++reallocs;
+        }
+    }
+    ASSERT_EQ(cstring_size(wstr), 100000U);
+    ASSERT_LT(reallocs, 40U);
+
+    cstring_free(wstr);
+
+    /* -- vector -- */
+
+    cstring_array_type(char) arr = NULL;
+    reallocs                     = 0;
+
+    cstring_array_push_back(arr, "a", 1);
+    cap = cstring_array_capacity(arr);
+    for (i = 1; i < 10000; ++i) {
+        cstring_array_push_back(arr, "a", 1);
+        if (cstring_array_capacity(arr) != cap) {
+            cap = cstring_array_capacity(arr);
+            ++reallocs;
+        }
+    }
+    ASSERT_EQ(cstring_array_size(arr), 10000U);
+    ASSERT_EQ(arr[10000], NULL);
+    ASSERT_LT(reallocs, 30U);
+
+    cstring_array_free(arr);
+}
+
 UTEST(string, cstring_shrink_to_fit) {
     cstring_string_type(char) str = NULL;
     cstring_assign(str, literal, strlen_of(literal));
@@ -588,6 +690,73 @@ UTEST(string, cstring_replace) {
     cstring_free(zerolenstr);
 }
 
+UTEST(string, cstring_replace_all) {
+    size_t i, cnt;
+    cstring_string_type(char) str     = NULL;
+    cstring_string_type(char) ref     = NULL;
+    cstring_string_type(wchar_t) wstr = NULL;
+
+    /* shrinking, in place */
+    cstring_assign(str, "a--b--c----", 11);
+    cstring_replace_all(str, "--", 2, "+", 1);
+    ASSERT_EQ(cstring_size(str), 7U);
+    ASSERT_STREQ(str, "a+b+c++");
+    cstring_replace_all(str, "+", 1, "", 0);
+    ASSERT_STREQ(str, "abc");
+
+    /* same length */
+    cstring_replace_all(str, "b", 1, "x", 1);
+    ASSERT_STREQ(str, "axc");
+
+    /* growing, non-overlapping occurrences from the left */
+    cstring_assign(str, "aaaaa", 5);
+    cstring_replace_all(str, "aa", 2, "<b>", 3);
+    ASSERT_EQ(cstring_size(str), 7U);
+    ASSERT_STREQ(str, "<b><b>a");
+    cstring_replace_all(str, "<", 1, "&lt;", 4);
+    ASSERT_STREQ(str, "&lt;b>&lt;b>a");
+    cstring_replace_all(str, "q", 1, "xyz", 3);
+    ASSERT_STREQ(str, "&lt;b>&lt;b>a");
+    cstring_replace_all(str, "", 0, "xyz", 3);
+    ASSERT_STREQ(str, "&lt;b>&lt;b>a");
+    cstring_replace_all(str, "&lt;b>&lt;b>a", 13, "", 0);
+    ASSERT_EQ(cstring_size(str), 0U);
+    ASSERT_STREQ(str, "");
+
+    /* compare with a loop of cstring_find and cstring_replace */
+    cstring_clear(str);
+    for (i = 0; i < 300; ++i) {
+        cstring_append(str, (i % 7) ? "ab" : "abc", (i % 7) ? 2U : 3U);
+    }
+    cstring_copy(str, ref);
+    cstring_count(str, "abc", 3, 0, cnt);
+    {
+        ptrdiff_t off;
+        cstring_find(ref, 0, "abc", 3, off);
+        while (off != -1) {
+            cstring_replace(ref, (size_t)off, 3, "[abc]", 5);
+            cstring_find(ref, off + 5, "abc", 3, off);
+        }
+    }
+    cstring_replace_all(str, "abc", 3, "[abc]", 5);
+    ASSERT_EQ(cstring_size(str), cstring_size(ref));
+    ASSERT_STREQ(str, ref);
+    ASSERT_EQ(cnt, 43U);
+
+    /* -- wide string -- */
+
+    cstring_assign(wstr, L"x\r\ny\r\n", 6);
+    cstring_replace_all(wstr, L"\r\n", 2, L"\n", 1);
+    ASSERT_TRUE(wcseq(wstr, L"x\ny\n"));
+    cstring_replace_all(wstr, L"\n", 1, L"\r\n", 2);
+    ASSERT_EQ(cstring_size(wstr), 6U);
+    ASSERT_TRUE(wcseq(wstr, L"x\r\ny\r\n"));
+
+    cstring_free(wstr);
+    cstring_free(ref);
+    cstring_free(str);
+}
+
 UTEST(string, cstring_copy) {
     cstring_string_type(char) str   = NULL;
     cstring_string_type(char) other = NULL;
@@ -1007,6 +1176,8 @@ UTEST(string, cstring_find_rfind) {
     ASSERT_EQ(off, 6);
     cstring_rfind(str, 13, "h", 1, off);
     ASSERT_EQ(off, 7);
+    cstring_rfind(str, -1, "h", 1, off);
+    ASSERT_EQ(off, 15);
 
     cstring_free(str);
 
@@ -1036,6 +1207,8 @@ UTEST(string, cstring_find_rfind) {
     ASSERT_EQ(off, 6);
     cstring_rfind(wstr, 13, L"h", 1, off);
     ASSERT_EQ(off, 7);
+    cstring_rfind(wstr, -1, L"h", 1, off);
+    ASSERT_EQ(off, 15);
 
     cstring_free(wstr);
 
@@ -1061,6 +1234,367 @@ UTEST(string, cstring_find_rfind) {
     ASSERT_EQ(off, -1);
 }
 
+static ptrdiff_t naive_find(const char *str, ptrdiff_t siz, const char *sub, ptrdiff_t cnt, int last) {
+    ptrdiff_t off = last ? siz - cnt : 0;
+    for (; off >= 0 && off + cnt <= siz; off += last ? -1 : 1) {
+        if (!strncmp(str + off, sub, (size_t)cnt)) {
+            return off;
+        }
+    }
+    return -1;
+}
+
+UTEST(string, cstring_find_worst_case) {
+    ptrdiff_t off;
+    int found;
+    unsigned hay, sub;
+    cstring_string_type(char) str    = NULL;
+    cstring_string_type(char) needle = NULL;
+
+    /* would degrade to O(n*m) with a plain rolling hash */
+    cstring_resize(str, 100000, 'a');
+    cstring_push_back(str, 'b');
+    cstring_resize(needle, 1000, 'a');
+    cstring_push_back(needle, 'b');
+    cstring_find(str, 0, needle, cstring_size(needle), off);
+    ASSERT_EQ(off, 99000);
+    cstring_rfind(str, -1, needle, cstring_size(needle), off);
+    ASSERT_EQ(off, 99000);
+    needle[1000] = 'c';
+    cstring_contains(str, needle, cstring_size(needle), found);
+    ASSERT_FALSE(found);
+    cstring_rfind(str, -1, needle, cstring_size(needle), off);
+    ASSERT_EQ(off, -1);
+
+    /* all strings of up to 10 characters in a binary alphabet */
+    for (hay = 1; hay < (1U << 11); ++hay) {
+        cstring_clear(str);
+        for (off = 0; (hay >> (off + 1)) != 0; ++off) {
+            cstring_push_back(str, ((hay >> off) & 1) ? 'b' : 'a');
+        }
+        for (sub = 2; sub < (1U << 5); ++sub) {
+            cstring_clear(needle);
+            for (off = 0; (sub >> (off + 1)) != 0; ++off) {
+                cstring_push_back(needle, ((sub >> off) & 1) ? 'b' : 'a');
+            }
+            cstring_find(str, 0, needle, cstring_size(needle), off);
+            ASSERT_EQ(off, naive_find(str, (ptrdiff_t)cstring_size(str), needle, (ptrdiff_t)cstring_size(needle), 0));
+            cstring_rfind(str, -1, needle, cstring_size(needle), off);
+            ASSERT_EQ(off, naive_find(str, (ptrdiff_t)cstring_size(str), needle, (ptrdiff_t)cstring_size(needle), 1));
+        }
+    }
+
+    /* the start position refers to the result variable */
+    cstring_assign(str, "xabxabxab", 9);
+    off = -1;
+    for (sub = 0; sub < 3; ++sub) {
+        cstring_find(str, off + 1, "ab", 2, off);
+        ASSERT_EQ(off, (ptrdiff_t)(3 * sub + 1));
+    }
+    cstring_find(str, off + 1, "ab", 2, off);
+    ASSERT_EQ(off, -1);
+    off = -1;
+    cstring_rfind(str, off, "ab", 2, off);
+    ASSERT_EQ(off, 7);
+    cstring_rfind(str, off - 1, "ab", 2, off);
+    ASSERT_EQ(off, 4);
+
+    cstring_free(needle);
+    cstring_free(str);
+
+    /* -- wide string -- */
+
+    {
+        cstring_string_type(wchar_t) wstr = NULL;
+        cstring_resize(wstr, 500, L'x');
+        cstring_append(wstr, L"xxyxxy", 6);
+        cstring_find(wstr, 0, L"xxyxxy", 6, off);
+        ASSERT_EQ(off, 500);
+        cstring_rfind(wstr, -1, L"xxyxxy", 6, off);
+        ASSERT_EQ(off, 500);
+        cstring_free(wstr);
+    }
+}
+
+UTEST(string, cstring_find_long) {
+    ptrdiff_t off;
+    ptrdiff_t pos;
+    unsigned seed = 12345U;
+    int round;
+    cstring_string_type(char) str    = NULL;
+    cstring_string_type(char) needle = NULL;
+
+    /* long strings in a small alphabet, so that filtered positions often don't match */
+    for (round = 0; round < 200; ++round) {
+        cstring_clear(str);
+        cstring_clear(needle);
+        for (pos = 0; pos < 300; ++pos) {
+            seed = seed * 1103515245U + 12345U;
+            cstring_push_back(str, (char)('a' + ((seed >> 16) % 3U)));
+        }
+        for (pos = 0; pos < 2 + round % 40; ++pos) {
+            seed = seed * 1103515245U + 12345U;
+            cstring_push_back(needle, (char)('a' + ((seed >> 16) % 3U)));
+        }
+        for (pos = 0; pos < 300; pos += 37) {
+            ptrdiff_t expect = naive_find(str + pos, 300 - pos, needle, (ptrdiff_t)cstring_size(needle), 0);
+            cstring_find(str, pos, needle, cstring_size(needle), off);
+            ASSERT_EQ(off, expect == -1 ? -1 : expect + pos);
+        }
+    }
+
+    cstring_resize(str, 4096, '.');
+    cstring_append(str, "token", 5);
+    cstring_find(str, 0, "token", 5, off);
+    ASSERT_EQ(off, 4096);
+    cstring_find(str, 0, "..t", 3, off);
+    ASSERT_EQ(off, 4094);
+
+    cstring_free(needle);
+    cstring_free(str);
+
+    /* -- wide string -- */
+
+    {
+        cstring_string_type(wchar_t) wstr = NULL;
+        cstring_resize(wstr, 1000, L'\x263A');
+        cstring_append(wstr, L"\x263Bkey=\x263A", 6);
+        cstring_find(wstr, 0, L"key=", 4, off);
+        ASSERT_EQ(off, 1001);
+        cstring_find(wstr, 0, L"\x263A\x263B", 2, off);
+        ASSERT_EQ(off, 999);
+        cstring_find(wstr, 0, L"\x263B\x263B", 2, off);
+        ASSERT_EQ(off, -1);
+        cstring_free(wstr);
+    }
+}
+
+UTEST(string, cstring_find_char_long) {
+    ptrdiff_t off;
+    ptrdiff_t len;
+    ptrdiff_t hit;
+    ptrdiff_t pos;
+    cstring_string_type(char) str     = NULL;
+    cstring_string_type(wchar_t) wstr = NULL;
+
+    /* cover the vectorized body and the overlapping tail for every length */
+    for (len = 1; len < 80; ++len) {
+        cstring_clear(str);
+        cstring_resize(str, (size_t)len, '-');
+        cstring_clear(wstr);
+        cstring_resize(wstr, (size_t)len, L'-');
+        for (hit = 0; hit < len; ++hit) {
+            str[hit]  = '+';
+            wstr[hit] = L'+';
+            for (pos = 0; pos < len; pos += 7) {
+                cstring_find(str, pos, "+", 1, off);
+                ASSERT_EQ(off, pos <= hit ? hit : -1);
+                cstring_find_first_not_of(str, pos, "-", 1, off);
+                ASSERT_EQ(off, pos <= hit ? hit : -1);
+                cstring_find_last_of(str, pos, "+", 1, off);
+                ASSERT_EQ(off, pos >= hit ? hit : -1);
+                cstring_find_last_not_of(str, pos, "-", 1, off);
+                ASSERT_EQ(off, pos >= hit ? hit : -1);
+
+                /* -- wide string -- */
+
+                cstring_find(wstr, pos, L"+", 1, off);
+                ASSERT_EQ(off, pos <= hit ? hit : -1);
+                cstring_find_first_not_of(wstr, pos, L"-", 1, off);
+                ASSERT_EQ(off, pos <= hit ? hit : -1);
+                cstring_rfind(wstr, pos, L"+", 1, off);
+                ASSERT_EQ(off, pos >= hit ? hit : -1);
+                cstring_find_last_not_of(wstr, pos, L"-", 1, off);
+                ASSERT_EQ(off, pos >= hit ? hit : -1);
+            }
+            str[hit]  = '-';
+            wstr[hit] = L'-';
+        }
+    }
+
+    cstring_free(wstr);
+    cstring_free(str);
+}
+
+static ptrdiff_t naive_find_of(const wchar_t *str, ptrdiff_t siz, ptrdiff_t pos, const wchar_t *set, ptrdiff_t cnt, int not_of, int last) {
+    ptrdiff_t off = pos;
+    for (; off >= 0 && off < siz; off += last ? -1 : 1) {
+        ptrdiff_t i = 0;
+        while (i < cnt && set[i] != str[off]) {
+            ++i;
+        }
+        if ((i < cnt) != not_of) {
+            return off;
+        }
+    }
+    return -1;
+}
+
+UTEST(string, cstring_find_of_sets) {
+    ptrdiff_t off;
+    ptrdiff_t pos;
+    ptrdiff_t i;
+    unsigned seed = 4711U;
+    int round;
+    cstring_string_type(char) str      = NULL;
+    cstring_string_type(char) set      = NULL;
+    cstring_string_type(wchar_t) wstr  = NULL;
+    cstring_string_type(wchar_t) wset  = NULL;
+    cstring_string_type(wchar_t) wcopy = NULL;
+
+    /* sets with overlapping bit patterns and of all sizes, incl. more than 16 characters */
+    for (round = 0; round < 300; ++round) {
+        const ptrdiff_t len = 1 + round % 97;
+        cstring_clear(str);
+        cstring_clear(set);
+        cstring_clear(wstr);
+        cstring_clear(wset);
+        cstring_clear(wcopy);
+        for (i = 0; i < len; ++i) {
+            seed = seed * 1103515245U + 12345U;
+            cstring_push_back(str, (char)(0x30 + ((seed >> 16) % 40U)));
+            cstring_push_back(wstr, (wchar_t)(0x2F00 + ((seed >> 16) % 600U)));
+            cstring_push_back(wcopy, (wchar_t)(unsigned char)str[i]);
+        }
+        for (i = 0; i < 2 + round % 45; ++i) {
+            seed = seed * 1103515245U + 12345U;
+            cstring_push_back(set, (char)(0x30 + ((seed >> 16) % 40U)));
+            cstring_push_back(wset, (wchar_t)(0x2F00 + ((seed >> 16) % 600U)));
+        }
+        for (pos = 0; pos < len; pos += 1 + len / 5) {
+            wchar_t wcset[64];
+            for (i = 0; i < (ptrdiff_t)cstring_size(set); ++i) {
+                wcset[i] = (wchar_t)(unsigned char)set[i];
+            }
+            cstring_find_first_of(str, pos, set, cstring_size(set), off);
+            ASSERT_EQ(off, naive_find_of(wcopy, len, pos, wcset, (ptrdiff_t)cstring_size(set), 0, 0));
+            cstring_find_first_not_of(str, pos, set, cstring_size(set), off);
+            ASSERT_EQ(off, naive_find_of(wcopy, len, pos, wcset, (ptrdiff_t)cstring_size(set), 1, 0));
+            cstring_find_last_of(str, pos, set, cstring_size(set), off);
+            ASSERT_EQ(off, naive_find_of(wcopy, len, pos, wcset, (ptrdiff_t)cstring_size(set), 0, 1));
+            cstring_find_last_not_of(str, pos, set, cstring_size(set), off);
+            ASSERT_EQ(off, naive_find_of(wcopy, len, pos, wcset, (ptrdiff_t)cstring_size(set), 1, 1));
+
+            /* -- wide string -- */
+
+            cstring_find_first_of(wstr, pos, wset, cstring_size(wset), off);
+            ASSERT_EQ(off, naive_find_of(wstr, len, pos, wset, (ptrdiff_t)cstring_size(wset), 0, 0));
+            cstring_find_first_not_of(wstr, pos, wset, cstring_size(wset), off);
+            ASSERT_EQ(off, naive_find_of(wstr, len, pos, wset, (ptrdiff_t)cstring_size(wset), 1, 0));
+            cstring_find_last_of(wstr, pos, wset, cstring_size(wset), off);
+            ASSERT_EQ(off, naive_find_of(wstr, len, pos, wset, (ptrdiff_t)cstring_size(wset), 0, 1));
+            cstring_find_last_not_of(wstr, pos, wset, cstring_size(wset), off);
+            ASSERT_EQ(off, naive_find_of(wstr, len, pos, wset, (ptrdiff_t)cstring_size(wset), 1, 1));
+        }
+    }
+
+    cstring_free(wcopy);
+    cstring_free(wset);
+    cstring_free(wstr);
+    cstring_free(set);
+    cstring_free(str);
+}
+
+UTEST(string, cstring_find_all_count) {
+    size_t cnt;
+    ptrdiff_t *offs               = NULL;
+    cstring_string_type(char) str = NULL;
+    cstring_view_type(char) view;
+    cstring_searcher_type(char) srch;
+    cstring_string_type(wchar_t) wstr = NULL;
+
+    cstring_assign(str, "aaaabaa", 7);
+    cstring_find_all(str, "aa", 2, 0, offs);
+    ASSERT_EQ(cstring_size(offs), 3U);
+    ASSERT_EQ(offs[0], 0);
+    ASSERT_EQ(offs[1], 2);
+    ASSERT_EQ(offs[2], 5);
+    cstring_find_all(str, "aa", 2, 1, offs);
+    ASSERT_EQ(cstring_size(offs), 4U);
+    ASSERT_EQ(offs[0], 0);
+    ASSERT_EQ(offs[1], 1);
+    ASSERT_EQ(offs[2], 2);
+    ASSERT_EQ(offs[3], 5);
+    cstring_count(str, "aa", 2, 0, cnt);
+    ASSERT_EQ(cnt, 3U);
+    cstring_count(str, "aa", 2, 1, cnt);
+    ASSERT_EQ(cnt, 4U);
+    cstring_count(str, "a", 1, 0, cnt);
+    ASSERT_EQ(cnt, 6U);
+    cstring_find_all(str, "x", 1, 0, offs);
+    ASSERT_EQ(cstring_size(offs), 0U);
+    cstring_count(str, "", 0, 1, cnt);
+    ASSERT_EQ(cnt, 0U);
+
+    cstring_view_substring(str, 1, 5, view);
+    cstring_view_find_all(view, "aa", 2, 1, offs);
+    ASSERT_EQ(cstring_size(offs), 2U);
+    ASSERT_EQ(offs[0], 0);
+    ASSERT_EQ(offs[1], 1);
+    cstring_view_count(view, "ab", 2, 0, cnt);
+    ASSERT_EQ(cnt, 1U);
+
+    cstring_searcher_init(srch, "aa", 2);
+    cstring_searcher_find_all(srch, str, 1, offs);
+    ASSERT_EQ(cstring_size(offs), 4U);
+    cstring_view_searcher_find_all(srch, view, 0, offs);
+    ASSERT_EQ(cstring_size(offs), 1U);
+
+    /* long haystack, counts agree with the found positions */
+    cstring_clear(str);
+    cstring_resize(str, 1000, 'a');
+    cstring_find_all(str, "aaa", 3, 0, offs);
+    cstring_count(str, "aaa", 3, 0, cnt);
+    ASSERT_EQ(cstring_size(offs), cnt);
+    ASSERT_EQ(cnt, 333U);
+    ASSERT_EQ(offs[cnt - 1], 996);
+    cstring_count(str, "aaa", 3, 1, cnt);
+    ASSERT_EQ(cnt, 998U);
+    cstring_find_all(str, "aaaaaaaa", 8, 1, offs);
+    ASSERT_EQ(cstring_size(offs), 993U);
+    ASSERT_EQ(offs[992], 992);
+
+    /* overlapping hits of periodic and aperiodic needles agree with a naive scan */
+    {
+        static const char *const needles[] = {"abab", "aba", "ababa", "abaab", "aabaa", "abababab"};
+        size_t k, i;
+        cstring_clear(str);
+        for (i = 0; i < 300; ++i) {
+            cstring_push_back(str, (i % 37 == 36 || i % 53 == 52) ? 'a' : "ab"[i % 2]);
+        }
+        for (k = 0; k < sizeof(needles) / sizeof(needles[0]); ++k) {
+            const size_t n = strlen(needles[k]);
+            size_t naive   = 0;
+            cstring_find_all(str, needles[k], n, 1, offs);
+            cstring_count(str, needles[k], n, 1, cnt);
+            ASSERT_EQ(cstring_size(offs), cnt);
+            for (i = 0; i + n <= cstring_size(str); ++i) {
+                if (memcmp(str + i, needles[k], n) == 0) {
+                    ASSERT_LT(naive, cnt);
+                    ASSERT_EQ(offs[naive], (ptrdiff_t)i);
+                    ++naive;
+                }
+            }
+            ASSERT_EQ(naive, cnt);
+        }
+    }
+
+    /* -- wide string -- */
+
+    cstring_assign(wstr, L"xyzxyxyz", 8);
+    cstring_find_all(wstr, L"xy", 2, 0, offs);
+    ASSERT_EQ(cstring_size(offs), 3U);
+    ASSERT_EQ(offs[0], 0);
+    ASSERT_EQ(offs[1], 3);
+    ASSERT_EQ(offs[2], 5);
+    cstring_count(wstr, L"xyz", 3, 1, cnt);
+    ASSERT_EQ(cnt, 2U);
+
+    cstring_free(offs);
+    cstring_free(wstr);
+    cstring_free(str);
+}
+
 UTEST(string, cstring_find_first_of) {
     ptrdiff_t off;
     cstring_string_type(char) str = NULL;
@@ -1162,6 +1696,8 @@ UTEST(string, cstring_find_last_of) {
     ASSERT_EQ(off, 7);
     cstring_find_last_of(str, 13, "h", 1, off);
     ASSERT_EQ(off, 7);
+    cstring_find_last_of(str, -1, "h", 1, off);
+    ASSERT_EQ(off, 15);
     cstring_find_last_of(str, -1, "xh", 2, off);
     ASSERT_EQ(off, 15);
     cstring_find_last_of(str, -1, "xy", 2, off);
@@ -1184,6 +1720,8 @@ UTEST(string, cstring_find_last_of) {
     ASSERT_EQ(off, 7);
     cstring_find_last_of(wstr, 13, L"h", 1, off);
     ASSERT_EQ(off, 7);
+    cstring_find_last_of(wstr, -1, L"h", 1, off);
+    ASSERT_EQ(off, 15);
     cstring_find_last_of(wstr, -1, L"xh", 2, off);
     ASSERT_EQ(off, 15);
     cstring_find_last_of(wstr, -1, L"xy", 2, off);
@@ -1209,6 +1747,8 @@ UTEST(string, cstring_find_last_not_of) {
     ASSERT_EQ(off, 12);
     cstring_find_last_not_of(str, 12, "h", 1, off);
     ASSERT_EQ(off, 12);
+    cstring_find_last_not_of(str, -1, "h", 1, off);
+    ASSERT_EQ(off, 14);
     cstring_find_last_not_of(str, -1, "abcdefgh", 8, off);
     ASSERT_EQ(off, -1);
 
@@ -1231,6 +1771,8 @@ UTEST(string, cstring_find_last_not_of) {
     ASSERT_EQ(off, 12);
     cstring_find_last_not_of(wstr, 12, L"h", 1, off);
     ASSERT_EQ(off, 12);
+    cstring_find_last_not_of(wstr, -1, L"h", 1, off);
+    ASSERT_EQ(off, 14);
     cstring_find_last_not_of(wstr, -1, L"abcdefgh", 8, off);
     ASSERT_EQ(off, -1);
 
@@ -1307,6 +1849,83 @@ UTEST(string, cstring_compare) {
     ASSERT_EQ(res, 999);
 }
 
+UTEST(string, cstring_equal_mismatch) {
+    ptrdiff_t off = 0;
+    ptrdiff_t i;
+    int eq = 0;
+    int order;
+    cstring_string_type(char) str1 = NULL;
+    cstring_string_type(char) str2 = NULL;
+    cstring_view_type(char) view1;
+    cstring_view_type(char) view2;
+
+    cstring_assign(str1, "abcdef", 6);
+    cstring_assign(str2, "abcxef", 6);
+    cstring_equal(str1, str2, eq);
+    ASSERT_FALSE(eq);
+    cstring_mismatch(str1, str2, off);
+    ASSERT_EQ(off, 3);
+    cstring_assign(str2, "abc", 3);
+    cstring_equal(str1, str2, eq);
+    ASSERT_FALSE(eq);
+    cstring_mismatch(str1, str2, off);
+    ASSERT_EQ(off, 3);
+    cstring_assign(str2, "abcdef", 6);
+    cstring_equal(str1, str2, eq);
+    ASSERT_TRUE(eq);
+    cstring_mismatch(str1, str2, off);
+    ASSERT_EQ(off, -1);
+
+    /* long strings, differing at every position */
+    cstring_resize(str1, 200, 'z');
+    cstring_assign(str2, str1, cstring_size(str1));
+    for (i = 0; i < 200; ++i) {
+        str2[i] = '\xF0';
+        cstring_mismatch(str1, str2, off);
+        ASSERT_EQ(off, i);
+        cstring_compare(str1, str2, order);
+        ASSERT_EQ(order, -1);
+        cstring_equal(str1, str2, eq);
+        ASSERT_FALSE(eq);
+        str2[i] = str1[i];
+    }
+
+    cstring_view_literal(view1, "prefix-a");
+    cstring_view_literal(view2, "prefix-b");
+    cstring_view_mismatch(view1, view2, off);
+    ASSERT_EQ(off, 7);
+    cstring_view_equal(view1, view2, eq);
+    ASSERT_FALSE(eq);
+    cstring_view_subview(view1, 0, 6, view1);
+    cstring_view_subview(view2, 0, 6, view2);
+    cstring_view_equal(view1, view2, eq);
+    ASSERT_TRUE(eq);
+
+    cstring_free(str1);
+    cstring_free(str2);
+
+    /* -- wide string -- */
+
+    {
+        cstring_string_type(wchar_t) wstr1 = NULL;
+        cstring_string_type(wchar_t) wstr2 = NULL;
+        cstring_resize(wstr1, 100, L'\x1234');
+        cstring_assign(wstr2, wstr1, cstring_size(wstr1));
+        wstr2[57] = L'\x1235';
+        cstring_mismatch(wstr1, wstr2, off);
+        ASSERT_EQ(off, 57);
+        cstring_compare(wstr1, wstr2, order);
+        ASSERT_EQ(order, -1);
+        wstr2[57] = L'\x0135';
+        cstring_compare(wstr1, wstr2, order);
+        ASSERT_EQ(order, 1);
+        cstring_equal(wstr1, wstr2, eq);
+        ASSERT_FALSE(eq);
+        cstring_free(wstr1);
+        cstring_free(wstr2);
+    }
+}
+
 UTEST(string, cstring_starts_ends_with) {
     int res;
     cstring_string_type(char) str = NULL;
@@ -1889,4 +2508,1518 @@ UTEST(array, cstring_array_join) {
     cstring_free(str);
 }
 
+UTEST(array, cstring_split_into) {
+    cstring_string_type(char) str = NULL;
+    cstring_array_type(char) arr  = NULL;
+    cstring_string_type(char) first;
+    cstring_string_type(char) second;
+
+    cstring_assign(str, "alpha,beta,gamma", 16);
+    cstring_split_into(str, -1, ",", 1, arr);
+    ASSERT_EQ(cstring_array_size(arr), 3U);
+    ASSERT_STREQ(arr[0], "alpha");
+    ASSERT_STREQ(arr[2], "gamma");
+    ASSERT_TRUE(arr[3] == NULL);
+    first  = arr[0];
+    second = arr[1];
+
+    /* strings are overwritten in place */
+    cstring_assign(str, "one,two,three,four", 18);
+    cstring_split_into(str, -1, ",", 1, arr);
+    ASSERT_EQ(cstring_array_size(arr), 4U);
+    ASSERT_TRUE(arr[0] == first);
+    ASSERT_TRUE(arr[1] == second);
+    ASSERT_STREQ(arr[0], "one");
+    ASSERT_STREQ(arr[1], "two");
+    ASSERT_STREQ(arr[2], "three");
+    ASSERT_STREQ(arr[3], "four");
+    ASSERT_EQ(cstring_size(arr[0]), 3U);
+
+    /* surplus strings are released, the vector stays owned by the C library */
+    cstring_assign(str, "x::y", 4);
+    cstring_split_into(str, -1, "::", 2, arr);
+    ASSERT_EQ(cstring_array_size(arr), 2U);
+    ASSERT_TRUE(arr[0] == first);
+    ASSERT_STREQ(arr[0], "x");
+    ASSERT_STREQ(arr[1], "y");
+    ASSERT_TRUE(arr[2] == NULL);
+    ASSERT_TRUE(cstring_get_allocator(arr) == NULL);
+    ASSERT_GE(cstring_array_capacity(arr), 4U);
+
+    /* the same number of tokens reuses all strings */
+    cstring_assign(str, "1::2", 4);
+    cstring_split_into(str, -1, "::", 2, arr);
+    ASSERT_EQ(cstring_array_size(arr), 2U);
+    ASSERT_TRUE(arr[0] == first);
+    ASSERT_TRUE(arr[1] == second);
+    ASSERT_STREQ(arr[1], "2");
+
+    cstring_split_into(str, 0, "::", 2, arr);
+    ASSERT_EQ(cstring_array_size(arr), 0U);
+    ASSERT_TRUE(arr[0] == NULL);
+
+    /* other modifiers work on the result */
+    cstring_array_push_back(arr, "abc", 3);
+    ASSERT_EQ(cstring_array_size(arr), 1U);
+    ASSERT_STREQ(arr[0], "abc");
+    cstring_assign(str, "a,b,c,d,e", 9);
+    cstring_split_into(str, -1, ",", 1, arr);
+    ASSERT_EQ(cstring_array_size(arr), 5U);
+    ASSERT_STREQ(arr[0], "a");
+    ASSERT_STREQ(arr[4], "e");
+    ASSERT_TRUE(arr[5] == NULL);
+    cstring_split_into(str, 2, ",", 1, arr);
+    ASSERT_EQ(cstring_array_size(arr), 2U);
+    cstring_array_shrink_to_fit(arr);
+    ASSERT_EQ(cstring_array_capacity(arr), 2U);
+    ASSERT_STREQ(arr[1], "b,c,d,e");
+    cstring_array_push_back(arr, "x", 1);
+    ASSERT_EQ(cstring_array_size(arr), 3U);
+    ASSERT_STREQ(arr[2], "x");
+
+    cstring_array_free(arr);
+    cstring_free(str);
+
+    /* -- wide string -- */
+
+    {
+        cstring_string_type(wchar_t) wstr = NULL;
+        cstring_array_type(wchar_t) warr  = NULL;
+        cstring_assign(wstr, L"a b c", 5);
+        cstring_split_into(wstr, 2, L" ", 1, warr);
+        ASSERT_EQ(cstring_array_size(warr), 2U);
+        ASSERT_TRUE(wcseq(warr[0], L"a"));
+        ASSERT_TRUE(wcseq(warr[1], L"b c"));
+        cstring_array_free(warr);
+        cstring_free(wstr);
+    }
+}
+
+UTEST(array, cstring_split_packed) {
+    size_t i;
+    cstring_string_type(char) str     = NULL;
+    cstring_string_type(char) tmp     = NULL;
+    cstring_string_type(wchar_t) wstr = NULL;
+    cstring_array_type(char) arr      = NULL;
+    cstring_array_type(wchar_t) warr  = NULL;
+
+    cstring_assign(str, "a;bb;;ccc", 9);
+    cstring_split_packed(str, -1, ";", 1, arr);
+    ASSERT_EQ(cstring_array_size(arr), 4U);
+    ASSERT_STREQ(arr[0], "a");
+    ASSERT_STREQ(arr[1], "bb");
+    ASSERT_EQ(cstring_size(arr[2]), 0U);
+    ASSERT_STREQ(arr[2], "");
+    ASSERT_EQ(cstring_size(arr[3]), 3U);
+    ASSERT_STREQ(arr[3], "ccc");
+    ASSERT_TRUE(arr[4] == NULL);
+    /* the strings follow the vector in the same block */
+    for (i = 0; i < 4; ++i) {
+        ASSERT_TRUE((void *)arr[i] > (void *)(arr + 4));
+        ASSERT_TRUE(i == 0 || arr[i] > arr[i - 1]);
+    }
+
+    cstring_split_packed(str, 2, ";", 1, arr);
+    ASSERT_EQ(cstring_array_size(arr), 2U);
+    ASSERT_STREQ(arr[0], "a");
+    ASSERT_STREQ(arr[1], "bb;;ccc");
+
+    cstring_split_packed(str, -1, "--", 2, arr);
+    ASSERT_EQ(cstring_array_size(arr), 1U);
+    ASSERT_STREQ(arr[0], "a;bb;;ccc");
+
+    /* delimiters of more than one character */
+    cstring_assign(tmp, "a::bb::::ccc::", 14);
+    cstring_split_packed(tmp, -1, "::", 2, arr);
+    ASSERT_EQ(cstring_array_size(arr), 5U);
+    ASSERT_STREQ(arr[0], "a");
+    ASSERT_STREQ(arr[1], "bb");
+    ASSERT_STREQ(arr[2], "");
+    ASSERT_STREQ(arr[3], "ccc");
+    ASSERT_STREQ(arr[4], "");
+    cstring_split_packed(tmp, 3, "::", 2, arr);
+    ASSERT_EQ(cstring_array_size(arr), 3U);
+    ASSERT_STREQ(arr[2], "::ccc::");
+    cstring_free(tmp);
+
+    /* modify the strings and grow the vector */
+    cstring_split_packed(str, -1, ";", 1, arr);
+    cstring_append(arr[0], "123456789", 9);
+    ASSERT_STREQ(arr[0], "a123456789");
+    cstring_erase(arr[3], 0, 1);
+    ASSERT_STREQ(arr[3], "cc");
+    cstring_array_push_back(arr, "last", 4);
+    ASSERT_EQ(cstring_array_size(arr), 5U);
+    ASSERT_GE(cstring_array_capacity(arr), 5U);
+    ASSERT_STREQ(arr[0], "a123456789");
+    ASSERT_STREQ(arr[1], "bb");
+    ASSERT_STREQ(arr[3], "cc");
+    ASSERT_STREQ(arr[4], "last");
+    cstring_array_free(arr);
+
+    cstring_split_packed(str, 0, ";", 1, arr);
+    ASSERT_TRUE(arr == NULL);
+
+    /* -- wide string -- */
+
+    cstring_assign(wstr, L"x<>yy<>zzz", 10);
+    cstring_split_packed(wstr, -1, L"<>", 2, warr);
+    ASSERT_EQ(cstring_array_size(warr), 3U);
+    ASSERT_TRUE(wcseq(warr[1], L"yy"));
+
+    cstring_assign(wstr, L"x,yy,zzz", 8);
+    cstring_split_packed(wstr, -1, L",", 1, warr);
+    ASSERT_EQ(cstring_array_size(warr), 3U);
+    ASSERT_TRUE(wcseq(warr[0], L"x"));
+    ASSERT_TRUE(wcseq(warr[1], L"yy"));
+    ASSERT_TRUE(wcseq(warr[2], L"zzz"));
+    cstring_array_erase(warr, 0, 1);
+    cstring_array_push_back(warr, L"w", 1);
+    ASSERT_EQ(cstring_array_size(warr), 3U);
+    ASSERT_TRUE(wcseq(warr[2], L"w"));
+    cstring_array_free(warr);
+
+    cstring_free(wstr);
+    cstring_free(str);
+}
+
+UTEST(array, cstring_split_inplace) {
+    cstring_string_type(char) str     = NULL;
+    cstring_argv_type(char) argv      = NULL;
+    cstring_argv_type(char) prev_argv = NULL;
+
+    cstring_assign(str, "ls  -l  /tmp", 12);
+    cstring_split_inplace(str, -1, "  ", 2, argv);
+    ASSERT_EQ(cstring_argv_size(argv), 3U);
+    ASSERT_STREQ(argv[0], "ls");
+    ASSERT_STREQ(argv[1], "-l");
+    ASSERT_STREQ(argv[2], "/tmp");
+    ASSERT_TRUE(argv[3] == NULL);
+    ASSERT_TRUE(argv[0] == str);
+    ASSERT_TRUE(argv[2] == str + 8);
+    ASSERT_EQ(cstring_size(str), 12U);
+    ASSERT_EQ(str[3], 0);
+
+    /* capacity of the vector is reused */
+    prev_argv = argv;
+    cstring_assign(str, "a,b,,c", 6);
+    cstring_split_inplace(str, 3, ",", 1, argv);
+    ASSERT_TRUE(argv == prev_argv);
+    ASSERT_EQ(cstring_argv_size(argv), 3U);
+    ASSERT_STREQ(argv[0], "a");
+    ASSERT_STREQ(argv[1], "b");
+    ASSERT_STREQ(argv[2], ",c");
+    ASSERT_TRUE(argv[3] == NULL);
+
+    cstring_split_inplace(str, 0, ",", 1, argv);
+    ASSERT_EQ(cstring_argv_size(argv), 0U);
+    ASSERT_TRUE(argv[0] == NULL);
+
+    cstring_argv_free(argv);
+    ASSERT_TRUE(argv == NULL);
+    cstring_free(str);
+
+    /* -- wide string -- */
+
+    {
+        cstring_string_type(wchar_t) wstr = NULL;
+        cstring_argv_type(wchar_t) wargv  = NULL;
+        cstring_assign(wstr, L"x=1;y=2", 7);
+        cstring_split_inplace(wstr, -1, L";", 1, wargv);
+        ASSERT_EQ(cstring_argv_size(wargv), 2U);
+        ASSERT_EQ(0, wcscmp(wargv[0], L"x=1"));
+        ASSERT_EQ(0, wcscmp(wargv[1], L"y=2"));
+        ASSERT_TRUE(wargv[2] == NULL);
+        cstring_argv_free(wargv);
+        cstring_free(wstr);
+    }
+}
+
+UTEST(array, cstring_array_pack) {
+    cstring_string_type(char) str = NULL;
+    cstring_array_type(char) arr  = NULL;
+
+    cstring_array_pack(arr);
+    ASSERT_TRUE(arr == NULL);
+
+    cstring_assign(str, "aa;bb;cc;dd", 11);
+    cstring_split(str, -1, ";", 1, arr);
+    cstring_array_pack(arr);
+    ASSERT_EQ(cstring_array_size(arr), 4U);
+    ASSERT_STREQ(arr[0], "aa");
+    ASSERT_STREQ(arr[3], "dd");
+    ASSERT_TRUE(arr[1] > arr[0] && arr[2] > arr[1] && arr[3] > arr[2]);
+
+    cstring_array_join(arr, ",", 1, str);
+    ASSERT_STREQ(str, "aa,bb,cc,dd");
+
+    cstring_array_erase(arr, 1, 2);
+    ASSERT_EQ(cstring_array_size(arr), 2U);
+    ASSERT_STREQ(arr[1], "dd");
+    cstring_array_insert(arr, 1, "xx", 2);
+    ASSERT_EQ(cstring_array_size(arr), 3U);
+    ASSERT_STREQ(arr[1], "xx");
+
+    /* packing a packed vector */
+    cstring_array_pack(arr);
+    ASSERT_EQ(cstring_array_size(arr), 3U);
+    ASSERT_STREQ(arr[0], "aa");
+    ASSERT_STREQ(arr[1], "xx");
+    ASSERT_STREQ(arr[2], "dd");
+
+    cstring_array_clear(arr);
+    ASSERT_TRUE(cstring_array_empty(arr));
+
+    cstring_array_free(arr);
+    cstring_free(str);
+}
+
+UTEST(view, cstring_view) {
+    ptrdiff_t off;
+    int found, order;
+    static const char buffer[] = {'x', 'y', 'z', 'x', 'y'};
+    cstring_string_type(char) str = NULL;
+    cstring_string_type(char) cpy = NULL;
+    cstring_array_type(char) arr  = NULL;
+    cstring_view_type(char) view;
+    cstring_view_type(char) field;
+    cstring_view_type(char) lit;
+
+    cstring_assign(str, "key=value;other=1", 17);
+    cstring_view_from(view, str);
+    ASSERT_EQ(cstring_view_size(view), 17U);
+    ASSERT_TRUE(cstring_view_data(view) == str);
+
+    /* zero-copy field extraction */
+    cstring_view_find(view, 0, ";", 1, off);
+    ASSERT_EQ(off, 9);
+    cstring_view_subview(view, 0, (size_t)off, field);
+    ASSERT_EQ(cstring_view_size(field), 9U);
+    ASSERT_TRUE(cstring_view_data(field) == str);
+    cstring_view_find(field, 0, "=", 1, off);
+    ASSERT_EQ(off, 3);
+    cstring_view_find(field, 0, "other", 5, off);
+    ASSERT_EQ(off, -1);
+    cstring_view_rfind(field, -1, "e", 1, off);
+    ASSERT_EQ(off, 8);
+    cstring_view_rfind(field, -1, "val", 3, off);
+    ASSERT_EQ(off, 4);
+    cstring_view_find_first_of(field, 0, "=;", 2, off);
+    ASSERT_EQ(off, 3);
+    cstring_view_find_first_not_of(field, 0, "key", 3, off);
+    ASSERT_EQ(off, 3);
+    cstring_view_find_last_of(field, -1, ";1", 2, off);
+    ASSERT_EQ(off, -1);
+    cstring_view_find_last_not_of(field, -1, "lue", 3, off);
+    ASSERT_EQ(off, 5);
+    cstring_view_starts_with(field, "key", 3, found);
+    ASSERT_EQ(found, 1);
+    cstring_view_ends_with(field, "value", 5, found);
+    ASSERT_EQ(found, 1);
+    cstring_view_ends_with(field, "value;", 6, found);
+    ASSERT_EQ(found, 0);
+    cstring_view_contains(field, "y=v", 3, found);
+    ASSERT_EQ(found, 1);
+    cstring_view_contains(field, "other", 5, found);
+    ASSERT_EQ(found, 0);
+
+    /* compare views of different origin */
+    cstring_view_literal(lit, "key=value");
+    ASSERT_EQ(cstring_view_size(lit), 9U);
+    cstring_view_compare(field, lit, order);
+    ASSERT_EQ(order, 0);
+    cstring_view_subview(lit, 0, 3, lit);
+    cstring_view_compare(field, lit, order);
+    ASSERT_EQ(order, 1);
+    cstring_view_compare(lit, field, order);
+    ASSERT_EQ(order, -1);
+
+    /* raw buffer without terminator */
+    cstring_view_assign(view, buffer, sizeof(buffer));
+    cstring_view_rfind(view, -1, "xy", 2, off);
+    ASSERT_EQ(off, 3);
+    cstring_view_find(view, 1, "xy", 2, off);
+    ASSERT_EQ(off, 3);
+    cstring_view_find(view, 0, "yz", 2, off);
+    ASSERT_EQ(off, 1);
+    cstring_view_find(view, 0, "yx", 2, off);
+    ASSERT_EQ(off, -1);
+    cstring_view_split(view, -1, "x", 1, arr);
+    ASSERT_EQ(cstring_array_size(arr), 3U);
+    ASSERT_STREQ(arr[0], "");
+    ASSERT_STREQ(arr[1], "yz");
+    ASSERT_STREQ(arr[2], "y");
+
+    /* conversion on demand */
+    cstring_view_substring(str, 10, 100, view);
+    ASSERT_EQ(cstring_view_size(view), 7U);
+    cstring_view_to_cstring(view, cpy);
+    ASSERT_STREQ(cpy, "other=1");
+    cstring_view_substring(str, 100, 1, view);
+    ASSERT_TRUE(cstring_view_empty(view));
+    cstring_view_to_cstring(view, cpy);
+    ASSERT_STREQ(cpy, "");
+
+    cstring_array_free(arr);
+    cstring_free(cpy);
+    cstring_free(str);
+
+    /* -- wide string -- */
+
+    {
+        cstring_view_type(wchar_t) wview;
+        cstring_array_type(wchar_t) warr = NULL;
+        cstring_view_literal(wview, L"a,bb,ccc");
+        ASSERT_EQ(cstring_view_size(wview), 8U);
+        cstring_view_find(wview, 0, L"bb", 2, off);
+        ASSERT_EQ(off, 2);
+        cstring_view_find_last_of(wview, -1, L",", 1, off);
+        ASSERT_EQ(off, 4);
+        cstring_view_split(wview, -1, L",", 1, warr);
+        ASSERT_EQ(cstring_array_size(warr), 3U);
+        ASSERT_TRUE(wcseq(warr[2], L"ccc"));
+        cstring_array_free(warr);
+    }
+}
+
+UTEST(view, cstring_tokenizer) {
+    ptrdiff_t off;
+    size_t cnt;
+    cstring_string_type(char) str = NULL;
+    cstring_tokenizer_type(char) tok;
+    cstring_view_type(char) field;
+
+    cstring_assign(str, "a;bb;;ccc", 9);
+    cstring_tokenizer_init(tok, str, -1, ";", 1);
+    cstring_tokenizer_next(tok, off, cnt);
+    ASSERT_EQ(off, 0);
+    ASSERT_EQ(cnt, 1U);
+    cstring_tokenizer_next(tok, off, cnt);
+    ASSERT_EQ(off, 2);
+    ASSERT_EQ(cnt, 2U);
+    cstring_tokenizer_next(tok, off, cnt);
+    ASSERT_EQ(off, 5);
+    ASSERT_EQ(cnt, 0U);
+    cstring_tokenizer_next(tok, off, cnt);
+    ASSERT_EQ(off, 6);
+    ASSERT_EQ(cnt, 3U);
+    cstring_tokenizer_next(tok, off, cnt);
+    ASSERT_EQ(off, -1);
+    cstring_tokenizer_next(tok, off, cnt);
+    ASSERT_EQ(off, -1);
+
+    /* stop after two fields */
+    cstring_assign(str, "2024-01-01 | INFO | started | pid=42", 36);
+    cstring_tokenizer_init(tok, str, -1, " | ", 3);
+    cstring_tokenizer_next_view(tok, field);
+    ASSERT_EQ(cstring_view_size(field), 10U);
+    ASSERT_EQ(0, strncmp(cstring_view_data(field), "2024-01-01", 10));
+    cstring_tokenizer_next_view(tok, field);
+    ASSERT_EQ(cstring_view_size(field), 4U);
+    ASSERT_EQ(0, strncmp(cstring_view_data(field), "INFO", 4));
+
+    /* max_tok */
+    cstring_tokenizer_init(tok, str, 2, " | ", 3);
+    cstring_tokenizer_next_view(tok, field);
+    cstring_tokenizer_next_view(tok, field);
+    ASSERT_EQ(cstring_view_size(field), 23U);
+    ASSERT_EQ(0, strncmp(cstring_view_data(field), "INFO | started | pid=42", 23));
+    cstring_tokenizer_next_view(tok, field);
+    ASSERT_TRUE(cstring_view_data(field) == NULL);
+
+    cstring_tokenizer_init(tok, str, 0, ";", 1);
+    cstring_tokenizer_next(tok, off, cnt);
+    ASSERT_EQ(off, -1);
+
+    /* trailing delimiter */
+    cstring_assign(str, "x;", 2);
+    cstring_tokenizer_init(tok, str, -1, ";", 1);
+    cstring_tokenizer_next(tok, off, cnt);
+    ASSERT_EQ(off, 0);
+    cstring_tokenizer_next(tok, off, cnt);
+    ASSERT_EQ(off, 2);
+    ASSERT_EQ(cnt, 0U);
+    cstring_tokenizer_next(tok, off, cnt);
+    ASSERT_EQ(off, -1);
+
+    cstring_free(str);
+
+    /* -- wide string -- */
+
+    {
+        cstring_view_type(wchar_t) wview;
+        cstring_view_type(wchar_t) wfield;
+        cstring_tokenizer_type(wchar_t) wtok;
+        cstring_view_literal(wview, L"k1=v1&k2=v2");
+        cstring_view_tokenizer_init(wtok, wview, -1, L"&", 1);
+        cstring_tokenizer_next_view(wtok, wfield);
+        ASSERT_EQ(cstring_view_size(wfield), 5U);
+        cstring_tokenizer_next_view(wtok, wfield);
+        ASSERT_EQ(cstring_view_size(wfield), 5U);
+        ASSERT_TRUE(wfield.data[4] == L'2');
+        cstring_tokenizer_next_view(wtok, wfield);
+        ASSERT_TRUE(cstring_view_data(wfield) == NULL);
+    }
+}
+
+UTEST(view, cstring_searcher) {
+    ptrdiff_t off;
+    size_t cnt;
+    cstring_string_type(char) str = NULL;
+    cstring_array_type(char) arr  = NULL;
+    cstring_view_type(char) view;
+    cstring_searcher_type(char) srch;
+
+    cstring_searcher_init(srch, "ab", 2);
+    cstring_assign(str, "xxabyyabzzab", 12);
+    cstring_searcher_find(srch, str, 0, off);
+    ASSERT_EQ(off, 2);
+    cstring_searcher_find(srch, str, 3, off);
+    ASSERT_EQ(off, 6);
+    cstring_searcher_rfind(srch, str, -1, off);
+    ASSERT_EQ(off, 10);
+    cstring_searcher_rfind(srch, str, 9, off);
+    ASSERT_EQ(off, 6);
+    cstring_searcher_count(srch, str, cnt);
+    ASSERT_EQ(cnt, 3U);
+    off = 2;
+    cstring_searcher_find(srch, str, off + 1, off);
+    ASSERT_EQ(off, 6);
+    cstring_searcher_find(srch, str, off + 1, off);
+    ASSERT_EQ(off, 10);
+    cstring_searcher_split(srch, str, -1, arr);
+    ASSERT_EQ(cstring_array_size(arr), 4U);
+    ASSERT_STREQ(arr[0], "xx");
+    ASSERT_STREQ(arr[1], "yy");
+    ASSERT_STREQ(arr[2], "zz");
+    ASSERT_STREQ(arr[3], "");
+
+    cstring_view_substring(str, 4, 6, view);
+    cstring_view_searcher_find(srch, view, 0, off);
+    ASSERT_EQ(off, 2);
+    cstring_view_searcher_rfind(srch, view, -1, off);
+    ASSERT_EQ(off, 2);
+    cstring_view_searcher_count(srch, view, cnt);
+    ASSERT_EQ(cnt, 1U);
+    cstring_view_searcher_split(srch, view, -1, arr);
+    ASSERT_EQ(cstring_array_size(arr), 2U);
+    ASSERT_STREQ(arr[0], "yy");
+    ASSERT_STREQ(arr[1], "zz");
+
+    /* non-overlapping */
+    cstring_searcher_init(srch, "aa", 2);
+    cstring_assign(str, "aaaaa", 5);
+    cstring_searcher_count(srch, str, cnt);
+    ASSERT_EQ(cnt, 2U);
+
+    cstring_searcher_init(srch, "", 0);
+    cstring_searcher_find(srch, str, 0, off);
+    ASSERT_EQ(off, -1);
+    cstring_searcher_count(srch, str, cnt);
+    ASSERT_EQ(cnt, 0U);
+
+    cstring_array_free(arr);
+    cstring_free(str);
+
+    /* -- wide string -- */
+
+    {
+        cstring_string_type(wchar_t) wstr = NULL;
+        cstring_searcher_type(wchar_t) wsrch;
+        cstring_searcher_init(wsrch, L"\r\n", 2);
+        cstring_assign(wstr, L"a\r\nb\r\nc", 7);
+        cstring_searcher_find(wsrch, wstr, 0, off);
+        ASSERT_EQ(off, 1);
+        cstring_searcher_rfind(wsrch, wstr, -1, off);
+        ASSERT_EQ(off, 4);
+        cstring_searcher_count(wsrch, wstr, cnt);
+        ASSERT_EQ(cnt, 2U);
+        cstring_free(wstr);
+    }
+}
+
+UTEST(matcher, cstring_matcher) {
+    ptrdiff_t off;
+    size_t id;
+    ptrdiff_t *offs = NULL;
+    size_t *ids     = NULL;
+    cstring_string_type(char) str = NULL;
+    cstring_array_type(char) pats = NULL;
+    cstring_view_type(char) view;
+    cstring_matcher_type matcher = NULL;
+    cstring_string_type(wchar_t) wstr = NULL;
+    cstring_array_type(wchar_t) wpats = NULL;
+    cstring_view_type(wchar_t) wview;
+    cstring_matcher_type wmatcher = NULL;
+
+    cstring_array_push_back(pats, "he", 2);
+    cstring_array_push_back(pats, "she", 3);
+    cstring_array_push_back(pats, "his", 3);
+    cstring_array_push_back(pats, "hers", 4);
+    cstring_array_push_back(pats, "", 0);
+    cstring_matcher_build(pats, matcher);
+    cstring_assign(str, "ushers and his", 14);
+
+    cstring_matcher_find_first(matcher, str, off, id);
+    ASSERT_EQ(off, 1);
+    ASSERT_EQ(id, 1U);
+    cstring_matcher_find_all(matcher, str, offs, ids);
+    ASSERT_EQ(cstring_size(offs), 4U);
+    ASSERT_EQ(cstring_size(ids), 4U);
+    ASSERT_EQ(offs[0], 1);
+    ASSERT_EQ(ids[0], 1U);
+    ASSERT_EQ(offs[1], 2);
+    ASSERT_EQ(ids[1], 0U);
+    ASSERT_EQ(offs[2], 2);
+    ASSERT_EQ(ids[2], 3U);
+    ASSERT_EQ(offs[3], 11);
+    ASSERT_EQ(ids[3], 2U);
+    cstring_matcher_ids(matcher, str, ids);
+    ASSERT_EQ(cstring_size(ids), 4U);
+    ASSERT_EQ(ids[0], 1U);
+    ASSERT_EQ(ids[1], 0U);
+    ASSERT_EQ(ids[2], 3U);
+    ASSERT_EQ(ids[3], 2U);
+
+    cstring_view_substring(str, 3, 8, view);
+    cstring_view_matcher_find_first(matcher, view, off, id);
+    ASSERT_EQ(off, -1);
+    cstring_view_matcher_find_all(matcher, view, offs, ids);
+    ASSERT_EQ(cstring_size(offs), 0U);
+    cstring_view_matcher_ids(matcher, view, ids);
+    ASSERT_EQ(cstring_size(ids), 0U);
+    cstring_view_substring(str, 9, 5, view);
+    cstring_view_matcher_find_all(matcher, view, offs, ids);
+    ASSERT_EQ(cstring_size(offs), 1U);
+    ASSERT_EQ(offs[0], 2);
+    ASSERT_EQ(ids[0], 2U);
+
+    /* duplicates report the lowest ID, matches can nest */
+    cstring_array_clear(pats);
+    cstring_array_push_back(pats, "aa", 2);
+    cstring_array_push_back(pats, "a", 1);
+    cstring_array_push_back(pats, "aa", 2);
+    cstring_matcher_build(pats, matcher);
+    cstring_assign(str, "baaa", 4);
+    cstring_matcher_find_all(matcher, str, offs, ids);
+    ASSERT_EQ(cstring_size(offs), 5U);
+    ASSERT_EQ(offs[0], 1);
+    ASSERT_EQ(ids[0], 1U);
+    ASSERT_EQ(offs[1], 1);
+    ASSERT_EQ(ids[1], 0U);
+    ASSERT_EQ(offs[2], 2);
+    ASSERT_EQ(ids[2], 1U);
+    ASSERT_EQ(offs[3], 2);
+    ASSERT_EQ(ids[3], 0U);
+    ASSERT_EQ(offs[4], 3);
+    ASSERT_EQ(ids[4], 1U);
+    cstring_matcher_ids(matcher, str, ids);
+    ASSERT_EQ(cstring_size(ids), 2U);
+
+    /* no patterns */
+    cstring_array_clear(pats);
+    cstring_matcher_build(pats, matcher);
+    cstring_matcher_find_first(matcher, str, off, id);
+    ASSERT_EQ(off, -1);
+    cstring_matcher_free(matcher);
+    ASSERT_TRUE(matcher == NULL);
+
+    /* -- wide string -- */
+
+    cstring_array_push_back(wpats, L"he", 2);
+    cstring_array_push_back(wpats, L"she", 3);
+    cstring_array_push_back(wpats, L"\x4e2d\x6587", 2);
+    cstring_matcher_build(wpats, wmatcher);
+    cstring_assign(wstr, L"a\x4e2d\x6587 she", 7);
+
+    cstring_matcher_find_first(wmatcher, wstr, off, id);
+    ASSERT_EQ(off, 1);
+    ASSERT_EQ(id, 2U);
+    cstring_matcher_find_all(wmatcher, wstr, offs, ids);
+    ASSERT_EQ(cstring_size(offs), 3U);
+    ASSERT_EQ(offs[1], 4);
+    ASSERT_EQ(ids[1], 1U);
+    ASSERT_EQ(offs[2], 5);
+    ASSERT_EQ(ids[2], 0U);
+    cstring_matcher_ids(wmatcher, wstr, ids);
+    ASSERT_EQ(cstring_size(ids), 3U);
+
+    /* patterns must match at character boundaries only */
+    cstring_array_clear(wpats);
+    cstring_array_push_back(wpats, L"\x0100\x0200", 2);
+    cstring_matcher_build(wpats, wmatcher);
+    cstring_assign(wstr, L"\x0001\x0100\x0200", 3);
+    cstring_view_substring(wstr, 1, 2, wview);
+    cstring_view_matcher_find_first(wmatcher, wview, off, id);
+    ASSERT_EQ(off, 0);
+    ASSERT_EQ(id, 0U);
+    cstring_array_clear(wpats);
+    cstring_array_push_back(wpats, L"A", 1);
+    cstring_matcher_build(wpats, wmatcher);
+    cstring_assign(wstr, L"\x4100", 1);
+    cstring_push_back(wstr, 0);
+    cstring_matcher_find_first(wmatcher, wstr, off, id);
+    ASSERT_EQ(off, -1);
+    cstring_push_back(wstr, L'A');
+    cstring_matcher_find_first(wmatcher, wstr, off, id);
+    ASSERT_EQ(off, 2);
+
+    cstring_matcher_free(wmatcher);
+    cstring_matcher_free(matcher);
+    cstring_free(offs);
+    cstring_free(ids);
+    cstring_free(wstr);
+    cstring_free(str);
+    cstring_array_free(wpats);
+    cstring_array_free(pats);
+}
+
+UTEST(edit, cstring_edit) {
+    size_t i;
+    cstring_string_type(char) str = NULL;
+    cstring_string_type(char) ref = NULL;
+    cstring_edit_type(char) edit;
+    cstring_string_type(wchar_t) wstr = NULL;
+    cstring_edit_type(wchar_t) wedit;
+
+    cstring_edit_init(edit);
+    cstring_assign(str, "Hello {name}, you owe {sum}.", 28);
+    /* added out of order, against the original positions */
+    cstring_edit_replace(edit, 22, 5, "42 EUR", 6);
+    cstring_edit_replace(edit, 6, 6, "Bob", 3);
+    cstring_edit_insert(edit, 0, ">> ", 3);
+    cstring_edit_erase(edit, 27, 1);
+    cstring_edit_insert(edit, 28, "!", 1);
+    ASSERT_EQ(cstring_edit_size(edit), 5U);
+    cstring_edit_apply(edit, str);
+    ASSERT_EQ(cstring_edit_size(edit), 0U);
+    ASSERT_STREQ(str, ">> Hello Bob, you owe 42 EUR!");
+    ASSERT_EQ(cstring_size(str), 29U);
+
+    /* insertions at the same position keep their order, erasures are merged */
+    cstring_assign(str, "0123456789", 10);
+    cstring_edit_insert(edit, 2, "a", 1);
+    cstring_edit_erase(edit, 1, 4);
+    cstring_edit_insert(edit, 2, "b", 1);
+    cstring_edit_erase(edit, 3, 4);
+    cstring_edit_insert(edit, 100, "z", 1);
+    cstring_edit_apply(edit, str);
+    ASSERT_STREQ(str, "0ab789z");
+
+    /* shrinking ahead of growing */
+    cstring_assign(str, "aaaaaaaaaabbbbbbbbbb", 20);
+    cstring_edit_erase(edit, 0, 10);
+    cstring_edit_insert(edit, 20, "cccccccccccc", 12);
+    cstring_edit_apply(edit, str);
+    ASSERT_STREQ(str, "bbbbbbbbbbcccccccccccc");
+    /* growing ahead of shrinking */
+    cstring_edit_insert(edit, 0, "dddddddddddd", 12);
+    cstring_edit_erase(edit, 10, 12);
+    cstring_edit_apply(edit, str);
+    ASSERT_STREQ(str, "ddddddddddddbbbbbbbbbb");
+
+    /* NULL string */
+    cstring_free(str);
+    cstring_edit_insert(edit, 0, "abc", 3);
+    cstring_edit_apply(edit, str);
+    ASSERT_STREQ(str, "abc");
+
+    /* compare with individual edits from the back */
+    cstring_clear(str);
+    for (i = 0; i < 200; ++i) {
+        cstring_push_back(str, (char)('a' + (char)(i % 26)));
+    }
+    cstring_copy(str, ref);
+    for (i = 0; i < 200; i += 7) {
+        cstring_edit_replace(edit, i, i % 3, "xyz", i % 4);
+    }
+    for (i = 200; i-- > 0;) {
+        if (i % 7 == 0) {
+            cstring_replace(ref, i, i % 3, "xyz", i % 4);
+        }
+    }
+    cstring_edit_apply(edit, str);
+    ASSERT_STREQ(str, ref);
+
+    /* -- wide string -- */
+
+    cstring_edit_init(wedit);
+    cstring_assign(wstr, L"a,b,c", 5);
+    cstring_edit_replace(wedit, 3, 1, L"; ", 2);
+    cstring_edit_replace(wedit, 1, 1, L"; ", 2);
+    cstring_edit_apply(wedit, wstr);
+    ASSERT_TRUE(wcseq(wstr, L"a; b; c"));
+
+    cstring_edit_free(wedit);
+    cstring_edit_free(edit);
+    cstring_free(wstr);
+    cstring_free(ref);
+    cstring_free(str);
+}
+
+UTEST(stream, cstring_replacer) {
+    size_t i, chunk;
+    cstring_string_type(char) text = NULL;
+    cstring_string_type(char) ref  = NULL;
+    cstring_string_type(char) res  = NULL;
+    cstring_string_type(char) out  = NULL;
+    cstring_replacer_type(char) rep;
+    cstring_string_type(wchar_t) wout = NULL;
+    cstring_string_type(wchar_t) wres = NULL;
+    cstring_replacer_type(wchar_t) wrep;
+
+    for (i = 0; i < 500; ++i) {
+        cstring_append(text, (i % 5) ? "ab" : "aab", (i % 5) ? 2U : 3U);
+    }
+    cstring_copy(text, ref);
+    cstring_replace_all(ref, "aab", 3, "<X>", 3);
+
+    /* any chunk size yields the same result as the replacement in one go */
+    cstring_replacer_init(rep, "aab", 3, "<X>", 3);
+    for (chunk = 1; chunk < 12; ++chunk) {
+        cstring_clear(res);
+        for (i = 0; i < cstring_size(text); i += chunk) {
+            const size_t n = (cstring_size(text) - i < chunk) ? cstring_size(text) - i : chunk;
+            cstring_replacer_feed(rep, text + i, n, out);
+            if (cstring_size(out)) {
+                cstring_append(res, out, cstring_size(out));
+            }
+            /* no more than a partial match is held back */
+            ASSERT_LE(i + n, cstring_size(res) + 2U);
+        }
+        cstring_replacer_finish(rep, out);
+        if (cstring_size(out)) {
+            cstring_append(res, out, cstring_size(out));
+        }
+        ASSERT_STREQ(res, ref);
+    }
+    cstring_replacer_free(rep);
+
+    /* erasing, and a tail that is a prefix of the string to search for */
+    cstring_replacer_init(rep, "--", 2, "", 0);
+    cstring_replacer_feed(rep, "a-", 2, out);
+    ASSERT_STREQ(out, "a");
+    cstring_replacer_feed(rep, "-b-", 3, out);
+    ASSERT_STREQ(out, "b");
+    cstring_replacer_finish(rep, out);
+    ASSERT_STREQ(out, "-");
+    cstring_replacer_free(rep);
+
+    /* -- wide string -- */
+
+    cstring_replacer_init(wrep, L"\r\n", 2, L"\n", 1);
+    cstring_replacer_feed(wrep, L"x\r", 2, wout);
+    cstring_append(wres, wout, cstring_size(wout));
+    cstring_replacer_feed(wrep, L"\ny\r\n\r", 5, wout);
+    cstring_append(wres, wout, cstring_size(wout));
+    cstring_replacer_finish(wrep, wout);
+    cstring_append(wres, wout, cstring_size(wout));
+    ASSERT_TRUE(wcseq(wres, L"x\ny\n\r"));
+    cstring_replacer_free(wrep);
+
+    cstring_free(wres);
+    cstring_free(wout);
+    cstring_free(out);
+    cstring_free(res);
+    cstring_free(ref);
+    cstring_free(text);
+}
+
+UTEST(stream, cstring_scanner) {
+    size_t i;
+    ptrdiff_t off;
+    cstring_string_type(char) buf = NULL;
+    cstring_scanner_type(char) scan;
+    cstring_view_type(char) view;
+    cstring_string_type(wchar_t) wbuf = NULL;
+    cstring_scanner_type(wchar_t) wscan;
+    static const char frames[] = "GET / HTTP/1.1\r\n\r\nGET /x HTTP/1.1\r\nHost: a\r\n\r\nrest";
+
+    /* data arriving one character at a time */
+    cstring_scanner_init(scan, "\r\n\r\n", 4);
+    for (i = 0; i < strlen_of(frames); ++i) {
+        cstring_push_back(buf, frames[i]);
+        cstring_scanner_next(scan, buf, off);
+        if (i == 17) {
+            ASSERT_EQ(off, 14);
+        } else if (i == 45) {
+            ASSERT_EQ(off, 42);
+        } else {
+            ASSERT_EQ(off, -1);
+        }
+    }
+
+    /* whole frames at once, several occurrences in one piece */
+    cstring_scanner_reset(scan);
+    cstring_scanner_next(scan, buf, off);
+    ASSERT_EQ(off, 14);
+    cstring_scanner_next(scan, buf, off);
+    ASSERT_EQ(off, 42);
+    cstring_scanner_next(scan, buf, off);
+    ASSERT_EQ(off, -1);
+    /* characters already scanned are not inspected again */
+    buf[0] = '\r';
+    buf[1] = '\n';
+    buf[2] = '\r';
+    buf[3] = '\n';
+    cstring_scanner_next(scan, buf, off);
+    ASSERT_EQ(off, -1);
+
+    /* consuming frames from the front, with a pending partial occurrence */
+    cstring_assign(buf, "ab\r\n\r\ncd\r\n", 10);
+    cstring_scanner_reset(scan);
+    cstring_scanner_next(scan, buf, off);
+    ASSERT_EQ(off, 2);
+    cstring_erase(buf, 0, 6);
+    cstring_scanner_consume(scan, 6);
+    cstring_scanner_next(scan, buf, off);
+    ASSERT_EQ(off, -1);
+    cstring_append(buf, "\r", 1);
+    cstring_scanner_next(scan, buf, off);
+    ASSERT_EQ(off, -1);
+    cstring_append(buf, "\nef", 3);
+    cstring_scanner_next(scan, buf, off);
+    ASSERT_EQ(off, 2);
+    /* the partial occurrence is consumed, too */
+    cstring_assign(buf, "x\r\n", 3);
+    cstring_scanner_reset(scan);
+    cstring_scanner_next(scan, buf, off);
+    cstring_erase(buf, 0, 2);
+    cstring_scanner_consume(scan, 2);
+    cstring_append(buf, "\r\n\r\n", 4);
+    cstring_scanner_next(scan, buf, off);
+    ASSERT_EQ(off, 1);
+
+    /* views */
+    cstring_assign(buf, "aaXaaXaa", 8);
+    cstring_scanner_free(scan);
+    cstring_scanner_init(scan, "aXa", 3);
+    cstring_view_substring(buf, 0, 4, view);
+    cstring_view_scanner_next(scan, view, off);
+    ASSERT_EQ(off, 1);
+    cstring_view_substring(buf, 0, 8, view);
+    cstring_view_scanner_next(scan, view, off);
+    ASSERT_EQ(off, 4);
+    cstring_view_scanner_next(scan, view, off);
+    ASSERT_EQ(off, -1);
+    cstring_scanner_free(scan);
+
+    /* -- wide string -- */
+
+    cstring_scanner_init(wscan, L"\x2029\x2029", 2);
+    cstring_assign(wbuf, L"abc\x2029", 4);
+    cstring_scanner_next(wscan, wbuf, off);
+    ASSERT_EQ(off, -1);
+    cstring_append(wbuf, L"\x2029", 1);
+    cstring_scanner_next(wscan, wbuf, off);
+    ASSERT_EQ(off, 3);
+    cstring_scanner_free(wscan);
+
+    cstring_free(wbuf);
+    cstring_free(buf);
+}
+
+UTEST(stream, cstring_buffer) {
+    size_t i, cap = 0, consumed = 0;
+    ptrdiff_t off;
+    const char *data;
+    cstring_buffer_type(char) buf;
+    cstring_scanner_type(char) scan;
+    cstring_view_type(char) view;
+    cstring_buffer_type(wchar_t) wbuf;
+
+    cstring_buffer_init(buf);
+    ASSERT_EQ(cstring_buffer_size(buf), 0U);
+    ASSERT_TRUE(cstring_buffer_data(buf) == NULL);
+    cstring_buffer_append(buf, "abcdef", 6);
+    data = cstring_buffer_data(buf);
+    cstring_buffer_consume(buf, 2);
+    /* consuming doesn't move the rest */
+    ASSERT_TRUE(cstring_buffer_data(buf) == data + 2);
+    ASSERT_EQ(cstring_buffer_size(buf), 4U);
+    ASSERT_STREQ(cstring_buffer_data(buf), "cdef");
+    cstring_buffer_view(buf, view);
+    ASSERT_EQ(view.size, 4U);
+    ASSERT_EQ(view.data[0], 'c');
+    cstring_buffer_compact(buf);
+    ASSERT_STREQ(buf.str, "cdef");
+    ASSERT_TRUE(cstring_buffer_data(buf) == buf.str);
+    cstring_buffer_consume(buf, 10);
+    ASSERT_EQ(cstring_buffer_size(buf), 0U);
+    ASSERT_EQ(cstring_size(buf.str), 0U);
+
+    /* lines consumed as they arrive, the headroom stays bounded */
+    cstring_scanner_init(scan, "\n", 1);
+    for (i = 0; i < 10000; ++i) {
+        cstring_buffer_append(buf, "line\n", 5);
+        cstring_buffer_view(buf, view);
+        cstring_view_scanner_next(scan, view, off);
+        ASSERT_EQ(off, 4);
+        ASSERT_EQ(view.data[0], 'l');
+        cstring_buffer_consume(buf, 5);
+        cstring_scanner_consume(scan, 5);
+        consumed += 5;
+        if (i % 3 == 0) {
+            cstring_buffer_append(buf, "li", 2);
+            cstring_buffer_consume(buf, 1);
+            cstring_buffer_append(buf, "ne\n", 3);
+            cstring_buffer_consume(buf, 4);
+            consumed += 5;
+            ASSERT_EQ(cstring_buffer_size(buf), 0U);
+        }
+        if (i == 100) {
+            cap = cstring_capacity(buf.str);
+        } else if (i > 100) {
+            ASSERT_EQ(cstring_capacity(buf.str), cap);
+        }
+    }
+    ASSERT_EQ(consumed, 66670U);
+    cstring_scanner_free(scan);
+
+    /* partial consumption keeps the content */
+    for (i = 0; i < 1000; ++i) {
+        cstring_buffer_append(buf, "xy", 2);
+        cstring_buffer_consume(buf, 1);
+    }
+    ASSERT_EQ(cstring_buffer_size(buf), 1000U);
+    ASSERT_EQ(cstring_buffer_data(buf)[0], 'x');
+    ASSERT_EQ(cstring_buffer_data(buf)[999], 'y');
+    ASSERT_EQ(cstring_buffer_data(buf)[1000], '\0');
+    ASSERT_LT(cstring_size(buf.str), 3U * cstring_buffer_size(buf));
+    cstring_buffer_free(buf);
+
+    /* -- wide string -- */
+
+    cstring_buffer_init(wbuf);
+    cstring_buffer_append(wbuf, L"abc", 3);
+    cstring_buffer_consume(wbuf, 1);
+    cstring_buffer_append(wbuf, L"d", 1);
+    ASSERT_TRUE(wcseq(cstring_buffer_data(wbuf), L"bcd"));
+    cstring_buffer_free(wbuf);
+}
+
+UTEST(gap, cstring_gap) {
+    size_t i;
+    unsigned rnd                  = 12345U;
+    cstring_string_type(char) ref = NULL;
+    cstring_string_type(char) cpy = NULL;
+    cstring_gap_type(char) gb;
+    cstring_gap_type(wchar_t) wgb;
+
+    cstring_gap_init(gb);
+    ASSERT_EQ(cstring_gap_size(gb), 0U);
+    cstring_gap_erase(gb, 3);
+    cstring_gap_backspace(gb, 3);
+    cstring_gap_flatten(gb);
+    ASSERT_TRUE(gb.buf == NULL);
+    cstring_gap_insert(gb, "hello world", 11);
+    ASSERT_EQ(cstring_gap_size(gb), 11U);
+    ASSERT_EQ(cstring_gap_cursor(gb), 11U);
+    cstring_gap_move(gb, 5);
+    cstring_gap_insert(gb, ",", 1);
+    cstring_gap_erase(gb, 1);
+    cstring_gap_insert(gb, " big ", 5);
+    cstring_gap_backspace(gb, 1);
+    ASSERT_EQ(cstring_gap_cursor(gb), 10U);
+    ASSERT_EQ(cstring_gap_at(gb, 0), 'h');
+    ASSERT_EQ(cstring_gap_at(gb, 5), ',');
+    ASSERT_EQ(cstring_gap_at(gb, 10), 'w');
+    cstring_gap_replace(gb, 5, "World!", 6);
+    cstring_gap_copy(gb, cpy);
+    ASSERT_STREQ(cpy, "hello, bigWorld!");
+    cstring_gap_move(gb, 0);
+    cstring_gap_flatten(gb);
+    ASSERT_STREQ(gb.buf, "hello, bigWorld!");
+    ASSERT_EQ(cstring_size(gb.buf), 16U);
+    ASSERT_EQ(cstring_gap_cursor(gb), 16U);
+    cstring_gap_move(gb, 100);
+    ASSERT_EQ(cstring_gap_cursor(gb), 16U);
+    cstring_gap_free(gb);
+
+    /* random editing compared with the cstring functions */
+    cstring_gap_init(gb);
+    cstring_reserve(ref, 0);
+    for (i = 0; i < 3000; ++i) {
+        size_t pos, n;
+        rnd = rnd * 1103515245U + 12345U;
+        pos = (size_t)(rnd >> 8) % (cstring_size(ref) + 1);
+        n   = (size_t)(rnd >> 4) % 7;
+        cstring_gap_move(gb, pos);
+        switch ((rnd >> 20) % 4) {
+        case 0:
+            cstring_gap_insert(gb, "abcdefg", n);
+            cstring_insert(ref, pos, "abcdefg", n);
+            break;
+        case 1:
+            cstring_gap_erase(gb, n);
+            cstring_erase(ref, pos, n);
+            break;
+        case 2:
+            cstring_gap_backspace(gb, n);
+            n = (n < pos) ? n : pos;
+            cstring_erase(ref, pos - n, n);
+            break;
+        default:
+            cstring_gap_replace(gb, n, "XYZ", 3);
+            cstring_replace(ref, pos, n, "XYZ", 3);
+            break;
+        }
+        ASSERT_EQ(cstring_gap_size(gb), cstring_size(ref));
+    }
+    for (i = 0; i < cstring_size(ref); ++i) {
+        ASSERT_EQ(cstring_gap_at(gb, i), ref[i]);
+    }
+    cstring_gap_copy(gb, cpy);
+    ASSERT_STREQ(cpy, ref);
+    cstring_gap_flatten(gb);
+    ASSERT_STREQ(gb.buf, ref);
+    cstring_gap_free(gb);
+
+    /* -- wide string -- */
+
+    cstring_gap_init(wgb);
+    cstring_gap_insert(wgb, L"ac", 2);
+    cstring_gap_move(wgb, 1);
+    cstring_gap_insert(wgb, L"b", 1);
+    cstring_gap_flatten(wgb);
+    ASSERT_TRUE(wcseq(wgb.buf, L"abc"));
+    cstring_gap_free(wgb);
+
+    cstring_free(cpy);
+    cstring_free(ref);
+}
+
+UTEST(rope, cstring_rope) {
+    size_t i, pos;
+    ptrdiff_t off, ref_off;
+    char ch;
+    wchar_t wch;
+    unsigned rnd                  = 4711U;
+    cstring_string_type(char) ref = NULL;
+    cstring_string_type(char) str = NULL;
+    cstring_rope_type(char) rope;
+    cstring_rope_type(char) sub;
+    cstring_view_type(char) view;
+    cstring_rope_type(wchar_t) wrope;
+    cstring_string_type(wchar_t) wstr = NULL;
+
+    cstring_rope_init(rope);
+    cstring_rope_init(sub);
+    ASSERT_EQ(cstring_rope_size(rope), 0U);
+    cstring_rope_flatten(rope, str);
+    ASSERT_STREQ(str, "");
+    cstring_rope_assign(rope, "world", 5);
+    cstring_rope_insert(rope, 0, "hello ", 6);
+    cstring_rope_append(rope, "!", 1);
+    ASSERT_EQ(cstring_rope_size(rope), 12U);
+    cstring_rope_at(rope, 6, ch);
+    ASSERT_EQ(ch, 'w');
+    cstring_rope_substring(rope, 6, 5, sub);
+    cstring_rope_erase(rope, 5, 100);
+    cstring_rope_flatten(rope, str);
+    ASSERT_STREQ(str, "hello");
+    cstring_rope_flatten(sub, str);
+    ASSERT_STREQ(str, "world");
+    cstring_rope_concat(sub, sub);
+    cstring_rope_insert_rope(rope, 0, sub);
+    cstring_rope_flatten(rope, str);
+    ASSERT_STREQ(str, "worldworldhello");
+    cstring_rope_free(sub);
+
+    /* large content, random edits compared with the cstring functions */
+    for (i = 0; i < 20000; ++i) {
+        cstring_push_back(ref, (char)('a' + (char)(i % 23)));
+    }
+    cstring_rope_assign(rope, ref, cstring_size(ref));
+    for (i = 0; i < 2000; ++i) {
+        size_t n;
+        rnd = rnd * 1103515245U + 12345U;
+        pos = (size_t)(rnd >> 8) % (cstring_size(ref) + 1);
+        n   = (size_t)(rnd >> 3) % 3000;
+        switch ((rnd >> 20) % 3) {
+        case 0:
+            n %= 7;
+            cstring_rope_insert(rope, pos, "XYZXYZX", n);
+            cstring_insert(ref, pos, "XYZXYZX", n);
+            break;
+        case 1:
+            cstring_rope_erase(rope, pos, n % 40);
+            cstring_erase(ref, pos, n % 40);
+            break;
+        default:
+            /* move a block of text to the end */
+            cstring_rope_substring(rope, pos, n, sub);
+            cstring_rope_erase(rope, pos, n);
+            cstring_rope_concat(rope, sub);
+            n = (n < cstring_size(ref) - pos) ? n : cstring_size(ref) - pos;
+            cstring_append(ref, ref + pos, n);
+            cstring_erase(ref, pos, n);
+            break;
+        }
+        ASSERT_EQ(cstring_rope_size(rope), cstring_size(ref));
+    }
+    for (i = 0; i < cstring_size(ref); i += 97) {
+        cstring_rope_at(rope, i, ch);
+        ASSERT_EQ(ch, ref[i]);
+    }
+    cstring_rope_flatten(rope, str);
+    ASSERT_STREQ(str, ref);
+
+    /* chunk iteration */
+    cstring_clear(str);
+    for (pos = 0; pos < cstring_rope_size(rope); pos += view.size) {
+        cstring_rope_chunk(rope, pos, view);
+        ASSERT_GT(view.size, 0U);
+        cstring_append(str, view.data, view.size);
+    }
+    ASSERT_STREQ(str, ref);
+
+    /* search, including occurrences across chunk boundaries */
+    for (i = 0; i < 200; ++i) {
+        const char *const needles[] = {"XYZ", "w", "vwa", "YZX", "abcdefghijklmnopqrstuvwa", "ZZ"};
+        const char *const needle    = needles[i % 6];
+        rnd                         = rnd * 1103515245U + 12345U;
+        pos                         = (size_t)(rnd >> 8) % (cstring_size(ref) + 1);
+        cstring_rope_find(rope, pos, needle, strlen(needle), off);
+        cstring_find(ref, pos, needle, strlen(needle), ref_off);
+        ASSERT_EQ(off, ref_off);
+    }
+    cstring_rope_find(rope, 0, "", 0, off);
+    ASSERT_EQ(off, -1);
+
+    /* an occurrence spanning several leaves */
+    cstring_clear(str);
+    cstring_resize(str, 1000, 'a');
+    cstring_push_back(str, 'b');
+    cstring_rope_free(sub);
+    for (i = 0; i < 30; ++i) {
+        cstring_rope_append(sub, str, 100);
+    }
+    cstring_rope_append(sub, "b", 1);
+    cstring_rope_find(sub, 0, str, cstring_size(str), off);
+    ASSERT_EQ(off, 2000);
+    cstring_rope_find(sub, 2001, str, cstring_size(str), off);
+    ASSERT_EQ(off, -1);
+    cstring_rope_free(sub);
+    cstring_rope_free(rope);
+    ASSERT_EQ(cstring_rope_size(rope), 0U);
+
+    /* characters outside of ASCII keep their value */
+    cstring_rope_assign(rope, "a\xe9\xff", 3);
+    cstring_rope_at(rope, 1, ch);
+    ASSERT_EQ(ch, '\xe9');
+    cstring_rope_find(rope, 0, "\xff", 1, off);
+    ASSERT_EQ(off, 2);
+    cstring_rope_free(rope);
+
+    /* -- wide string -- */
+
+    cstring_rope_init(wrope);
+    for (i = 0; i < 1000; ++i) {
+        cstring_rope_append(wrope, L"0123456789", 10);
+    }
+    cstring_rope_insert(wrope, 5000, L"\x4e2d", 1);
+    cstring_rope_find(wrope, 0, L"9\x4e2d" L"01", 4, off);
+    ASSERT_EQ(off, 4999);
+    cstring_rope_at(wrope, 5000, wch);
+    ASSERT_EQ(wch, L'\x4e2d');
+    cstring_rope_erase(wrope, 10, 9980);
+    cstring_rope_flatten(wrope, wstr);
+    ASSERT_TRUE(wcseq(wstr, L"0123456789" L"9" L"0123456789"));
+    cstring_rope_free(wrope);
+
+    cstring_free(wstr);
+    cstring_free(str);
+    cstring_free(ref);
+}
+
+UTEST(slab, cstring_slab_malloc_realloc_free) {
+    size_t i, j;
+    unsigned char *blocks[300];
+
+    for (i = 0; i < 300; ++i) {
+        const size_t siz = 24 + i * 17;
+        blocks[i]        = (unsigned char *)cstring_slab_malloc(siz);
+        ASSERT_TRUE(blocks[i]);
+        ASSERT_GE(cstring_slab_usable_size(blocks[i]), siz);
+        memset(blocks[i], (int)(i & 0xFF), siz);
+    }
+
+    for (i = 0; i < 300; ++i) {
+        const size_t siz = 24 + i * 17;
+        blocks[i]        = (unsigned char *)cstring_slab_realloc(blocks[i], siz * 2);
+        ASSERT_TRUE(blocks[i]);
+        ASSERT_GE(cstring_slab_usable_size(blocks[i]), siz * 2);
+        for (j = 0; j < siz; ++j) {
+            ASSERT_EQ(blocks[i][j], (unsigned char)(i & 0xFF));
+        }
+    }
+
+    /* same size class, resized in place */
+    blocks[0] = (unsigned char *)cstring_slab_realloc(blocks[0], 40);
+    {
+        unsigned char *const same = (unsigned char *)cstring_slab_realloc(blocks[0], 48);
+        ASSERT_EQ(same, blocks[0]);
+    }
+
+    /* shrink a big block into a size class */
+    blocks[299] = (unsigned char *)cstring_slab_realloc(blocks[299], 30);
+    ASSERT_TRUE(blocks[299]);
+    ASSERT_EQ(blocks[299][29], (unsigned char)(299 & 0xFF));
+
+    for (i = 0; i < 300; ++i) {
+        cstring_slab_free(blocks[i]);
+    }
+    cstring_slab_free(NULL);
+    cstring_slab_trim();
+
+    blocks[0] = (unsigned char *)cstring_slab_malloc(24);
+    ASSERT_TRUE(blocks[0]);
+    cstring_slab_free(blocks[0]);
+    cstring_slab_trim();
+}
+
+UTEST(slab, cstring_slab_usable_size_alignment) {
+    struct align_ld {
+        char c;
+        long double ld;
+    };
+    struct align_d {
+        char c;
+        double d;
+    };
+    size_t align = offsetof(struct align_ld, ld);
+    size_t i;
+    void *blocks[8];
+
+    if (align < offsetof(struct align_d, d)) {
+        align = offsetof(struct align_d, d);
+    }
+    for (i = 0; i < 8; ++i) {
+        blocks[i] = cstring_slab_malloc(1 + i * 1500);
+        ASSERT_TRUE(blocks[i]);
+        ASSERT_EQ((size_t)blocks[i] % align, 0U);
+    }
+
+    /* blocks passed through to the C library report the requested size */
+    ASSERT_EQ(cstring_slab_usable_size(blocks[7]), 1U + 7U * 1500U);
+    blocks[7] = cstring_slab_realloc(blocks[7], 20000);
+    ASSERT_TRUE(blocks[7]);
+    ASSERT_EQ((size_t)blocks[7] % align, 0U);
+    ASSERT_EQ(cstring_slab_usable_size(blocks[7]), 20000U);
+    blocks[7] = cstring_slab_realloc(blocks[7], 100);
+    ASSERT_TRUE(blocks[7]);
+    ASSERT_GE(cstring_slab_usable_size(blocks[7]), 100U);
+
+    for (i = 0; i < 8; ++i) {
+        cstring_slab_free(blocks[i]);
+    }
+    cstring_slab_trim();
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+static void *slab_thread(void *arg) {
+    void *blocks[64];
+    size_t i;
+    for (i = 0; i < 64; ++i) {
+        blocks[i] = cstring_slab_malloc(16 + i * 24);
+        memset(blocks[i], 0x5A, 16 + i * 24);
+    }
+    for (i = 1; i < 64; ++i) {
+        cstring_slab_free(blocks[i]);
+    }
+    *(void **)arg = blocks[0];
+    return NULL;
+}
+
+UTEST(slab, cstring_slab_thread_exit) {
+    pthread_t thread;
+    void *kept = NULL;
+    int i;
+
+    /* the cache of an exited thread is released, or taken over if a block is still in use */
+    for (i = 0; i < 4; ++i) {
+        ASSERT_EQ(pthread_create(&thread, NULL, slab_thread, &kept), 0);
+        ASSERT_EQ(pthread_join(thread, NULL), 0);
+        ASSERT_TRUE(kept);
+        ASSERT_EQ(((unsigned char *)kept)[15], 0x5A);
+        cstring_slab_free(kept);
+    }
+    cstring_slab_trim();
+}
+#endif
+
+UTEST(arena, cstring_arena) {
+    int i;
+    cstring_arena_type arena;
+    cstring_arena_mark_type mark;
+    cstring_string_type(char) str    = NULL;
+    cstring_string_type(char) tmp    = NULL;
+    cstring_string_type(wchar_t) wstr = NULL;
+    cstring_array_type(char) arr     = NULL;
+    const char *data;
+    const char *first;
+
+    cstring_arena_init(&arena, 256);
+
+    /* the most recent object grows in place */
+    cstring_arena_reserve(str, 8, &arena);
+    first = str;
+    ASSERT_EQ(cstring_size(str), 0U);
+    ASSERT_EQ(cstring_capacity(str), 8U);
+    cstring_append(str, "abcdefgh", 8);
+    data = str;
+    cstring_push_back(str, 'i');
+    ASSERT_EQ(str, data);
+    ASSERT_STREQ(str, "abcdefghi");
+
+    /* growing beyond the chunk moves the object to a new chunk */
+    for (i = 0; i < 1000; ++i) {
+        cstring_push_back(str, (char)('a' + i % 26));
+    }
+    ASSERT_EQ(cstring_size(str), 1009U);
+    ASSERT_EQ(str[1008], (char)('a' + 999 % 26));
+    cstring_free(str);
+
+    cstring_arena_reserve(wstr, 0, &arena);
+    cstring_append(wstr, L"wide", 4);
+    ASSERT_EQ(cstring_size(wstr), 4U);
+    ASSERT_EQ(0, wcscmp(wstr, L"wide"));
+    cstring_free(wstr);
+
+    /* the strings of an arena vector are created in the arena */
+    cstring_arena_checkpoint(&arena, mark);
+    cstring_array_arena_reserve(arr, 4, &arena);
+    cstring_assign(tmp, "a;bb;ccc;dddd;eeeee", 19);
+    cstring_split(tmp, -1, ";", 1, arr);
+    ASSERT_EQ(cstring_array_size(arr), 5U);
+    ASSERT_STREQ(arr[4], "eeeee");
+    cstring_array_push_back(arr, "ffffff", 6);
+    cstring_array_insert(arr, 0, "0", 1);
+    ASSERT_EQ(cstring_array_size(arr), 7U);
+    ASSERT_STREQ(arr[0], "0");
+    ASSERT_STREQ(arr[6], "ffffff");
+    for (i = 0; i < 7; ++i) {
+        ASSERT_TRUE(cstring_get_allocator(arr[i]) == cstring_arena_allocator);
+    }
+    cstring_array_erase(arr, 1, 2);
+    ASSERT_STREQ(arr[1], "ccc");
+    cstring_array_free(arr);
+    cstring_arena_rollback(&arena, mark);
+    cstring_free(tmp);
+
+    /* after the rollback, allocation restarts at the checkpoint */
+    str = NULL;
+    cstring_arena_reserve(str, 3, &arena);
+    cstring_arena_checkpoint(&arena, mark);
+    cstring_arena_reserve(tmp, 3, &arena);
+    data = tmp;
+    cstring_arena_rollback(&arena, mark);
+    tmp = NULL;
+    cstring_arena_reserve(tmp, 3, &arena);
+    ASSERT_EQ(tmp, data);
+
+    /* the first chunk is kept for reuse */
+    cstring_arena_reset(&arena);
+    str = NULL;
+    cstring_arena_reserve(str, 8, &arena);
+    ASSERT_EQ(str, first);
+
+    str = NULL;
+    cstring_arena_reserve(str, 1000, &arena);
+    cstring_assign(str, "reused", 6);
+    ASSERT_STREQ(str, "reused");
+
+    /* the arena can be used again after it has been released */
+    cstring_arena_release(&arena);
+    str = NULL;
+    cstring_arena_reserve(str, 8, &arena);
+    cstring_assign(str, "again", 5);
+    ASSERT_STREQ(str, "again");
+    cstring_arena_release(&arena);
+}
+
+static int counting_allocator_blocks = 0;
+
+static void counting_allocator(void *req) {
+    cstring_allocator_request_type *const r = (cstring_allocator_request_type *)req;
+    char *blk                               = r->base ? (char *)r->base - cstring_allocator_prefix_size : NULL;
+    void *const ctx                         = r->base ? cstring_allocator_context(r->base) : r->ctx;
+    if (!r->size) {
+        free(blk);
+        --counting_allocator_blocks;
+        return;
+    }
+    if (!blk) {
+        ++counting_allocator_blocks;
+    }
+    blk = (char *)realloc(blk, cstring_allocator_prefix_size + r->size);
+    if (!blk) {
+        r->base = NULL;
+        return;
+    }
+    r->base = (void *)(blk + cstring_allocator_prefix_size);
+    cstring_allocator_bind(r->base, counting_allocator, ctx);
+}
+
+UTEST(allocator, cstring_allocator_binding) {
+    int i;
+    cstring_arena_type arena;
+    cstring_string_type(char) str = NULL;
+    cstring_array_type(char) arr  = NULL;
+
+    cstring_arena_init(&arena, 0);
+
+    cstring_array_reserve_with(arr, 2, counting_allocator, NULL);
+    ASSERT_TRUE(cstring_get_allocator(arr) == counting_allocator);
+    ASSERT_EQ(counting_allocator_blocks, 1);
+    for (i = 0; i < 5; ++i) {
+        cstring_array_push_back(arr, "item", 4);
+    }
+    ASSERT_EQ(counting_allocator_blocks, 6);
+    ASSERT_TRUE(cstring_get_allocator(arr[4]) == counting_allocator);
+
+    /* strings of different allocators coexist in one vector */
+    cstring_reserve_with(str, 10, cstring_heap_allocator, NULL);
+    cstring_assign(str, "heap", 4);
+    cstring_swap(arr[0], str);
+    cstring_free(str);
+    cstring_reserve_with(str, 10, cstring_slab_allocator, NULL);
+    cstring_assign(str, "slab", 4);
+    for (i = 0; i < 100; ++i) {
+        cstring_append(str, "++++++++++", 10);
+    }
+    cstring_swap(arr[1], str);
+    cstring_free(str);
+    cstring_reserve_with(str, 10, cstring_arena_allocator, &arena);
+    cstring_assign(str, "arena", 5);
+    cstring_swap(arr[2], str);
+    cstring_free(str);
+    cstring_reserve_with(str, 10, cstring_mmap_allocator, NULL);
+    cstring_assign(str, "mmap", 4);
+    cstring_resize(str, 10000, '-');
+    cstring_swap(arr[3], str);
+    cstring_free(str);
+    ASSERT_EQ(counting_allocator_blocks, 2);
+
+    ASSERT_STREQ(arr[0], "heap");
+    ASSERT_TRUE(cstring_get_allocator(arr[0]) == cstring_heap_allocator);
+    ASSERT_EQ(cstring_size(arr[1]), 1004U);
+    ASSERT_TRUE(cstring_get_allocator(arr[1]) == cstring_slab_allocator);
+    ASSERT_STREQ(arr[2], "arena");
+    ASSERT_TRUE(cstring_get_allocator(arr[2]) == cstring_arena_allocator);
+    ASSERT_EQ(cstring_size(arr[3]), 10000U);
+    ASSERT_EQ(arr[3][9999], '-');
+    ASSERT_STREQ(arr[4], "item");
+
+    /* the default allocator is not recorded */
+    cstring_assign(str, "clib", 4);
+    ASSERT_TRUE(cstring_get_allocator(str) == NULL);
+    cstring_free(str);
+
+    cstring_array_free(arr);
+    ASSERT_EQ(counting_allocator_blocks, 0);
+    cstring_arena_release(&arena);
+}
+
 UTEST_MAIN()
@@ -90,6 +90,32 @@
         pvt_set_ttl_siz_(name, 1);                                       \
     } while (0)
 
+/**
+ * @brief cstring_local - Declare a cstring backed by a buffer with automatic
+ *                        storage duration.
+ * @details The buffer has the same layout as a heap-allocated cstring, so all
+ *          macros work on it unchanged. As long as the content fits into `N`
+ *          characters, no heap memory is allocated. Growing it beyond `N`
+ *          characters moves the content to the heap, and the cstring behaves
+ *          like any other heap-allocated cstring from then on. `cstring_free()`
+ *          handles both cases, and the string must be released using
+ *          `cstring_free()` before it goes out of scope. <br>
+ *          The declaration has to be placed along with other declarations of
+ *          the enclosing block.
+ * @param name - A not yet used variable name for the cstring variable to be
+ *               declared and initialized.
+ * @param type - The type of string to act on.
+ * @param N    - The number of characters the buffer can hold, not counting the
+ *               string terminator. Must be a constant expression.
+ */
+#define cstring_local(name, type, N)                                                                     \
+    union {                                                                                              \
+        unsigned char bytes[sizeof(void *) + sizeof(pvt_metadata_t) + ((size_t)(N) + 1) * sizeof(type)]; \
+        pvt_metadata_t align_md;                                                                         \
+        type align_ch;                                                                                   \
+    } name##_buf_s30__;                                                                                  \
+    cstring_string_type(type) name = (type *)pvt_local_init_(name##_buf_s30__.bytes, sizeof(name##_buf_s30__.bytes), sizeof(type))
+
 /**
  * @brief cstring_assign - Assign a string to a cstring.
  * @details Also see `cstring_init()`, `cstring_reserve()`,
@@ -104,11 +130,8 @@
 #define cstring_assign(str, ptr, count)                                      \
     do {                                                                     \
         const void *const chk_s00__ = (const void *)(ptr);                   \
-        if ((str) && pvt_ttl_cap_(str) < (size_t)(count) + 1) {              \
-            cstring_free(str);                                               \
-        }                                                                    \
-        if (!(str)) {                                                        \
-            pvt_grow_((str), (size_t)(count) + 1);                           \
+        if (!(str) || pvt_ttl_cap_(str) < (size_t)(count) + 1) {             \
+            pvt_renew_((str), (size_t)(count) + 1);                          \
         }                                                                    \
         if (chk_s00__ && (count)) {                                          \
             pvt_clib_memcpy((str), (ptr), (size_t)(count) * sizeof(*(ptr))); \
@@ -126,12 +149,12 @@
  * @param str - The cstring. Can be a NULL string.
  * @return void
  */
-#define cstring_free(str)                         \
-    do {                                          \
-        if (str) {                                \
-            pvt_clib_free(pvt_dat_to_base_(str)); \
-            (str) = NULL;                         \
-        }                                         \
+#define cstring_free(str)   \
+    do {                    \
+        if (str) {          \
+            pvt_free_(str); \
+            (str) = NULL;   \
+        }                   \
     } while (0)
 
 /* ---------------------- */
@@ -238,7 +261,8 @@
  *                          to contain `n` characters.
  * @details If `n` is greater than the current string capacity, the function
  *          causes the container to reallocate its storage increasing its
- *          capacity to `n` (or greater). <br>
+ *          capacity to exactly `n`. Unlike the macros that append characters,
+ *          this function does not apply the growth policy. <br>
  *          Also see `cstring_init()`, `cstring_assign()`,
  *          `cstring_push_back()`, `cstring_append()`, `cstring_resize()`.
  * @param str - The cstring. Can be a NULL string.
@@ -337,7 +361,7 @@
         if ((size_t)(pos) + 1 <= oldttl_s04__) {                                                                                                       \
             const size_t newttl_s04__ = oldttl_s04__ + (size_t)(count);                                                                                \
             if (pvt_ttl_cap_(str) < newttl_s04__) {                                                                                                    \
-                pvt_grow_((str), newttl_s04__);                                                                                                        \
+                pvt_grow_amortized_((str), newttl_s04__);                                                                                              \
             }                                                                                                                                          \
             if ((size_t)(pos) < oldttl_s04__ - 1) {                                                                                                    \
                 pvt_clib_memmove((str) + (size_t)(pos) + (size_t)(count), (str) + (size_t)(pos), sizeof(*(str)) * (oldttl_s04__ - 1 - (size_t)(pos))); \
@@ -375,20 +399,20 @@
  * @param value - The character to add.
  * @return void
  */
-#define cstring_push_back(str, value)           \
-    do {                                        \
-        size_t newttl_s06__;                    \
-        if (!(str)) {                           \
-            pvt_grow_((str), 2);                \
-            pvt_set_ttl_siz_((str), 1);         \
-        }                                       \
-        newttl_s06__ = pvt_ttl_siz_(str) + 1;   \
-        if (pvt_ttl_cap_(str) < newttl_s06__) { \
-            pvt_grow_((str), newttl_s06__);     \
-        }                                       \
-        pvt_set_ttl_siz_((str), newttl_s06__);  \
-        (str)[newttl_s06__ - 2] = (value);      \
-        (str)[newttl_s06__ - 1] = 0;            \
+#define cstring_push_back(str, value)                 \
+    do {                                              \
+        size_t newttl_s06__;                          \
+        if (!(str)) {                                 \
+            pvt_grow_((str), 2);                      \
+            pvt_set_ttl_siz_((str), 1);               \
+        }                                             \
+        newttl_s06__ = pvt_ttl_siz_(str) + 1;         \
+        if (pvt_ttl_cap_(str) < newttl_s06__) {       \
+            pvt_grow_amortized_((str), newttl_s06__); \
+        }                                             \
+        pvt_set_ttl_siz_((str), newttl_s06__);        \
+        (str)[newttl_s06__ - 2] = (value);            \
+        (str)[newttl_s06__ - 1] = 0;                  \
     } while (0)
 
 /**
@@ -441,7 +465,7 @@
             const ptrdiff_t diff_s08__ = (ptrdiff_t)(count) - (ptrdiff_t)n_s08__;                                                                               \
             const size_t newttl_s08__  = (size_t)((ptrdiff_t)siz_s08__ + diff_s08__) + 1;                                                                       \
             if (newttl_s08__ > pvt_ttl_cap_(str)) {                                                                                                             \
-                pvt_grow_((str), newttl_s08__);                                                                                                                 \
+                pvt_grow_amortized_((str), newttl_s08__);                                                                                                       \
             }                                                                                                                                                   \
             if (diff_s08__) {                                                                                                                                   \
                 pvt_clib_memmove((str) + (size_t)(pos) + (count), (str) + (size_t)(pos) + n_s08__, (siz_s08__ - n_s08__ - (size_t)(pos) + 1) * sizeof(*(str))); \
@@ -452,6 +476,25 @@
         }                                                                                                                                                       \
     } while (0)
 
+/**
+ * @brief cstring_replace_all - Replace all non-overlapping occurrences of a
+ *                              substring with another string.
+ * @details The occurrences are counted first, so that the string is grown at
+ *          most once to its exact new size. The result is then built in a
+ *          single forward pass. If the replacement is not longer than the
+ *          string to search for, the string is updated in place without any
+ *          allocation.
+ * @param str    - The cstring.
+ * @param needle - Pointer to the first character of the string to search for.
+ * @param n      - Length of the string to search for.
+ * @param ptr    - Pointer to the first replacement character. It must not
+ *                 point into `str`.
+ * @param count  - Number of consecutive replacement characters to be used.
+ * @return void
+ */
+#define cstring_replace_all(str, needle, n, ptr, count) \
+    pvt_replace_all_((str), (needle), (n), (ptr), (count))
+
 /**
  * @brief cstring_copy - Copy a cstring.
  * @param from - The original cstring.
@@ -465,11 +508,8 @@
     do {                                                                    \
         if (from) {                                                         \
             const size_t fromttl_s09__ = pvt_ttl_siz_(from);                \
-            if ((to) && pvt_ttl_cap_(to) < fromttl_s09__) {                 \
-                cstring_free(to);                                           \
-            }                                                               \
-            if (!(to)) {                                                    \
-                pvt_grow_((to), fromttl_s09__);                             \
+            if (!(to) || pvt_ttl_cap_(to) < fromttl_s09__) {                \
+                pvt_renew_((to), fromttl_s09__);                            \
             }                                                               \
             pvt_clib_memcpy((to), (from), fromttl_s09__ * sizeof(*(from))); \
             pvt_set_ttl_siz_((to), fromttl_s09__);                          \
@@ -487,18 +527,20 @@
  * @param value - The value to initialize new characters with.
  * @return void
  */
-#define cstring_resize(str, count, value)             \
-    do {                                              \
-        const size_t cnt_s10__ = (size_t)(count) + 1; \
-        size_t siz_s10__       = cstring_size(str);   \
-        if (cnt_s10__ > siz_s10__ + 1) {              \
-            pvt_grow_((str), cnt_s10__);              \
-            do {                                      \
-                (str)[siz_s10__++] = (value);         \
-            } while (siz_s10__ < cnt_s10__);          \
-        }                                             \
-        pvt_set_ttl_siz_((str), cnt_s10__);           \
-        (str)[(size_t)(count)] = 0;                   \
+#define cstring_resize(str, count, value)              \
+    do {                                               \
+        const size_t cnt_s10__ = (size_t)(count) + 1;  \
+        size_t siz_s10__       = cstring_size(str);    \
+        if (cnt_s10__ > siz_s10__ + 1) {               \
+            if (pvt_ttl_cap_(str) < cnt_s10__) {       \
+                pvt_grow_amortized_((str), cnt_s10__); \
+            }                                          \
+            do {                                       \
+                (str)[siz_s10__++] = (value);          \
+            } while (siz_s10__ < cnt_s10__);           \
+        }                                              \
+        pvt_set_ttl_siz_((str), cnt_s10__);            \
+        (str)[(size_t)(count)] = 0;                    \
     } while (0)
 
 /**
@@ -634,7 +676,7 @@
 
 /**
  * @brief cstring_find - Find the first occurrence of the given substring.
- * @details Implements the Rabin-Karp algorithm.
+ * @details Implements the Two-Way algorithm.
  * @param str        - The cstring.
  * @param pos        - Position at which to start the search, i.e. the found
  *                     substring must not begin in a position preceding `pos`.
@@ -647,19 +689,12 @@
  *                     such substring is found.
  * @return void
  */
-#define cstring_find(str, pos, ptr, count, ret_offset)                    \
-    do {                                                                  \
-        const void *const chk_s15__ = (const void *)(ptr);                \
-        size_t hs_s15__             = 0;                                  \
-        if (chk_s15__ && (ptrdiff_t)(count) > 1) {                        \
-            pvt_make_find_sub_hash_((ptr), (ptrdiff_t)(count), hs_s15__); \
-        }                                                                 \
-        pvt_find_((str), (pos), (ptr), (count), hs_s15__, (ret_offset));  \
-    } while (0);
+#define cstring_find(str, pos, ptr, count, ret_offset) \
+    pvt_find_sub_((str), cstring_size(str), (pos), (ptr), (count), (ret_offset))
 
 /**
  * @brief cstring_rfind - Find the last occurrence of the given substring.
- * @details Implements the Rabin-Karp algorithm.
+ * @details Implements the Two-Way algorithm.
  * @param str        - The cstring.
  * @param pos        - Position at which to start the search, proceeded from
  *                     right to left. Hence the found substring cannot begin in
@@ -673,51 +708,46 @@
  *                     such substring is found.
  * @return void
  */
-#define cstring_rfind(str, pos, ptr, count, ret_offset)                                                                       \
-    do {                                                                                                                      \
-        const void *const chk_s16__ = (const void *)(ptr);                                                                    \
-        const ptrdiff_t cnt_s16__   = (ptrdiff_t)(count);                                                                     \
-        const ptrdiff_t siz_s16__   = ((ptrdiff_t)(pos) == -1 || (ptrdiff_t)(pos) + cnt_s16__ > (ptrdiff_t)cstring_size(str)) \
-                                          ? (ptrdiff_t)cstring_size(str)                                                      \
-                                          : ((ptrdiff_t)(pos) + cnt_s16__);                                                   \
-        if (!chk_s16__ || (ptrdiff_t)(pos) < -1 || cnt_s16__ > siz_s16__ || !siz_s16__ || cnt_s16__ <= 0) {                   \
-            (ret_offset) = (ptrdiff_t)-1;                                                                                     \
-        } else if (cnt_s16__ == siz_s16__) {                                                                                  \
-            int eq_s16__;                                                                                                     \
-            pvt_str_n_eq_((str), (ptr), cnt_s16__, eq_s16__);                                                                 \
-            (ret_offset) = eq_s16__ ? (ptrdiff_t)0 : (ptrdiff_t)-1;                                                           \
-        } else if (cnt_s16__ == 1) {                                                                                          \
-            pvt_find_last_char_(0, (str), (pos), (ptr), (ret_offset));                                                        \
-        } else {                                                                                                              \
-            ptrdiff_t off_s16__;                                                                                              \
-            const ptrdiff_t diff_s16__ = siz_s16__ - cnt_s16__;                                                               \
-            size_t strhs_s16__ = 0, subhs_s16__ = 0, hsfactor_s16__ = 1;                                                      \
-            static const size_t tpmsk_s16__ = pvt_get_typemask_(str);                                                         \
-            (ret_offset)                    = (ptrdiff_t)-1;                                                                  \
-            for (off_s16__ = cnt_s16__ - 1; off_s16__; --off_s16__) {                                                         \
-                strhs_s16__ = (strhs_s16__ << 1) + ((size_t)(str)[off_s16__ + diff_s16__] & tpmsk_s16__);                     \
-                subhs_s16__ = (subhs_s16__ << 1) + ((size_t)(ptr)[off_s16__] & tpmsk_s16__);                                  \
-                hsfactor_s16__ <<= 1;                                                                                         \
-            }                                                                                                                 \
-            strhs_s16__ = (strhs_s16__ << 1) + ((size_t)(str)[off_s16__ + diff_s16__] & tpmsk_s16__);                         \
-            subhs_s16__ = (subhs_s16__ << 1) + ((size_t)(ptr)[off_s16__] & tpmsk_s16__);                                      \
-            off_s16__   = diff_s16__;                                                                                         \
-            do {                                                                                                              \
-                if (subhs_s16__ == strhs_s16__) {                                                                             \
-                    int eq_s16__;                                                                                             \
-                    pvt_str_n_eq_((str) + off_s16__, (ptr), cnt_s16__, eq_s16__);                                             \
-                    if (eq_s16__) {                                                                                           \
-                        (ret_offset) = off_s16__;                                                                             \
-                        break;                                                                                                \
-                    }                                                                                                         \
-                }                                                                                                             \
-                --off_s16__;                                                                                                  \
-                strhs_s16__ =                                                                                                 \
-                    ((strhs_s16__ - hsfactor_s16__ * ((size_t)(str)[off_s16__ + cnt_s16__] & tpmsk_s16__)) << 1) +            \
-                    ((size_t)(str)[off_s16__] & tpmsk_s16__);                                                                 \
-            } while (off_s16__);                                                                                              \
-        }                                                                                                                     \
-    } while (0)
+#define cstring_rfind(str, pos, ptr, count, ret_offset) \
+    pvt_rfind_((str), cstring_size(str), (pos), (ptr), (count), (ret_offset))
+
+/**
+ * @brief cstring_find_all - Find all occurrences of the given substring.
+ * @details The string is searched in a single pass. Prefer this over calling
+ *          `cstring_find()` in a loop.
+ * @param str         - The cstring.
+ * @param ptr         - Pointer to the first character of the string to search
+ *                      for.
+ * @param count       - Length of the string to search for.
+ * @param overlap     - Nonzero to include occurrences that overlap the
+ *                      previous one, zero to continue the search after the end
+ *                      of each occurrence.
+ * @param ret_offsets - Variable of type `ptrdiff_t *` that receives a vector of
+ *                      the positions of the occurrences in ascending order.
+ *                      It's managed like a cstring, i.e. `cstring_size()` is
+ *                      the number of occurrences and it has to be released
+ *                      using `cstring_free()`. The capacity of an existing
+ *                      vector is reused.
+ * @return void
+ */
+#define cstring_find_all(str, ptr, count, overlap, ret_offsets) \
+    pvt_find_all_sub_((str), cstring_size(str), (ptr), (count), (overlap), (ret_offsets))
+
+/**
+ * @brief cstring_count - Count the occurrences of the given substring.
+ * @details Unlike `cstring_find_all()` the positions are not recorded.
+ * @param str       - The cstring.
+ * @param ptr       - Pointer to the first character of the string to search
+ *                    for.
+ * @param count     - Length of the string to search for.
+ * @param overlap   - Nonzero to count overlapping occurrences, zero to count
+ *                    the non-overlapping occurrences.
+ * @param ret_count - Variable of type `size_t` that receives the number of
+ *                    occurrences. Zero if the string to search for is empty.
+ * @return void
+ */
+#define cstring_count(str, ptr, count, overlap, ret_count) \
+    pvt_count_sub_((str), cstring_size(str), (ptr), (count), (overlap), (ret_count))
 
 /**
  * @brief cstring_find_first_of - Find the first character equal to one of the
@@ -733,7 +763,7 @@
  * @return void
  */
 #define cstring_find_first_of(str, pos, ptr, count, ret_offset) \
-    pvt_find_first_of_(0, (str), (pos), (ptr), (count), (ret_offset))
+    pvt_find_first_of_(0, (str), cstring_size(str), (pos), (ptr), (count), (ret_offset))
 
 /**
  * @brief cstring_find_first_not_of - Find the first character equal to none of
@@ -750,7 +780,7 @@
  * @return void
  */
 #define cstring_find_first_not_of(str, pos, ptr, count, ret_offset) \
-    pvt_find_first_of_(1, (str), (pos), (ptr), (count), (ret_offset))
+    pvt_find_first_of_(1, (str), cstring_size(str), (pos), (ptr), (count), (ret_offset))
 
 /**
  * @brief cstring_find_last_of - Find the last character equal to one of the
@@ -767,7 +797,7 @@
  * @return void
  */
 #define cstring_find_last_of(str, pos, ptr, count, ret_offset) \
-    pvt_find_last_of_(0, (str), (pos), (ptr), (count), (ret_offset))
+    pvt_find_last_of_(0, (str), cstring_size(str), (pos), (ptr), (count), (ret_offset))
 
 /**
  * @brief cstring_find_last_not_of - Find the last character equal to none of
@@ -785,7 +815,7 @@
  * @return void
  */
 #define cstring_find_last_not_of(str, pos, ptr, count, ret_offset) \
-    pvt_find_last_of_(1, (str), (pos), (ptr), (count), (ret_offset))
+    pvt_find_last_of_(1, (str), cstring_size(str), (pos), (ptr), (count), (ret_offset))
 
 /* ------------------ */
 /* --- operations --- */
@@ -801,21 +831,46 @@
  *                      1 if `str1` appears after `str2`
  * @return void
  */
-#define cstring_compare(str1, str2, ret_order)                                                                                                  \
-    do {                                                                                                                                        \
-        if ((str1) && (str2)) {                                                                                                                 \
-            const size_t siz_s17__ = (cstring_size(str1) < cstring_size(str2)) ? cstring_size(str1) : cstring_size(str2);                       \
-            size_t i_s17__         = 0;                                                                                                         \
-            while (i_s17__ < siz_s17__ && (str1)[i_s17__] == (str2)[i_s17__]) {                                                                 \
-                ++i_s17__;                                                                                                                      \
-            }                                                                                                                                   \
-            if ((str1)[i_s17__] == (str2)[i_s17__]) {                                                                                           \
-                (ret_order) = 0;                                                                                                                \
-            } else {                                                                                                                            \
-                static const size_t tpmsk_s17__ = pvt_get_typemask_(str1);                                                                      \
-                (ret_order)                     = (((size_t)(str1)[i_s17__] & tpmsk_s17__) < ((size_t)(str2)[i_s17__] & tpmsk_s17__)) ? -1 : 1; \
-            }                                                                                                                                   \
-        }                                                                                                                                       \
+#define cstring_compare(str1, str2, ret_order)                                                 \
+    do {                                                                                       \
+        if ((str1) && (str2)) {                                                                \
+            pvt_compare_((str1), cstring_size(str1), (str2), cstring_size(str2), (ret_order)); \
+        }                                                                                      \
+    } while (0)
+
+/**
+ * @brief cstring_equal - Check the equality of two strings.
+ * @details Other than `cstring_compare()`, strings of different length are
+ *          told apart without reading them.
+ * @param str1      - The first cstring.
+ * @param str2      - The second cstring.
+ * @param ret_equal - Variable of type `int` that receives 1 if the strings are
+ *                    equal, 0 otherwise.
+ * @return void
+ */
+#define cstring_equal(str1, str2, ret_equal)                                                 \
+    do {                                                                                     \
+        if ((str1) && (str2)) {                                                              \
+            pvt_equal_((str1), cstring_size(str1), (str2), cstring_size(str2), (ret_equal)); \
+        }                                                                                    \
+    } while (0)
+
+/**
+ * @brief cstring_mismatch - Find the first position at which two strings
+ *                           differ.
+ * @param str1       - The first cstring.
+ * @param str2       - The second cstring.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the first differing character, or -1 if the strings
+ *                     are equal. If one string is a prefix of the other, it
+ *                     receives the length of the shorter string.
+ * @return void
+ */
+#define cstring_mismatch(str1, str2, ret_offset)                                                 \
+    do {                                                                                         \
+        if ((str1) && (str2)) {                                                                  \
+            pvt_mismatch_((str1), cstring_size(str1), (str2), cstring_size(str2), (ret_offset)); \
+        }                                                                                        \
     } while (0)
 
 /**
@@ -829,15 +884,8 @@
  *                      1 if the prefix was found
  * @return void
  */
-#define cstring_starts_with(str, ptr, count, ret_found)                                      \
-    do {                                                                                     \
-        const void *const chk_s18__  = (const void *)(ptr);                                  \
-        const ptrdiff_t subsiz_s18__ = (ptrdiff_t)(count);                                   \
-        (ret_found)                  = 0;                                                    \
-        if (chk_s18__ && subsiz_s18__ > 0 && subsiz_s18__ <= (ptrdiff_t)cstring_size(str)) { \
-            pvt_str_n_eq_((str), (ptr), subsiz_s18__, (ret_found));                          \
-        }                                                                                    \
-    } while (0)
+#define cstring_starts_with(str, ptr, count, ret_found) \
+    pvt_starts_with_((str), cstring_size(str), (ptr), (count), (ret_found))
 
 /**
  * @brief cstring_ends_with - Check if the string ends with the given suffix.
@@ -850,15 +898,8 @@
  *                      1 if the suffix was found
  * @return void
  */
-#define cstring_ends_with(str, ptr, count, ret_found)                                                             \
-    do {                                                                                                          \
-        const void *const chk_s19__  = (const void *)(ptr);                                                       \
-        const ptrdiff_t subsiz_s19__ = (ptrdiff_t)(count);                                                        \
-        (ret_found)                  = 0;                                                                         \
-        if (chk_s19__ && subsiz_s19__ > 0 && subsiz_s19__ <= (ptrdiff_t)cstring_size(str)) {                      \
-            pvt_str_n_eq_((str) + (ptrdiff_t)cstring_size(str) - subsiz_s19__, (ptr), subsiz_s19__, (ret_found)); \
-        }                                                                                                         \
-    } while (0)
+#define cstring_ends_with(str, ptr, count, ret_found) \
+    pvt_ends_with_((str), cstring_size(str), (ptr), (count), (ret_found))
 
 /**
  * @brief cstring_contains - Check if the string contains the given substring.
@@ -871,12 +912,8 @@
  *                      1 if the substring was found
  * @return void
  */
-#define cstring_contains(str, ptr, count, ret_found)       \
-    do {                                                   \
-        ptrdiff_t off_s20__;                               \
-        cstring_find((str), 0, (ptr), (count), off_s20__); \
-        (ret_found) = (off_s20__ >= 0);                    \
-    } while (0)
+#define cstring_contains(str, ptr, count, ret_found) \
+    pvt_contains_((str), cstring_size(str), (ptr), (count), (ret_found))
 
 /**
  * @brief cstring_substring - Copy a part of a string.
@@ -893,11 +930,8 @@
     do {                                                                                                                                        \
         if ((from) && pvt_ttl_siz_(from) > (size_t)(pos)) {                                                                                     \
             const size_t subsiz_s21__ = ((size_t)(pos) + (size_t)(n) >= cstring_size(from)) ? cstring_size(from) - (size_t)(pos) : (size_t)(n); \
-            if ((to) && pvt_ttl_cap_(to) < subsiz_s21__ + 1) {                                                                                  \
-                cstring_free(to);                                                                                                               \
-            }                                                                                                                                   \
-            if (!(to)) {                                                                                                                        \
-                pvt_grow_((to), subsiz_s21__ + 1);                                                                                              \
+            if (!(to) || pvt_ttl_cap_(to) < subsiz_s21__ + 1) {                                                                                 \
+                pvt_renew_((to), subsiz_s21__ + 1);                                                                                             \
             }                                                                                                                                   \
             pvt_clib_memcpy((to), (from) + (size_t)(pos), subsiz_s21__ * sizeof(*(from)));                                                      \
             pvt_set_ttl_siz_((to), subsiz_s21__ + 1);                                                                                           \
@@ -956,49 +990,184 @@
  *                    content is overwritten.
  * @return void
  */
-#define cstring_split(str, max_tok, ptr, count, ret_array)                                                  \
-    do {                                                                                                    \
-        const void *const chk_a00__ = (const void *)(ptr);                                                  \
-        const ptrdiff_t cnt_a00__   = (ptrdiff_t)(count);                                                   \
-        cstring_array_clear(ret_array);                                                                     \
-        if ((str) && (max_tok) && (ptrdiff_t)(max_tok) > -2 && chk_a00__ && cnt_a00__ > 0) {                \
-            ptrdiff_t off_a00__;                                                                            \
-            ptrdiff_t beg_a00__       = 0;                                                                  \
-            size_t i_a00__            = 0;                                                                  \
-            size_t subhs_a00__        = 0;                                                                  \
-            const size_t delcnt_a00__ = (size_t)(max_tok) - (size_t)1;                                      \
-            cstring_array_reserve((ret_array), 63);                                                         \
-            pvt_set_ttl_siz_((ret_array), 1);                                                               \
-            if (cnt_a00__ > 1) {                                                                            \
-                pvt_make_find_sub_hash_((ptr), cnt_a00__, subhs_a00__);                                     \
-            }                                                                                               \
-            pvt_find_((str), beg_a00__, (ptr), cnt_a00__, subhs_a00__, off_a00__);                          \
-            for (; off_a00__ != -1 && i_a00__ < delcnt_a00__; ++i_a00__) {                                  \
-                cstring_push_back((ret_array), NULL);                                                       \
-                cstring_assign((ret_array)[i_a00__], (str) + beg_a00__, off_a00__ - beg_a00__);             \
-                beg_a00__ = off_a00__ + cnt_a00__;                                                          \
-                pvt_find_((str), beg_a00__, (ptr), cnt_a00__, subhs_a00__, off_a00__);                      \
-            }                                                                                               \
-            cstring_push_back((ret_array), NULL);                                                           \
-            cstring_assign((ret_array)[i_a00__], (str) + beg_a00__, cstring_size(str) - (size_t)beg_a00__); \
-            (ret_array)[i_a00__ + 1] = NULL;                                                                \
-        }                                                                                                   \
+#define cstring_split(str, max_tok, ptr, count, ret_array) \
+    pvt_split_((str), cstring_size(str), (max_tok), (ptr), (count), (ret_array))
+
+/**
+ * @brief cstring_split_into - Tokenize a cstring into an existing
+ *                             cstring_array vector.
+ * @details Other than `cstring_split()`, the strings of the existing vector are
+ *          not released. They are overwritten with the new tokens and their
+ *          capacity is reused. Memory is only allocated if a token outgrows the
+ *          string it is assigned to, or if the number of tokens grows.
+ *          Afterwards the size of the vector is the number of tokens. Strings
+ *          beyond the tokens are released once the vector is filled, so a
+ *          vector that is repeatedly split into the same number of tokens
+ *          doesn't allocate or release any string. The allocator of the vector
+ *          is not changed.
+ * @param str       - The cstring.
+ * @param max_tok   - Maximum number of tokens to be created. -1 specifies that
+ *                    all tokens are created.
+ * @param ptr       - Pointer to the first character of the delimiter string
+ *                    that separates the tokens in `str`.
+ * @param count     - Number of consecutive characters to be used as delimiter.
+ * @param ret_array - Variable of cstring_array(type) that receives the created
+ *                    vector. Can be a NULL vector.
+ * @return void
+ */
+#define cstring_split_into(str, max_tok, ptr, count, ret_array) \
+    pvt_split_into_((str), cstring_size(str), (max_tok), (ptr), (count), (ret_array))
+
+/**
+ * @brief cstring_split_packed - Tokenize a cstring into a packed cstring_array
+ *                               vector.
+ * @details Other than `cstring_split()`, the vector and all of its strings are
+ *          stored back to back in a single allocation. See
+ *          `cstring_array_pack()` for the behavior of a packed vector.
+ * @param str       - The cstring.
+ * @param max_tok   - Maximum number of tokens to be created. -1 specifies that
+ *                    all tokens are created.
+ * @param ptr       - Pointer to the first character of the delimiter string
+ *                    that separates the tokens in `str`.
+ * @param count     - Number of consecutive characters to be used as delimiter.
+ * @param ret_array - Variable of cstring_array(type) that receives the created
+ *                    vector. Can be a NULL vector. <br>
+ *                    If `ret_array` refers to an existing vector, it is
+ *                    released. It receives a NULL vector if the arguments are
+ *                    invalid.
+ * @return void
+ */
+#define cstring_split_packed(str, max_tok, ptr, count, ret_array)                                                 \
+    do {                                                                                                          \
+        const void *const chk_a11__ = (const void *)(ptr);                                                        \
+        const ptrdiff_t cnt_a11__   = (ptrdiff_t)(count);                                                         \
+        cstring_array_free(ret_array);                                                                            \
+        if ((str) && (max_tok) && (ptrdiff_t)(max_tok) > -2 && chk_a11__ && cnt_a11__ > 0) {                      \
+            ptrdiff_t off_a11__;                                                                                  \
+            ptrdiff_t beg_a11__       = 0;                                                                        \
+            size_t i_a11__            = 0;                                                                        \
+            size_t n_a11__            = 0;                                                                        \
+            pvt_twoway_t crit_a11__   = {0, 0, 0};                                                                \
+            const size_t delcnt_a11__ = (size_t)(max_tok) - (size_t)1;                                            \
+            char *slot_a11__          = NULL;                                                                     \
+            if (cnt_a11__ > 1) {                                                                                  \
+                pvt_make_find_sub_crit_((ptr), cnt_a11__, crit_a11__);                                            \
+            }                                                                                                     \
+            pvt_find_((str), cstring_size(str), beg_a11__, (ptr), cnt_a11__, crit_a11__, off_a11__);              \
+            for (; off_a11__ != -1 && n_a11__ < delcnt_a11__; ++n_a11__) {                                        \
+                const ptrdiff_t from_a11__ = off_a11__ + cnt_a11__;                                               \
+                pvt_find_((str), cstring_size(str), from_a11__, (ptr), cnt_a11__, crit_a11__, off_a11__);         \
+            }                                                                                                     \
+            ++n_a11__;                                                                                            \
+            (ret_array) = pvt_packed_new_(n_a11__, pvt_packed_bound_(n_a11__, cstring_size(str), sizeof(*(str))), \
+                                          sizeof(*(str)), &slot_a11__);                                           \
+            pvt_clib_assert(ret_array);                                                                           \
+            for (; i_a11__ + 1 < n_a11__; ++i_a11__) {                                                            \
+                pvt_find_((str), cstring_size(str), beg_a11__, (ptr), cnt_a11__, crit_a11__, off_a11__);          \
+                (ret_array)[i_a11__] = pvt_packed_put_(&slot_a11__, (str) + beg_a11__,                            \
+                                                       (size_t)(off_a11__ - beg_a11__), sizeof(*(str)));          \
+                beg_a11__ = off_a11__ + cnt_a11__;                                                                \
+            }                                                                                                     \
+            (ret_array)[i_a11__] = pvt_packed_put_(&slot_a11__, (str) + beg_a11__,                                \
+                                                   cstring_size(str) - (size_t)beg_a11__, sizeof(*(str)));        \
+            (ret_array)[n_a11__] = NULL;                                                                          \
+            pvt_set_ttl_siz_((ret_array), n_a11__ + 1);                                                           \
+        }                                                                                                         \
+    } while (0)
+
+/**
+ * @brief cstring_argv_type - The type of a vector of pointers into a tokenized
+ *                            cstring.
+ * @details The vector is filled by `cstring_split_inplace()`. Its elements are
+ *          no cstrings but plain pointers into the tokenized cstring, and the
+ *          vector is terminated by a NULL pointer like the `argv` parameter of
+ *          `main()`. It must not be used any longer if the tokenized cstring is
+ *          modified or released.
+ * @param type - The character type of the tokenized cstring.
+ */
+#define cstring_argv_type(type) \
+    type **
+
+/**
+ * @brief cstring_split_inplace - Tokenize a cstring in place.
+ * @details Other than `cstring_split()`, no string is created. Each delimiter in
+ *          `str` is overwritten with null characters, and `ret_argv` receives
+ *          pointers to the beginning of the tokens. The size of `str` is not
+ *          changed.
+ * @param str      - The cstring.
+ * @param max_tok  - Maximum number of tokens to be created. -1 specifies that
+ *                   all tokens are created.
+ * @param ptr      - Pointer to the first character of the delimiter string that
+ *                   separates the tokens in `str`. It must not refer to a part
+ *                   of `str`.
+ * @param count    - Number of consecutive characters to be used as delimiter.
+ * @param ret_argv - Variable of cstring_argv_type(type) that receives the
+ *                   pointers. Can be a NULL vector. <br>
+ *                   If `ret_argv` refers to an existing vector, the old content
+ *                   is overwritten and its capacity is reused.
+ * @return void
+ */
+#define cstring_split_inplace(str, max_tok, ptr, count, ret_argv)                                        \
+    do {                                                                                                 \
+        const void *const chk_a13__ = (const void *)(ptr);                                               \
+        const ptrdiff_t cnt_a13__   = (ptrdiff_t)(count);                                                \
+        cstring_clear(ret_argv);                                                                         \
+        if ((str) && (max_tok) && (ptrdiff_t)(max_tok) > -2 && chk_a13__ && cnt_a13__ > 0) {             \
+            ptrdiff_t off_a13__;                                                                         \
+            ptrdiff_t i_a13__;                                                                           \
+            ptrdiff_t beg_a13__       = 0;                                                               \
+            size_t n_a13__            = 0;                                                               \
+            pvt_twoway_t crit_a13__   = {0, 0, 0};                                                       \
+            const size_t delcnt_a13__ = (size_t)(max_tok) - (size_t)1;                                   \
+            if (cnt_a13__ > 1) {                                                                         \
+                pvt_make_find_sub_crit_((ptr), cnt_a13__, crit_a13__);                                   \
+            }                                                                                            \
+            pvt_find_((str), cstring_size(str), beg_a13__, (ptr), cnt_a13__, crit_a13__, off_a13__);     \
+            for (; off_a13__ != -1 && n_a13__ < delcnt_a13__; ++n_a13__) {                               \
+                cstring_push_back((ret_argv), (str) + beg_a13__);                                        \
+                for (i_a13__ = 0; i_a13__ < cnt_a13__; ++i_a13__) {                                      \
+                    (str)[off_a13__ + i_a13__] = 0;                                                      \
+                }                                                                                        \
+                beg_a13__ = off_a13__ + cnt_a13__;                                                       \
+                pvt_find_((str), cstring_size(str), beg_a13__, (ptr), cnt_a13__, crit_a13__, off_a13__); \
+            }                                                                                            \
+            cstring_push_back((ret_argv), (str) + beg_a13__);                                            \
+        }                                                                                                \
     } while (0)
 
+/**
+ * @brief cstring_argv_size - Get the number of pointers in a vector created by
+ *                            `cstring_split_inplace()`.
+ * @param argv - The vector. Can be a NULL vector.
+ * @return The number of pointers, not counting the terminating NULL pointer.
+ */
+#define cstring_argv_size(argv) \
+    cstring_size(argv)
+
+/**
+ * @brief cstring_argv_free - Free a vector created by `cstring_split_inplace()`
+ *                            and set it to NULL.
+ * @details The tokenized cstring is not affected.
+ * @param argv - The vector. Can be a NULL vector.
+ * @return void
+ */
+#define cstring_argv_free(argv) \
+    cstring_free(argv)
+
 /**
  * @brief cstring_array_free - Recursively free all memory associated with the
  *                             cstring_array and set it to NULL.
  * @param arr - The cstring_array. Can be a NULL vector.
  * @return void
  */
-#define cstring_array_free(arr)                              \
-    do {                                                     \
-        const size_t siz_a01__ = cstring_size(arr);          \
-        size_t i_a01__         = 0;                          \
-        for (; i_a01__ < siz_a01__; ++i_a01__) {             \
-            pvt_clib_free(pvt_dat_to_base_((arr)[i_a01__])); \
-        }                                                    \
-        cstring_free(arr);                                   \
+#define cstring_array_free(arr)                     \
+    do {                                            \
+        const size_t siz_a01__ = cstring_size(arr); \
+        size_t i_a01__         = 0;                 \
+        for (; i_a01__ < siz_a01__; ++i_a01__) {    \
+            pvt_free_((arr)[i_a01__]);              \
+        }                                           \
+        cstring_free(arr);                          \
     } while (0)
 
 /**
@@ -1085,7 +1254,7 @@
  *                                enough to contain `n` strings.
  * @details If `n` is greater than the current vector capacity, the function
  *          causes the container to reallocate its storage increasing its
- *          capacity to `n` (or greater).
+ *          capacity to exactly `n`.
  * @param arr - The cstring_array. Can be a NULL vector.
  * @param n   - Minimum capacity for the vector.
  * @return void
@@ -1115,17 +1284,17 @@
  * @param arr - The cstring_array.
  * @return void
  */
-#define cstring_array_clear(arr)                                 \
-    do {                                                         \
-        if (arr) {                                               \
-            const size_t siz_a02__ = cstring_size(arr);          \
-            size_t i_a02__         = 0;                          \
-            for (; i_a02__ < siz_a02__; ++i_a02__) {             \
-                pvt_clib_free(pvt_dat_to_base_((arr)[i_a02__])); \
-            }                                                    \
-            pvt_set_ttl_siz_((arr), 1);                          \
-            (arr)[0] = NULL;                                     \
-        }                                                        \
+#define cstring_array_clear(arr)                        \
+    do {                                                \
+        if (arr) {                                      \
+            const size_t siz_a02__ = cstring_size(arr); \
+            size_t i_a02__         = 0;                 \
+            for (; i_a02__ < siz_a02__; ++i_a02__) {    \
+                pvt_free_((arr)[i_a02__]);              \
+            }                                           \
+            pvt_set_ttl_siz_((arr), 1);                 \
+            (arr)[0] = NULL;                            \
+        }                                               \
     } while (0)
 
 /**
@@ -1143,13 +1312,12 @@
         if ((size_t)(pos) + 1 <= pvt_ttl_siz_(arr)) {                                                                                    \
             const size_t newttl_a03__ = pvt_ttl_siz_(arr) + 1;                                                                           \
             if (pvt_ttl_cap_(arr) < newttl_a03__) {                                                                                      \
-                pvt_grow_((arr), newttl_a03__);                                                                                          \
+                pvt_grow_amortized_((arr), newttl_a03__);                                                                                \
             }                                                                                                                            \
             if ((size_t)(pos) < newttl_a03__ - 2) {                                                                                      \
                 pvt_clib_memmove((arr) + (size_t)(pos) + 1, (arr) + (size_t)(pos), sizeof(*(arr)) * (newttl_a03__ - 2 - (size_t)(pos))); \
             }                                                                                                                            \
-            (arr)[(pos)] = NULL;                                                                                                         \
-            cstring_assign((arr)[(pos)], (ptr), (count));                                                                                \
+            pvt_elem_assign_((arr), (pos), (ptr), (count));                                                                              \
             pvt_set_ttl_siz_((arr), newttl_a03__);                                                                                       \
             (arr)[newttl_a03__ - 1] = NULL;                                                                                              \
         }                                                                                                                                \
@@ -1170,7 +1338,7 @@
             const size_t n_a04__ = ((size_t)(pos) + (size_t)(n) >= cstring_size(arr)) ? cstring_size(arr) - (size_t)(pos) : (size_t)(n); \
             size_t i_a04__       = (size_t)(pos);                                                                                        \
             for (; i_a04__ < (size_t)(pos) + n_a04__; ++i_a04__) {                                                                       \
-                pvt_clib_free(pvt_dat_to_base_((arr)[i_a04__]));                                                                         \
+                pvt_free_((arr)[i_a04__]);                                                                                               \
             }                                                                                                                            \
             ttl_a04__ -= n_a04__;                                                                                                        \
             pvt_set_ttl_siz_((arr), ttl_a04__);                                                                                          \
@@ -1186,21 +1354,20 @@
  * @param count - Number of consecutive characters to be used.
  * @return void
  */
-#define cstring_array_push_back(arr, ptr, count)                 \
-    do {                                                         \
-        size_t newttl_a05__;                                     \
-        if (!(arr)) {                                            \
-            pvt_grow_((arr), 2);                                 \
-            pvt_set_ttl_siz_((arr), 1);                          \
-        }                                                        \
-        newttl_a05__ = pvt_ttl_siz_(arr) + 1;                    \
-        if (pvt_ttl_cap_(arr) < newttl_a05__) {                  \
-            pvt_grow_((arr), newttl_a05__);                      \
-        }                                                        \
-        pvt_set_ttl_siz_((arr), newttl_a05__);                   \
-        (arr)[newttl_a05__ - 2] = NULL;                          \
-        cstring_assign((arr)[newttl_a05__ - 2], (ptr), (count)); \
-        (arr)[newttl_a05__ - 1] = NULL;                          \
+#define cstring_array_push_back(arr, ptr, count)                   \
+    do {                                                           \
+        size_t newttl_a05__;                                       \
+        if (!(arr)) {                                              \
+            pvt_grow_((arr), 2);                                   \
+            pvt_set_ttl_siz_((arr), 1);                            \
+        }                                                          \
+        newttl_a05__ = pvt_ttl_siz_(arr) + 1;                      \
+        if (pvt_ttl_cap_(arr) < newttl_a05__) {                    \
+            pvt_grow_amortized_((arr), newttl_a05__);              \
+        }                                                          \
+        pvt_set_ttl_siz_((arr), newttl_a05__);                     \
+        pvt_elem_assign_((arr), newttl_a05__ - 2, (ptr), (count)); \
+        (arr)[newttl_a05__ - 1] = NULL;                            \
     } while (0)
 
 /**
@@ -1227,21 +1394,21 @@
  *               overwritten.
  * @return void
  */
-#define cstring_array_copy(from, to)                          \
-    do {                                                      \
-        cstring_array_clear(to);                              \
-        if (from) {                                           \
-            const size_t fromttl_a07__ = pvt_ttl_siz_(from);  \
-            size_t i_a07__             = 0;                   \
-            cstring_free(to);                                 \
-            pvt_grow_((to), fromttl_a07__);                   \
-            for (; i_a07__ < fromttl_a07__ - 1; ++i_a07__) {  \
-                (to)[i_a07__] = NULL;                         \
-                cstring_copy((from)[i_a07__], (to)[i_a07__]); \
-            }                                                 \
-            (to)[i_a07__] = NULL;                             \
-            pvt_set_ttl_siz_((to), fromttl_a07__);            \
-        }                                                     \
+#define cstring_array_copy(from, to)                                                \
+    do {                                                                            \
+        cstring_array_clear(to);                                                    \
+        if (from) {                                                                 \
+            const size_t fromttl_a07__ = pvt_ttl_siz_(from);                        \
+            size_t i_a07__             = 0;                                         \
+            pvt_renew_((to), fromttl_a07__);                                        \
+            for (; i_a07__ < fromttl_a07__ - 1; ++i_a07__) {                        \
+                (to)[i_a07__] = NULL;                                               \
+                pvt_grow_like_((to)[i_a07__], pvt_ttl_siz_((from)[i_a07__]), (to)); \
+                cstring_copy((from)[i_a07__], (to)[i_a07__]);                       \
+            }                                                                       \
+            (to)[i_a07__] = NULL;                                                   \
+            pvt_set_ttl_siz_((to), fromttl_a07__);                                  \
+        }                                                                           \
     } while (0)
 
 /**
@@ -1254,23 +1421,24 @@
  * @param count - Number of consecutive characters to be used.
  * @return void
  */
-#define cstring_array_resize(arr, n, ptr, count)                   \
-    do {                                                           \
-        const size_t n_a08__ = (size_t)(n);                        \
-        size_t siz_a08__     = cstring_size(arr);                  \
-        if (n_a08__ > siz_a08__) {                                 \
-            pvt_grow_((arr), n_a08__ + 1);                         \
-            do {                                                   \
-                (arr)[siz_a08__] = NULL;                           \
-                cstring_assign((arr)[siz_a08__], (ptr), (count));  \
-            } while (++siz_a08__ < n_a08__);                       \
-        } else {                                                   \
-            while (siz_a08__-- > n_a08__) {                        \
-                pvt_clib_free(pvt_dat_to_base_((arr)[siz_a08__])); \
-            }                                                      \
-        }                                                          \
-        (arr)[n_a08__] = NULL;                                     \
-        pvt_set_ttl_siz_((arr), n_a08__ + 1);                      \
+#define cstring_array_resize(arr, n, ptr, count)                    \
+    do {                                                            \
+        const size_t n_a08__ = (size_t)(n);                         \
+        size_t siz_a08__     = cstring_size(arr);                   \
+        if (n_a08__ > siz_a08__) {                                  \
+            if (pvt_ttl_cap_(arr) < n_a08__ + 1) {                  \
+                pvt_grow_amortized_((arr), n_a08__ + 1);            \
+            }                                                       \
+            do {                                                    \
+                pvt_elem_assign_((arr), siz_a08__, (ptr), (count)); \
+            } while (++siz_a08__ < n_a08__);                        \
+        } else {                                                    \
+            while (siz_a08__-- > n_a08__) {                         \
+                pvt_free_((arr)[siz_a08__]);                        \
+            }                                                       \
+        }                                                           \
+        (arr)[n_a08__] = NULL;                                      \
+        pvt_set_ttl_siz_((arr), n_a08__ + 1);                       \
     } while (0)
 
 /**
@@ -1303,16 +1471,11 @@
         if (pvt_ttl_siz_(from) > pos_a09__) {                                                                                      \
             const size_t n_a09__ = (pos_a09__ + (size_t)(n) >= cstring_size(from)) ? cstring_size(from) - pos_a09__ : (size_t)(n); \
             size_t i_a09__       = 0;                                                                                              \
-            if ((to) && pvt_ttl_cap_(to) < n_a09__ + 1) {                                                                          \
-                cstring_free(to);                                                                                                  \
-            }                                                                                                                      \
-            if (!(to)) {                                                                                                           \
-                pvt_grow_((to), n_a09__ + 1);                                                                                      \
-                pvt_set_ttl_siz_((to), 1);                                                                                         \
+            if (!(to) || pvt_ttl_cap_(to) < n_a09__ + 1) {                                                                         \
+                pvt_renew_((to), n_a09__ + 1);                                                                                     \
             }                                                                                                                      \
             for (; i_a09__ < n_a09__; ++i_a09__) {                                                                                 \
-                (to)[i_a09__] = NULL;                                                                                              \
-                cstring_assign((to)[i_a09__], (from)[pos_a09__ + i_a09__], cstring_size((from)[pos_a09__ + i_a09__]));             \
+                pvt_elem_assign_((to), i_a09__, (from)[pos_a09__ + i_a09__], cstring_size((from)[pos_a09__ + i_a09__]));           \
             }                                                                                                                      \
             pvt_set_ttl_siz_((to), n_a09__ + 1);                                                                                   \
             (to)[n_a09__] = NULL;                                                                                                  \
@@ -1344,8 +1507,7 @@
                 strsiz_a10__ += cstring_size((arr)[i_a10__]);                                           \
             }                                                                                           \
             if (strsiz_a10__ > cstring_capacity(ret_str)) {                                             \
-                cstring_free(ret_str);                                                                  \
-                pvt_grow_((ret_str), strsiz_a10__ + 1);                                                 \
+                pvt_renew_((ret_str), strsiz_a10__ + 1);                                                \
             }                                                                                           \
             rssiz_a10__ = elsiz_a10__ = cstring_size((arr)[0]);                                         \
             pvt_clib_memcpy((ret_str), (arr)[0], elsiz_a10__ * sizeof(*(ptr)));                         \
@@ -1365,397 +1527,6102 @@
         }                                                                                               \
     } while (0)
 
-/** @} */
+/**
+ * @brief cstring_array_pack - Convert a cstring_array into a packed vector.
+ * @details The vector and all of its strings are copied back to back into a
+ *          single allocation, and the old vector is released. A packed vector
+ *          is used like any other cstring_array, and its strings are still
+ *          cstrings. Scanning, joining and sorting it is cache-friendly. <br>
+ *          Modifying a string does not affect the layout as long as the string
+ *          fits into its slot. A string that outgrows its slot is moved to the
+ *          heap. Growing the vector itself converts it back into an ordinary
+ *          cstring_array. Erasing strings does not release memory before the
+ *          whole vector is released.
+ * @param arr - The cstring_array. Can be a NULL vector.
+ * @return void
+ */
+#define cstring_array_pack(arr)                                                   \
+    do {                                                                          \
+        if (arr) {                                                                \
+            void *packed_a12__ = pvt_array_pack_((void *)(arr), sizeof(**(arr))); \
+            pvt_clib_assert(packed_a12__);                                        \
+            cstring_array_free(arr);                                              \
+            (arr) = packed_a12__;                                                 \
+        }                                                                         \
+    } while (0)
 
-/* ========================== */
-/* === INTERNAL INTERFACE === */
-/* ========================== */
+/** @} */
 
-/** @cond INTERNAL */
+/* ====================== */
+/* === VIEW INTERFACE === */
+/* ====================== */
 
 /**
- * @defgroup internal_api The private API, for internal use only
+ * @defgroup cstring_view_api The cstring_view API
+ * @details A cstring_view is a non-owning pair of a pointer and a length. It
+ *          can refer to a part of a cstring, a string literal or any other
+ *          buffer of characters, which is not required to be null-terminated.
+ *          Taking a view never allocates or copies. The view is invalidated
+ *          if the referenced memory is modified or released. <br>
+ *          The read-only API of cstring is available for views. The argument
+ *          passed to a `view` parameter is evaluated more than once.
  * @{
  */
 
-#include <limits.h>
-#include <stddef.h>
+/**
+ * @brief cstring_view_type - The view type used in this library.
+ * @details All views declared with the same character type share the members,
+ *          but they are of distinct types. Use the macros of this API to
+ *          update a view.
+ * @param type - The type of characters the view refers to.
+ */
+#define cstring_view_type(type) \
+    struct {                    \
+        const type *data;       \
+        size_t size;            \
+    }
 
-/* in case C library functions need extra protection, allow these defines to be overridden. */
-/* functions for allocation and deallocation need to correspond to each other, fall back to C library functions if not all are overridden */
-#if !defined(pvt_clib_free) || !defined(pvt_clib_malloc) || !defined(pvt_clib_realloc)
-#ifdef pvt_clib_free
-#undef pvt_clib_free
-#endif
-#ifdef pvt_clib_malloc
-#undef pvt_clib_malloc
-#endif
-#ifdef pvt_clib_realloc
-#undef pvt_clib_realloc
-#endif
-#include <stdlib.h>
-#define pvt_clib_free free
-#define pvt_clib_malloc malloc
-#define pvt_clib_realloc realloc
-#endif
-/* functions independent of memory allocation */
-#ifndef pvt_clib_assert
-#include <assert.h>
-#define pvt_clib_assert assert
-#endif
-#ifndef pvt_clib_memcpy
-#include <string.h>
-#define pvt_clib_memcpy memcpy
-#endif
-#ifndef pvt_clib_memmove
-#include <string.h>
-#define pvt_clib_memmove memmove
-#endif
+/**
+ * @brief cstring_view_assign - Let the view refer to a character buffer.
+ * @param view  - The cstring_view.
+ * @param ptr   - Pointer to the first character.
+ * @param count - Number of consecutive characters.
+ * @return void
+ */
+#define cstring_view_assign(view, ptr, count) \
+    do {                                      \
+        (view).data = (ptr);                  \
+        (view).size = (size_t)(count);        \
+    } while (0)
 
 /**
- * @brief pvt_metadata_t - Header type that prefixes a cstring or cstring_array.
+ * @brief cstring_view_literal - Let the view refer to a string literal.
+ * @param view - The cstring_view.
+ * @param lit  - A string literal. The argument passed to this parameter cannot
+ *               be a pointer!
+ * @return void
  */
-typedef struct pvt_metadata_ {
-    size_t size;            /*!< The size incl. terminator. */
-    size_t capacity;        /*!< The capacity incl. space for the string terminator. */
-    void (*unused)(void *); /*!< This maintains binary compatibility with `cvector_metadata_t` of the c-vector library. */
-} pvt_metadata_t;
+#define cstring_view_literal(view, lit) \
+    cstring_view_assign((view), (lit), sizeof(lit) / sizeof(*(lit)) - 1)
 
 /**
- * @brief pvt_dat_to_base_ - For internal use, convert a buffer pointer to a
- *                           metadata pointer.
- * @param dat - The data pointer.
- * @return The metadata pointer of the cstring.
+ * @brief cstring_view_from - Let the view refer to the content of a cstring.
+ * @param view - The cstring_view.
+ * @param str  - The cstring. Can be a NULL string.
+ * @return void
  */
-#define pvt_dat_to_base_(dat) \
-    (((pvt_metadata_t *)(void *)(dat)) - 1)
+#define cstring_view_from(view, str) \
+    cstring_view_assign((view), (str), cstring_size(str))
 
 /**
- * @brief pvt_dat_to_const_base_ - For internal use, convert a buffer pointer to
- *                                 a pointer to constant metadata.
- * @param dat - The data pointer.
- * @return The pointer to constant metadata of the cstring.
+ * @brief cstring_view_substring - Let the view refer to a part of a cstring.
+ * @details This is the zero-copy counterpart of `cstring_substring()`.
+ * @param from     - The cstring. Can be a NULL string.
+ * @param pos      - Position in the cstring where the view begins.
+ * @param n        - Number of consecutive characters. The view ends at the end
+ *                   of the cstring if `n` exceeds it.
+ * @param ret_view - The cstring_view that receives the result. It is empty if
+ *                   `pos` is beyond the end of the cstring.
+ * @return void
  */
-#define pvt_dat_to_const_base_(dat) \
-    (((const pvt_metadata_t *)(const void *)(dat)) - 1)
+#define cstring_view_substring(from, pos, n, ret_view) \
+    pvt_view_sub_((from), cstring_size(from), (pos), (n), (ret_view))
 
 /**
- * @brief pvt_ttl_cap_ - For internal use, get the current capacity of the
- *                       buffer incl. terminator.
- * @param dat - The data pointer.
- * @return The capacity as a `size_t`.
+ * @brief cstring_view_subview - Let a view refer to a part of another view.
+ * @param from     - The source cstring_view.
+ * @param pos      - Position in the source view where the view begins.
+ * @param n        - Number of consecutive characters. The view ends at the end
+ *                   of the source view if `n` exceeds it.
+ * @param ret_view - The cstring_view that receives the result. It is empty if
+ *                   `pos` is beyond the end of the source view.
+ * @return void
  */
-#define pvt_ttl_cap_(dat) \
-    ((dat) ? pvt_dat_to_const_base_(dat)->capacity : (size_t)0)
+#define cstring_view_subview(from, pos, n, ret_view) \
+    pvt_view_sub_((from).data, (from).size, (pos), (n), (ret_view))
 
 /**
- * @brief pvt_ttl_siz_ - For internal use, get the current size of the buffer
- *                       incl. terminator.
- * @param dat - The data pointer.
- * @return The size as a `size_t`.
+ * @brief cstring_view_data - Get the pointer to the first character.
+ * @param view - The cstring_view.
+ * @return The pointer. Can be NULL for an empty view.
  */
-#define pvt_ttl_siz_(dat) \
-    ((dat) ? pvt_dat_to_const_base_(dat)->size : (size_t)0)
+#define cstring_view_data(view) \
+    ((view).data)
 
 /**
- * @brief pvt_set_ttl_siz_ - For internal use, set the size member of the
- *                           metadata.
- * @param dat - The data pointer.
- * @param siz - The new size to set.
- * @return void
+ * @brief cstring_view_size - Get the number of characters in the view.
+ * @param view - The cstring_view.
+ * @return The size as a `size_t`.
  */
-#define pvt_set_ttl_siz_(dat, siz)           \
-    do {                                     \
-        pvt_dat_to_base_(dat)->size = (siz); \
-    } while (0)
+#define cstring_view_size(view) \
+    ((view).size)
 
 /**
- * @brief pvt_grow_ - For internal use, ensure that the buffer is at least
- *                    `count` elements big.
- * @param dat   - The data pointer.
- * @param count - The new capacity to set.
- * @return void
+ * @brief cstring_view_empty - Check whether the view is empty.
+ * @param view - The cstring_view.
+ * @return Non-zero if the view is empty, 0 otherwise.
  */
-#define pvt_grow_(dat, count)                                                               \
-    do {                                                                                    \
-        pvt_metadata_t *base_p00__;                                                         \
-        const size_t siz_p00__ = (size_t)(count) * sizeof(*(dat)) + sizeof(pvt_metadata_t); \
-        if (dat) {                                                                          \
-            base_p00__ = pvt_clib_realloc(pvt_dat_to_base_(dat), siz_p00__);                \
-            pvt_clib_assert(base_p00__);                                                    \
-        } else {                                                                            \
-            base_p00__ = pvt_clib_malloc(siz_p00__);                                        \
-            pvt_clib_assert(base_p00__);                                                    \
-            base_p00__->unused = NULL;                                                      \
-        }                                                                                   \
-        base_p00__->capacity = (size_t)(count);                                             \
-        (dat)                = (void *)(base_p00__ + 1);                                    \
-    } while (0)
+#define cstring_view_empty(view) \
+    ((view).size == 0)
 
 /**
- * @brief pvt_str_n_eq_ - For internal use, check the equality of two string
- *                        sequences.
- * @param s1     - Pointer to the first string sequence.
- * @param s2     - Pointer to the second string sequence.
- * @param n      - The number of characters to compare.
- * @param ret_eq - Variable of type `int` that is set either to 1 if the
- *                 sequences are equal, or to 0 otherwise.
+ * @brief cstring_view_to_cstring - Copy the characters of the view into a
+ *                                  cstring.
+ * @param view - The cstring_view.
+ * @param to   - The cstring. Can be a NULL string. <br>
+ *               If `to` refers to an existing cstring, the old content is
+ *               overwritten.
  * @return void
  */
-#define pvt_str_n_eq_(s1, s2, n, ret_eq)                                        \
-    do {                                                                        \
-        ptrdiff_t i_p01__ = (ptrdiff_t)(n) - (ptrdiff_t)1;                      \
-        while (((ret_eq) = ((s1)[i_p01__] == (s2)[i_p01__])) && --i_p01__ >= 0) \
-            ;                                                                   \
+#define cstring_view_to_cstring(view, to)                   \
+    do {                                                    \
+        if ((view).size) {                                  \
+            cstring_assign((to), (view).data, (view).size); \
+        } else if (to) {                                    \
+            cstring_clear(to);                              \
+        } else {                                            \
+            cstring_reserve((to), 0);                       \
+        }                                                   \
     } while (0)
 
 /**
- * @brief pvt_make_find_sub_hash_ - For internal use, pre-calculate the hash
- *                                  used for pvt_find_.
- * @param ptr      - Pointer to the first character of the string to search for.
- * @param count    - Length of the string to search for.
- * @param ret_hash - Pre-calculated hash of the string to search for.
+ * @brief cstring_view_find - Find the first occurrence of the given substring.
+ * @details See `cstring_find()`.
+ * @param view       - The cstring_view.
+ * @param pos        - Position at which to start the search.
+ * @param ptr        - Pointer to the first character of the string to search
+ *                     for.
+ * @param count      - Length of the string to search for.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the found substring or -1.
  * @return void
  */
-#define pvt_make_find_sub_hash_(ptr, count, ret_hash)                                  \
-    do {                                                                               \
-        static const size_t tpmsk_p02__ = pvt_get_typemask_(ptr);                      \
-        ptrdiff_t off_p02__             = 0;                                           \
-        for (; off_p02__ < (ptrdiff_t)(count); ++off_p02__) {                          \
-            (ret_hash) = ((ret_hash) << 1) + ((size_t)(ptr)[off_p02__] & tpmsk_p02__); \
-        }                                                                              \
-    } while (0)
+#define cstring_view_find(view, pos, ptr, count, ret_offset) \
+    pvt_find_sub_((view).data, (view).size, (pos), (ptr), (count), (ret_offset))
 
 /**
- * @brief pvt_find_ - For internal use, find the first occurrence of the given
- *                    substring.
- * @param str        - The cstring.
- * @param pos        - Position at which to start the search, i.e. the found
- *                     substring must not begin in a position preceding `pos`.
- *                     Zero means that the whole `str` is searched.
+ * @brief cstring_view_rfind - Find the last occurrence of the given substring.
+ * @details See `cstring_rfind()`.
+ * @param view       - The cstring_view.
+ * @param pos        - Position at which to start the search, proceeded from
+ *                     right to left. -1 means that the whole view is searched.
  * @param ptr        - Pointer to the first character of the string to search
  *                     for.
  * @param count      - Length of the string to search for.
- * @param sub_hs     - Pre-calculated hash of the string to search for.
  * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
- *                     of the first character of the found substring or -1 if no
- *                     such substring is found.
+ *                     of the found substring or -1.
  * @return void
  */
-#define pvt_find_(str, pos, ptr, count, sub_hs, ret_offset)                                                          \
-    do {                                                                                                             \
-        const void *const chk_p03__ = (const void *)(ptr);                                                           \
-        const ptrdiff_t cnt_p03__ = (ptrdiff_t)(count), siz_p03__ = (ptrdiff_t)cstring_size(str) - (ptrdiff_t)(pos); \
-        if (!chk_p03__ || (ptrdiff_t)(pos) < 0 || cnt_p03__ > siz_p03__ || siz_p03__ <= 0 || cnt_p03__ <= 0) {       \
-            (ret_offset) = (ptrdiff_t)-1;                                                                            \
-        } else if (cnt_p03__ == siz_p03__) {                                                                         \
-            int eq_p03__;                                                                                            \
-            pvt_str_n_eq_((str) + (ptrdiff_t)(pos), (ptr), cnt_p03__, eq_p03__);                                     \
-            (ret_offset) = eq_p03__ ? (ptrdiff_t)(pos) : (ptrdiff_t)-1;                                              \
-        } else if (cnt_p03__ == 1) {                                                                                 \
-            pvt_find_first_char_(0, (str), (pos), (ptr), (ret_offset));                                              \
-        } else {                                                                                                     \
-            ptrdiff_t off_p03__;                                                                                     \
-            const ptrdiff_t end_p03__ = cnt_p03__ - 1, diff_p03__ = (ptrdiff_t)cstring_size(str) - cnt_p03__;        \
-            size_t strhs_p03__ = 0, hash_factor__ = 1;                                                               \
-            static const size_t tpmsk_p03__ = pvt_get_typemask_(str);                                                \
-            (ret_offset)                    = (ptrdiff_t)-1;                                                         \
-            for (off_p03__ = 0; off_p03__ < end_p03__; ++off_p03__) {                                                \
-                strhs_p03__ = (strhs_p03__ << 1) + ((size_t)(str)[off_p03__ + (ptrdiff_t)(pos)] & tpmsk_p03__);      \
-                hash_factor__ <<= 1;                                                                                 \
-            }                                                                                                        \
-            strhs_p03__ = (strhs_p03__ << 1) + ((size_t)(str)[off_p03__ + (ptrdiff_t)(pos)] & tpmsk_p03__);          \
-            off_p03__   = (ptrdiff_t)(pos);                                                                          \
-            do {                                                                                                     \
-                if ((sub_hs) == strhs_p03__) {                                                                       \
-                    int eq_p03__;                                                                                    \
-                    pvt_str_n_eq_((str) + off_p03__, (ptr), cnt_p03__, eq_p03__);                                    \
-                    if (eq_p03__) {                                                                                  \
-                        (ret_offset) = off_p03__;                                                                    \
-                        break;                                                                                       \
-                    }                                                                                                \
-                }                                                                                                    \
-                strhs_p03__ =                                                                                        \
-                    ((strhs_p03__ - hash_factor__ * ((size_t)(str)[off_p03__] & tpmsk_p03__)) << 1) +                \
-                    ((size_t)(str)[off_p03__ + cnt_p03__] & tpmsk_p03__);                                            \
-            } while (off_p03__++ < diff_p03__);                                                                      \
-        }                                                                                                            \
-    } while (0)
+#define cstring_view_rfind(view, pos, ptr, count, ret_offset) \
+    pvt_rfind_((view).data, (view).size, (pos), (ptr), (count), (ret_offset))
 
 /**
- * @brief pvt_find_first_char_ - For internal use, find the first character
- *                               equal or not equal (depending on `not_eq`) to
- *                               the character pointed to by `pchar`.
- * @param not_eq     - 0 to find the first occurrence that equals the character,
- *                     1 to find the first occurrence that does not equal the
- *                     character
- * @param str        - The cstring.
- * @param pos        - Position at which to begin searching.
- * @param pchar      - Pointer to the character to search for.
- * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
- *                     of the found character or -1 if no such character is
- *                     found.
+ * @brief cstring_view_find_all - Find all occurrences of the given substring.
+ * @details See `cstring_find_all()`.
+ * @param view        - The cstring_view.
+ * @param ptr         - Pointer to the first character of the string to search
+ *                      for.
+ * @param count       - Length of the string to search for.
+ * @param overlap     - Nonzero to include overlapping occurrences.
+ * @param ret_offsets - Variable of type `ptrdiff_t *` that receives the vector
+ *                      of positions.
  * @return void
  */
-#define pvt_find_first_char_(not_eq, str, pos, pchar, ret_offset)                       \
-    do {                                                                                \
-        const ptrdiff_t siz_p04__ = (ptrdiff_t)cstring_size(str);                       \
-        for ((ret_offset) = (ptrdiff_t)(pos);                                           \
-             (ret_offset) < siz_p04__ && ((str)[(ret_offset)] == *(pchar)) == (not_eq); \
-             ++(ret_offset))                                                            \
-            ;                                                                           \
-        if ((ret_offset) == siz_p04__) {                                                \
-            (ret_offset) = (ptrdiff_t)-1;                                               \
-        }                                                                               \
-    } while (0)
+#define cstring_view_find_all(view, ptr, count, overlap, ret_offsets) \
+    pvt_find_all_sub_((view).data, (view).size, (ptr), (count), (overlap), (ret_offsets))
 
 /**
- * @brief pvt_find_last_char_ - For internal use, find the last character equal
- *                              or not equal (depending on `not_eq`) to the
- *                              character pointed to by `pchar`.
- * @param not_eq     - 0 to find the first occurrence that equals the character,
- *                     1 to find the first occurrence that does not equal the
- *                     character
- * @param str        - The cstring.
+ * @brief cstring_view_count - Count the occurrences of the given substring.
+ * @details See `cstring_count()`.
+ * @param view      - The cstring_view.
+ * @param ptr       - Pointer to the first character of the string to search
+ *                    for.
+ * @param count     - Length of the string to search for.
+ * @param overlap   - Nonzero to count overlapping occurrences.
+ * @param ret_count - Variable of type `size_t` that receives the number of
+ *                    occurrences.
+ * @return void
+ */
+#define cstring_view_count(view, ptr, count, overlap, ret_count) \
+    pvt_count_sub_((view).data, (view).size, (ptr), (count), (overlap), (ret_count))
+
+/**
+ * @brief cstring_view_find_first_of - Find the first character equal to one of
+ *                                     the characters in the given sequence.
+ * @details See `cstring_find_first_of()`.
+ * @param view       - The cstring_view.
  * @param pos        - Position at which to begin searching.
- * @param pchar      - Pointer to the character to search for.
+ * @param ptr        - Pointer to the first character of the character set.
+ * @param count      - Length of the character set.
  * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
- *                     of the found character or -1 if no such character is
- *                     found.
+ *                     of the found character or -1.
+ * @return void
+ */
+#define cstring_view_find_first_of(view, pos, ptr, count, ret_offset) \
+    pvt_find_first_of_(0, (view).data, (view).size, (pos), (ptr), (count), (ret_offset))
+
+/**
+ * @brief cstring_view_find_first_not_of - Find the first character equal to
+ *                                         none of the characters in the given
+ *                                         sequence.
+ * @details See `cstring_find_first_not_of()`.
+ * @param view       - The cstring_view.
+ * @param pos        - Position at which to begin searching.
+ * @param ptr        - Pointer to the first character of the character set.
+ * @param count      - Length of the character set.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the found character or -1.
+ * @return void
+ */
+#define cstring_view_find_first_not_of(view, pos, ptr, count, ret_offset) \
+    pvt_find_first_of_(1, (view).data, (view).size, (pos), (ptr), (count), (ret_offset))
+
+/**
+ * @brief cstring_view_find_last_of - Find the last character equal to one of
+ *                                    the characters in the given sequence.
+ * @details See `cstring_find_last_of()`.
+ * @param view       - The cstring_view.
+ * @param pos        - Position at which to begin searching. -1 means that the
+ *                     whole view is searched.
+ * @param ptr        - Pointer to the first character of the character set.
+ * @param count      - Length of the character set.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the found character or -1.
+ * @return void
+ */
+#define cstring_view_find_last_of(view, pos, ptr, count, ret_offset) \
+    pvt_find_last_of_(0, (view).data, (view).size, (pos), (ptr), (count), (ret_offset))
+
+/**
+ * @brief cstring_view_find_last_not_of - Find the last character equal to none
+ *                                        of the characters in the given
+ *                                        sequence.
+ * @details See `cstring_find_last_not_of()`.
+ * @param view       - The cstring_view.
+ * @param pos        - Position at which to begin searching. -1 means that the
+ *                     whole view is searched.
+ * @param ptr        - Pointer to the first character of the character set.
+ * @param count      - Length of the character set.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the found character or -1.
+ * @return void
+ */
+#define cstring_view_find_last_not_of(view, pos, ptr, count, ret_offset) \
+    pvt_find_last_of_(1, (view).data, (view).size, (pos), (ptr), (count), (ret_offset))
+
+/**
+ * @brief cstring_view_compare - Lexicographically compare two views.
+ * @details A view of a cstring can be compared with any other view.
+ * @param view1     - The first cstring_view.
+ * @param view2     - The second cstring_view.
+ * @param ret_order - Variable of type `int` that receives the result of the
+ *                    comparison. <br>
+ *                     -1 if `view1` appears before `view2` <br>
+ *                      0 if both views compare equivalent <br>
+ *                      1 if `view1` appears after `view2`
+ * @return void
+ */
+#define cstring_view_compare(view1, view2, ret_order) \
+    pvt_compare_((view1).data, (view1).size, (view2).data, (view2).size, (ret_order))
+
+/**
+ * @brief cstring_view_equal - Check the equality of two views.
+ * @param view1     - The first cstring_view.
+ * @param view2     - The second cstring_view.
+ * @param ret_equal - Variable of type `int` that receives 1 if the views are
+ *                    equal, 0 otherwise.
+ * @return void
+ */
+#define cstring_view_equal(view1, view2, ret_equal) \
+    pvt_equal_((view1).data, (view1).size, (view2).data, (view2).size, (ret_equal))
+
+/**
+ * @brief cstring_view_mismatch - Find the first position at which two views
+ *                                differ.
+ * @param view1      - The first cstring_view.
+ * @param view2      - The second cstring_view.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the first differing character, or -1 if the views are
+ *                     equal. If one view is a prefix of the other, it receives
+ *                     the length of the shorter view.
+ * @return void
+ */
+#define cstring_view_mismatch(view1, view2, ret_offset) \
+    pvt_mismatch_((view1).data, (view1).size, (view2).data, (view2).size, (ret_offset))
+
+/**
+ * @brief cstring_view_starts_with - Check if the view begins with the given
+ *                                   prefix.
+ * @param view      - The cstring_view.
+ * @param ptr       - Pointer to the first character of the prefix.
+ * @param count     - Length of the prefix.
+ * @param ret_found - Variable of type `int` that receives 0 or 1.
+ * @return void
+ */
+#define cstring_view_starts_with(view, ptr, count, ret_found) \
+    pvt_starts_with_((view).data, (view).size, (ptr), (count), (ret_found))
+
+/**
+ * @brief cstring_view_ends_with - Check if the view ends with the given suffix.
+ * @param view      - The cstring_view.
+ * @param ptr       - Pointer to the first character of the suffix.
+ * @param count     - Length of the suffix.
+ * @param ret_found - Variable of type `int` that receives 0 or 1.
+ * @return void
+ */
+#define cstring_view_ends_with(view, ptr, count, ret_found) \
+    pvt_ends_with_((view).data, (view).size, (ptr), (count), (ret_found))
+
+/**
+ * @brief cstring_view_contains - Check if the view contains the given
+ *                                substring.
+ * @param view      - The cstring_view.
+ * @param ptr       - Pointer to the first character of the substring.
+ * @param count     - Length of the substring.
+ * @param ret_found - Variable of type `int` that receives 0 or 1.
+ * @return void
+ */
+#define cstring_view_contains(view, ptr, count, ret_found) \
+    pvt_contains_((view).data, (view).size, (ptr), (count), (ret_found))
+
+/**
+ * @brief cstring_view_split - Tokenize a view into a cstring_array vector.
+ * @details See `cstring_split()`.
+ * @param view      - The cstring_view.
+ * @param max_tok   - Maximum number of tokens to be created. -1 specifies that
+ *                    all tokens are created.
+ * @param ptr       - Pointer to the first character of the delimiter string.
+ * @param count     - Number of consecutive characters to be used as delimiter.
+ * @param ret_array - Variable of cstring_array(type) that receives the created
+ *                    vector. Can be a NULL vector.
+ * @return void
+ */
+#define cstring_view_split(view, max_tok, ptr, count, ret_array) \
+    pvt_split_((view).data, (view).size, (max_tok), (ptr), (count), (ret_array))
+
+/* ----------------- */
+/* --- tokenizer --- */
+
+/**
+ * @brief cstring_tokenizer_type - The type of a lazy tokenizer.
+ * @details Other than `cstring_split()`, a tokenizer allocates nothing. It
+ *          yields one token at a time, either as offset and length or as a
+ *          cstring_view, and the search for a delimiter is only performed when
+ *          the next token is requested. The tokenizer refers to the string it
+ *          was initialized with, and it is invalidated if that string is
+ *          modified or released.
+ * @param type - The character type of the tokenized string.
+ */
+#define cstring_tokenizer_type(type) \
+    struct {                         \
+        const type *data;            \
+        size_t size;                 \
+        const type *delim;           \
+        ptrdiff_t delim_size;        \
+        pvt_twoway_t crit;           \
+        ptrdiff_t pos;               \
+        size_t remaining;            \
+    }
+
+/**
+ * @brief cstring_tokenizer_init - Initialize a tokenizer for a cstring.
+ * @param tok     - The tokenizer.
+ * @param str     - The cstring.
+ * @param max_tok - Maximum number of tokens to be yielded. -1 specifies that
+ *                  all tokens are yielded.
+ * @param ptr     - Pointer to the first character of the delimiter string that
+ *                  separates the tokens in `str`. It must stay valid while the
+ *                  tokenizer is in use.
+ * @param count   - Number of consecutive characters to be used as delimiter.
+ * @return void
+ */
+#define cstring_tokenizer_init(tok, str, max_tok, ptr, count) \
+    pvt_tokenizer_init_((tok), (str), cstring_size(str), (max_tok), (ptr), (count))
+
+/**
+ * @brief cstring_view_tokenizer_init - Initialize a tokenizer for a view.
+ * @param tok     - The tokenizer.
+ * @param view    - The cstring_view.
+ * @param max_tok - Maximum number of tokens to be yielded. -1 specifies that
+ *                  all tokens are yielded.
+ * @param ptr     - Pointer to the first character of the delimiter string that
+ *                  separates the tokens in `view`. It must stay valid while the
+ *                  tokenizer is in use.
+ * @param count   - Number of consecutive characters to be used as delimiter.
+ * @return void
+ */
+#define cstring_view_tokenizer_init(tok, view, max_tok, ptr, count) \
+    pvt_tokenizer_init_((tok), (view).data, (view).size, (max_tok), (ptr), (count))
+
+/**
+ * @brief cstring_tokenizer_next - Get the next token.
+ * @details The tokens are the same as those created by `cstring_split()`.
+ * @param tok        - The tokenizer.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position of
+ *                     the token, or -1 if all tokens have been yielded.
+ * @param ret_count  - Variable of type `size_t` that receives the length of the
+ *                     token.
  * @return void
  */
-#define pvt_find_last_char_(not_eq, str, pos, pchar, ret_offset)                            \
-    do {                                                                                    \
-        for ((ret_offset) = (ptrdiff_t)(pos);                                               \
-             (ret_offset) > (ptrdiff_t)-1 && ((str)[(ret_offset)] == *(pchar)) == (not_eq); \
-             --(ret_offset))                                                                \
-            ;                                                                               \
+#define cstring_tokenizer_next(tok, ret_offset, ret_count)                                                          \
+    do {                                                                                                            \
+        ptrdiff_t off_v00__ = (ptrdiff_t)-1;                                                                        \
+        (ret_offset)        = (tok).pos;                                                                            \
+        (ret_count)         = 0;                                                                                    \
+        if ((tok).pos >= 0) {                                                                                       \
+            if ((tok).remaining) {                                                                                  \
+                pvt_find_((tok).data, (tok).size, (tok).pos, (tok).delim, (tok).delim_size, (tok).crit, off_v00__); \
+            }                                                                                                       \
+            if (off_v00__ == -1) {                                                                                  \
+                (ret_count) = (tok).size - (size_t)(tok).pos;                                                       \
+                (tok).pos   = (ptrdiff_t)-1;                                                                        \
+            } else {                                                                                                \
+                (ret_count) = (size_t)(off_v00__ - (tok).pos);                                                      \
+                (tok).pos   = off_v00__ + (tok).delim_size;                                                         \
+                --(tok).remaining;                                                                                  \
+            }                                                                                                       \
+        }                                                                                                           \
     } while (0)
 
 /**
- * @brief pvt_get_typemask_ - For internal use, calculate the bit mask with all
- *                            bits of the size of the referenced character set.
- * @details The value is considered a constant expression, calculated at compile
- *          time. The receiving variables are declared as `static const` to make
- *          this clear to the compiler.
- * @param ptr - Pointer to a character.
- * @return The calculated bit mask as value of type `size_t`.
+ * @brief cstring_tokenizer_next_view - Get the next token as a view.
+ * @param tok      - The tokenizer.
+ * @param ret_view - The cstring_view that receives the token. Its data pointer
+ *                   is NULL if all tokens have been yielded.
+ * @return void
  */
-#define pvt_get_typemask_(ptr) \
-    ((sizeof(size_t) <= sizeof(*(ptr))) ? (size_t)-1 : (((size_t)1 << (sizeof(*(ptr)) * CHAR_BIT)) - 1))
+#define cstring_tokenizer_next_view(tok, ret_view)                           \
+    do {                                                                     \
+        ptrdiff_t off_v01__;                                                 \
+        size_t cnt_v01__;                                                    \
+        cstring_tokenizer_next((tok), off_v01__, cnt_v01__);                 \
+        (ret_view).data = (off_v01__ == -1) ? NULL : (tok).data + off_v01__; \
+        (ret_view).size = cnt_v01__;                                         \
+    } while (0)
+
+/* ---------------- */
+/* --- searcher --- */
 
 /**
- * @brief pvt_make_charmask_ - For internal use, create a bit mask that helps to
- *                             avoid the complexity of pvt_find_first_of_ and
- *                             pvt_find_last_of_ being always O(n*m).
- * @param ptr    - Pointer to the first character of the character sequence.
- * @param count  - Length of the character sequence.
- * @param chmask - Variable of type `size_t` that receives the created bit mask.
+ * @brief cstring_searcher_type - The type of a precompiled searcher.
+ * @details A searcher analyzes the string to search for once, and it can then
+ *          be used to search any number of cstrings or views without setup
+ *          cost. It refers to the string it was initialized with.
+ * @param type - The character type of the string to search for.
+ */
+#define cstring_searcher_type(type) \
+    struct {                        \
+        const type *needle;         \
+        ptrdiff_t size;             \
+        pvt_twoway_t crit;          \
+        pvt_twoway_t rcrit;         \
+    }
+
+/**
+ * @brief cstring_searcher_init - Initialize a searcher.
+ * @param srch  - The searcher.
+ * @param ptr   - Pointer to the first character of the string to search for.
+ *                It must stay valid while the searcher is in use.
+ * @param count - Length of the string to search for.
  * @return void
  */
-#define pvt_make_charmask_(ptr, count, chmask)                    \
-    do {                                                          \
-        static const size_t tpmsk_p05__ = pvt_get_typemask_(ptr); \
-        ptrdiff_t i_p05__               = 0;                      \
-        (chmask)                        = 0;                      \
-        while (i_p05__ < (count)) {                               \
-            (chmask) |= (size_t)(ptr)[i_p05__++];                 \
-        }                                                         \
-        (chmask) = (~(chmask)) & tpmsk_p05__;                     \
+#define cstring_searcher_init(srch, ptr, count)                                 \
+    do {                                                                        \
+        (srch).needle = (ptr);                                                  \
+        (srch).size   = (ptrdiff_t)(count);                                     \
+        if ((srch).needle && (srch).size > 0) {                                 \
+            pvt_make_find_sub_crit_((srch).needle, (srch).size, (srch).crit);   \
+            pvt_make_rfind_sub_crit_((srch).needle, (srch).size, (srch).rcrit); \
+        } else {                                                                \
+            (srch).needle = NULL;                                               \
+        }                                                                       \
     } while (0)
 
 /**
- * @brief pvt_find_first_of_ - For internal use, find the first character equal
- *                             to one or none (depending on `not_of`) of the
- *                             characters in the given character sequence.
- * @param not_of     - 0 for find_first_of behavior, 1 for find_first_not_of
- *                     behavior.
+ * @brief cstring_searcher_find - Find the first occurrence in a cstring.
+ * @param srch       - The searcher.
  * @param str        - The cstring.
- * @param pos        - Position at which to begin searching.
- * @param ptr        - Pointer to the first character of the string identifying
- *                     characters to search for.
- * @param count      - Length of the string of characters to search for.
+ * @param pos        - Position at which to start the search.
  * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
- *                     of the first found character or -1 if no such character
- *                     is found.
+ *                     of the found substring or -1.
+ * @return void
+ */
+#define cstring_searcher_find(srch, str, pos, ret_offset) \
+    pvt_find_((str), cstring_size(str), (pos), (srch).needle, (srch).size, (srch).crit, (ret_offset))
+
+/**
+ * @brief cstring_searcher_rfind - Find the last occurrence in a cstring.
+ * @param srch       - The searcher.
+ * @param str        - The cstring.
+ * @param pos        - Position at which to start the search, proceeded from
+ *                     right to left. -1 means that the whole string is
+ *                     searched.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the found substring or -1.
+ * @return void
+ */
+#define cstring_searcher_rfind(srch, str, pos, ret_offset) \
+    pvt_rfind_crit_((str), cstring_size(str), (pos), (srch).needle, (srch).size, (srch).rcrit, (ret_offset))
+
+/**
+ * @brief cstring_searcher_count - Count the non-overlapping occurrences in a
+ *                                 cstring.
+ * @param srch      - The searcher.
+ * @param str       - The cstring.
+ * @param ret_count - Variable of type `size_t` that receives the number of
+ *                    occurrences.
+ * @return void
+ */
+#define cstring_searcher_count(srch, str, ret_count) \
+    pvt_count_((str), cstring_size(str), (srch).needle, (srch).size, (srch).crit, 0, (ret_count))
+
+/**
+ * @brief cstring_searcher_find_all - Find all occurrences in a cstring.
+ * @details See `cstring_find_all()`.
+ * @param srch        - The searcher.
+ * @param str         - The cstring.
+ * @param overlap     - Nonzero to include overlapping occurrences.
+ * @param ret_offsets - Variable of type `ptrdiff_t *` that receives the vector
+ *                      of positions.
+ * @return void
+ */
+#define cstring_searcher_find_all(srch, str, overlap, ret_offsets) \
+    pvt_find_all_((str), cstring_size(str), (srch).needle, (srch).size, (srch).crit, (overlap), (ret_offsets))
+
+/**
+ * @brief cstring_searcher_split - Tokenize a cstring into a cstring_array
+ *                                 vector, using the string of the searcher as
+ *                                 delimiter.
+ * @param srch      - The searcher.
+ * @param str       - The cstring.
+ * @param max_tok   - Maximum number of tokens to be created. -1 specifies that
+ *                    all tokens are created.
+ * @param ret_array - Variable of cstring_array(type) that receives the created
+ *                    vector. Can be a NULL vector. <br>
+ *                    If `ret_array` refers to an existing vector, the old
+ *                    content is overwritten.
+ * @return void
+ */
+#define cstring_searcher_split(srch, str, max_tok, ret_array) \
+    pvt_split_crit_((str), cstring_size(str), (max_tok), (srch).needle, (srch).size, (srch).crit, (ret_array))
+
+/**
+ * @brief cstring_view_searcher_find - Find the first occurrence in a view.
+ * @param srch       - The searcher.
+ * @param view       - The cstring_view.
+ * @param pos        - Position at which to start the search.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the found substring or -1.
+ * @return void
+ */
+#define cstring_view_searcher_find(srch, view, pos, ret_offset) \
+    pvt_find_((view).data, (view).size, (pos), (srch).needle, (srch).size, (srch).crit, (ret_offset))
+
+/**
+ * @brief cstring_view_searcher_rfind - Find the last occurrence in a view.
+ * @param srch       - The searcher.
+ * @param view       - The cstring_view.
+ * @param pos        - Position at which to start the search, proceeded from
+ *                     right to left. -1 means that the whole view is searched.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the found substring or -1.
+ * @return void
+ */
+#define cstring_view_searcher_rfind(srch, view, pos, ret_offset) \
+    pvt_rfind_crit_((view).data, (view).size, (pos), (srch).needle, (srch).size, (srch).rcrit, (ret_offset))
+
+/**
+ * @brief cstring_view_searcher_count - Count the non-overlapping occurrences in
+ *                                      a view.
+ * @param srch      - The searcher.
+ * @param view      - The cstring_view.
+ * @param ret_count - Variable of type `size_t` that receives the number of
+ *                    occurrences.
+ * @return void
+ */
+#define cstring_view_searcher_count(srch, view, ret_count) \
+    pvt_count_((view).data, (view).size, (srch).needle, (srch).size, (srch).crit, 0, (ret_count))
+
+/**
+ * @brief cstring_view_searcher_find_all - Find all occurrences in a view.
+ * @details See `cstring_find_all()`.
+ * @param srch        - The searcher.
+ * @param view        - The cstring_view.
+ * @param overlap     - Nonzero to include overlapping occurrences.
+ * @param ret_offsets - Variable of type `ptrdiff_t *` that receives the vector
+ *                      of positions.
+ * @return void
+ */
+#define cstring_view_searcher_find_all(srch, view, overlap, ret_offsets) \
+    pvt_find_all_((view).data, (view).size, (srch).needle, (srch).size, (srch).crit, (overlap), (ret_offsets))
+
+/**
+ * @brief cstring_view_searcher_split - Tokenize a view into a cstring_array
+ *                                      vector, using the string of the
+ *                                      searcher as delimiter.
+ * @param srch      - The searcher.
+ * @param view      - The cstring_view.
+ * @param max_tok   - Maximum number of tokens to be created. -1 specifies that
+ *                    all tokens are created.
+ * @param ret_array - Variable of cstring_array(type) that receives the created
+ *                    vector. Can be a NULL vector. <br>
+ *                    If `ret_array` refers to an existing vector, the old
+ *                    content is overwritten.
+ * @return void
+ */
+#define cstring_view_searcher_split(srch, view, max_tok, ret_array) \
+    pvt_split_crit_((view).data, (view).size, (max_tok), (srch).needle, (srch).size, (srch).crit, (ret_array))
+
+/** @} */
+
+/* ============================= */
+/* === MULTI-PATTERN MATCHER === */
+/* ============================= */
+
+/**
+ * @defgroup cstring_matcher_api The cstring multi-pattern matcher
+ * @details An Aho-Corasick automaton compiled from a cstring_array of
+ *          patterns. It finds the occurrences of all patterns in a single pass
+ *          over a cstring or view, regardless of the number of patterns. The
+ *          automaton works on the bytes of the characters. Bytes that don't
+ *          occur in any pattern share one column of the transition table,
+ *          which keeps the table compact. A matcher is immutable once it is
+ *          built and can be used by several threads at the same time.
+ * @{
+ */
+
+/**
+ * @brief cstring_matcher_type - The type of a multi-pattern matcher.
+ */
+#define cstring_matcher_type \
+    pvt_matcher_t *
+
+/**
+ * @brief cstring_matcher_build - Compile a matcher from a cstring_array of
+ *                                patterns.
+ * @details Empty patterns are ignored. The ID of a pattern is its position in
+ *          `arr`. If the same pattern is contained more than once, the lowest
+ *          ID is reported.
+ * @param arr         - The cstring_array of patterns. The character type
+ *                      determines the type of the strings to be searched.
+ * @param ret_matcher - Variable of cstring_matcher_type that receives the
+ *                      matcher. If it refers to an existing matcher, that one
+ *                      is released.
  * @return void
  */
-#define pvt_find_first_of_(not_of, str, pos, ptr, count, ret_offset)                                 \
-    do {                                                                                             \
-        const void *const chk_p06__ = (const void *)(ptr);                                           \
-        const ptrdiff_t cnt_p06__ = (ptrdiff_t)(count), siz_p06__ = (ptrdiff_t)cstring_size(str);    \
-        if (!chk_p06__ || (ptrdiff_t)(pos) < 0 || siz_p06__ <= (ptrdiff_t)(pos) || cnt_p06__ <= 0) { \
-            (ret_offset) = (ptrdiff_t)-1;                                                            \
-        } else if (cnt_p06__ == 1) {                                                                 \
-            pvt_find_first_char_((not_of), (str), (pos), (ptr), (ret_offset));                       \
-        } else {                                                                                     \
-            size_t chmsk_p06__;                                                                      \
-            ptrdiff_t suboff_p06__;                                                                  \
-            ptrdiff_t stroff_p06__ = (ptrdiff_t)(pos);                                               \
-            pvt_make_charmask_((ptr), cnt_p06__, chmsk_p06__);                                       \
-            for (; stroff_p06__ < siz_p06__; ++stroff_p06__) {                                       \
-                if ((size_t)(str)[stroff_p06__] & chmsk_p06__) {                                     \
-                    continue;                                                                        \
-                }                                                                                    \
-                for (suboff_p06__ = 0;                                                               \
-                     suboff_p06__ < cnt_p06__ && (str)[stroff_p06__] != (ptr)[suboff_p06__];         \
-                     ++suboff_p06__)                                                                 \
-                    ;                                                                                \
-                if ((suboff_p06__ == cnt_p06__) == (not_of)) {                                       \
-                    break;                                                                           \
-                }                                                                                    \
-            }                                                                                        \
-            (ret_offset) = (stroff_p06__ == siz_p06__) ? (ptrdiff_t)-1 : stroff_p06__;               \
-        }                                                                                            \
+#define cstring_matcher_build(arr, ret_matcher)                                                             \
+    do {                                                                                                    \
+        pvt_matcher_free_(ret_matcher);                                                                     \
+        (ret_matcher) = pvt_matcher_build_((void *const *)(arr), cstring_array_size(arr), sizeof(**(arr))); \
+        pvt_clib_assert(ret_matcher);                                                                       \
     } while (0)
 
 /**
- * @brief pvt_find_last_of_ - For internal use, find the last character equal to
- *                            one or none (depending on `not_of`) of the
- *                            characters in the given character sequence.
- * @param not_of     - 0 for find_last_of behavior, 1 for find_last_not_of
- *                     behavior.
+ * @brief cstring_matcher_free - Release a matcher and set it to NULL.
+ * @param matcher - The matcher. Can be NULL.
+ * @return void
+ */
+#define cstring_matcher_free(matcher) \
+    do {                              \
+        pvt_matcher_free_(matcher);   \
+        (matcher) = NULL;             \
+    } while (0)
+
+/**
+ * @brief cstring_matcher_find_first - Find the occurrence of any pattern that
+ *                                     ends first in a cstring.
+ * @details Of several patterns ending at the same position, the longest one is
+ *          reported.
+ * @param matcher    - The matcher.
  * @param str        - The cstring.
- * @param pos        - Position at which to begin searching.
- * @param ptr        - Pointer to the first character of the string identifying
- *                     characters to search for.
- * @param count      - Length of the string of characters to search for.
  * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
- *                     of the first found character or -1 if no such character
- *                     is found.
+ *                     of the occurrence, or -1 if no pattern occurs.
+ * @param ret_id     - Variable of type `size_t` that receives the ID of the
+ *                     pattern.
  * @return void
  */
-#define pvt_find_last_of_(not_of, str, pos, ptr, count, ret_offset)                                                \
-    do {                                                                                                           \
-        const void *const chk_p07__ = (const void *)(ptr);                                                         \
-        const ptrdiff_t cnt_p07__   = (ptrdiff_t)(count);                                                          \
-        ptrdiff_t stroff_p07__      = ((ptrdiff_t)(pos) == -1 || (ptrdiff_t)(pos) >= (ptrdiff_t)cstring_size(str)) \
-                                          ? (ptrdiff_t)cstring_size(str) - 1                                       \
-                                          : (ptrdiff_t)(pos);                                                      \
-        if (!chk_p07__ || (ptrdiff_t)(pos) < -1 || stroff_p07__ < 0 || cnt_p07__ <= 0) {                           \
-            (ret_offset) = (ptrdiff_t)-1;                                                                          \
-        } else if (cnt_p07__ == 1) {                                                                               \
-            pvt_find_last_char_((not_of), (str), (pos), (ptr), (ret_offset));                                      \
-        } else {                                                                                                   \
-            size_t chmsk_p07__;                                                                                    \
-            ptrdiff_t suboff_p07__;                                                                                \
-            pvt_make_charmask_((ptr), cnt_p07__, chmsk_p07__);                                                     \
-            for (; stroff_p07__ >= 0; --stroff_p07__) {                                                            \
-                if ((size_t)(str)[stroff_p07__] & chmsk_p07__) {                                                   \
-                    continue;                                                                                      \
-                }                                                                                                  \
-                for (suboff_p07__ = 0;                                                                             \
-                     suboff_p07__ < cnt_p07__ && (str)[stroff_p07__] != (ptr)[suboff_p07__];                       \
-                     ++suboff_p07__)                                                                               \
-                    ;                                                                                              \
-                if ((suboff_p07__ == cnt_p07__) == (not_of)) {                                                     \
-                    break;                                                                                         \
-                }                                                                                                  \
-            }                                                                                                      \
-            (ret_offset) = stroff_p07__;                                                                           \
-        }                                                                                                          \
+#define cstring_matcher_find_first(matcher, str, ret_offset, ret_id) \
+    pvt_matcher_first_((matcher), (str), cstring_size(str), sizeof(*(str)), &(ret_offset), &(ret_id))
+
+/**
+ * @brief cstring_matcher_find_all - Find all occurrences of all patterns in a
+ *                                   cstring, including overlapping ones.
+ * @details The occurrences are ordered by their end position.
+ * @param matcher     - The matcher.
+ * @param str         - The cstring.
+ * @param ret_offsets - Variable of type `ptrdiff_t *` that receives a vector of
+ *                      the positions of the occurrences. It's managed like a
+ *                      cstring. Its size is the number of occurrences, and it
+ *                      has to be released using `cstring_free()`. The capacity
+ *                      of an existing vector is reused.
+ * @param ret_ids     - Variable of type `size_t *` that receives the vector of
+ *                      the pattern IDs of the occurrences, managed the same
+ *                      way.
+ * @return void
+ */
+#define cstring_matcher_find_all(matcher, str, ret_offsets, ret_ids) \
+    pvt_matcher_all_((matcher), (str), cstring_size(str), sizeof(*(str)), &(ret_offsets), &(ret_ids))
+
+/**
+ * @brief cstring_matcher_ids - Get the IDs of the patterns that occur in a
+ *                              cstring.
+ * @param matcher - The matcher.
+ * @param str     - The cstring.
+ * @param ret_ids - Variable of type `size_t *` that receives a vector of the
+ *                  IDs, each reported once, in the order of their first
+ *                  occurrence. It's managed like a cstring and has to be
+ *                  released using `cstring_free()`.
+ * @return void
+ */
+#define cstring_matcher_ids(matcher, str, ret_ids) \
+    pvt_matcher_ids_((matcher), (str), cstring_size(str), sizeof(*(str)), &(ret_ids))
+
+/**
+ * @brief cstring_view_matcher_find_first - Find the occurrence of any pattern
+ *                                          that ends first in a view.
+ * @param matcher    - The matcher.
+ * @param view       - The cstring_view.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the occurrence, or -1 if no pattern occurs.
+ * @param ret_id     - Variable of type `size_t` that receives the ID of the
+ *                     pattern.
+ * @return void
+ */
+#define cstring_view_matcher_find_first(matcher, view, ret_offset, ret_id) \
+    pvt_matcher_first_((matcher), (view).data, (view).size, sizeof(*(view).data), &(ret_offset), &(ret_id))
+
+/**
+ * @brief cstring_view_matcher_find_all - Find all occurrences of all patterns
+ *                                        in a view.
+ * @param matcher     - The matcher.
+ * @param view        - The cstring_view.
+ * @param ret_offsets - Variable of type `ptrdiff_t *` that receives the vector
+ *                      of positions, see `cstring_matcher_find_all()`.
+ * @param ret_ids     - Variable of type `size_t *` that receives the vector of
+ *                      pattern IDs.
+ * @return void
+ */
+#define cstring_view_matcher_find_all(matcher, view, ret_offsets, ret_ids) \
+    pvt_matcher_all_((matcher), (view).data, (view).size, sizeof(*(view).data), &(ret_offsets), &(ret_ids))
+
+/**
+ * @brief cstring_view_matcher_ids - Get the IDs of the patterns that occur in a
+ *                                   view.
+ * @param matcher - The matcher.
+ * @param view    - The cstring_view.
+ * @param ret_ids - Variable of type `size_t *` that receives the vector of IDs,
+ *                  see `cstring_matcher_ids()`.
+ * @return void
+ */
+#define cstring_view_matcher_ids(matcher, view, ret_ids) \
+    pvt_matcher_ids_((matcher), (view).data, (view).size, sizeof(*(view).data), &(ret_ids))
+
+/** @} */
+
+/* ================== */
+/* === EDIT BATCH === */
+/* ================== */
+
+/**
+ * @defgroup cstring_edit_api The cstring edit batch
+ * @details An edit batch collects insert, erase and replace operations against
+ *          the positions in the original string, and applies all of them at
+ *          once in a single pass. The string is grown at most once. Unlike a
+ *          sequence of `cstring_insert()`, `cstring_erase()` and
+ *          `cstring_replace()` calls, the characters following the edited
+ *          positions are moved only once. <br>
+ *          The operations are applied in the order of their positions,
+ *          operations at the same position in the order in which they were
+ *          added. Characters that are erased by several operations are erased
+ *          only once, and an insertion inside of an erased range is moved to
+ *          the end of the range.
+ * @{
+ */
+
+/**
+ * @brief cstring_edit_type - The type of an edit batch.
+ * @param type - The character type of the edited strings.
+ */
+#define cstring_edit_type(type) \
+    struct {                    \
+        size_t *ops;            \
+        type *text;             \
+    }
+
+/**
+ * @brief cstring_edit_init - Initialize an empty edit batch.
+ * @param edit - The edit batch.
+ * @return void
+ */
+#define cstring_edit_init(edit) \
+    do {                        \
+        (edit).ops  = NULL;     \
+        (edit).text = NULL;     \
     } while (0)
 
+/**
+ * @brief cstring_edit_free - Release the resources of an edit batch.
+ * @param edit - The edit batch.
+ * @return void
+ */
+#define cstring_edit_free(edit)    \
+    do {                           \
+        cstring_free((edit).ops);  \
+        cstring_free((edit).text); \
+    } while (0)
+
+/**
+ * @brief cstring_edit_size - Get the number of operations in an edit batch.
+ * @param edit - The edit batch.
+ * @return The number of operations as a `size_t`.
+ */
+#define cstring_edit_size(edit) \
+    (cstring_size((edit).ops) / 4)
+
+/**
+ * @brief cstring_edit_clear - Remove all operations from an edit batch.
+ * @param edit - The edit batch.
+ * @return void
+ */
+#define cstring_edit_clear(edit)    \
+    do {                            \
+        cstring_clear((edit).ops);  \
+        cstring_clear((edit).text); \
+    } while (0)
+
+/**
+ * @brief cstring_edit_replace - Add the replacement of a substring to an edit
+ *                               batch.
+ * @param edit  - The edit batch.
+ * @param pos   - Offset of the first replaced character in the original
+ *                string.
+ * @param n     - Number of consecutive characters to be replaced.
+ * @param ptr   - Pointer to the first replacement character. The characters
+ *                are copied.
+ * @param count - Number of consecutive replacement characters to be used.
+ * @return void
+ */
+#define cstring_edit_replace(edit, pos, n, ptr, count)           \
+    do {                                                         \
+        pvt_edit_push_((edit), (pos), (n), (count));             \
+        if ((size_t)(count)) {                                   \
+            cstring_append((edit).text, (ptr), (size_t)(count)); \
+        }                                                        \
+    } while (0)
+
+/**
+ * @brief cstring_edit_insert - Add an insertion to an edit batch.
+ * @param edit  - The edit batch.
+ * @param pos   - Position in the original string where the characters are
+ *                inserted.
+ * @param ptr   - Pointer to the first inserted character. The characters are
+ *                copied.
+ * @param count - Number of consecutive characters to be used.
+ * @return void
+ */
+#define cstring_edit_insert(edit, pos, ptr, count) \
+    cstring_edit_replace((edit), (pos), 0, (ptr), (count))
+
+/**
+ * @brief cstring_edit_erase - Add the removal of a substring to an edit batch.
+ * @param edit - The edit batch.
+ * @param pos  - Offset of the first erased character in the original string.
+ * @param n    - Number of consecutive characters to be erased.
+ * @return void
+ */
+#define cstring_edit_erase(edit, pos, n) \
+    pvt_edit_push_((edit), (pos), (n), 0)
+
+/**
+ * @brief cstring_edit_apply - Apply all operations of an edit batch to a
+ *                             cstring and clear the batch.
+ * @details Positions beyond the end of the string are treated as the end of the
+ *          string.
+ * @param edit - The edit batch.
+ * @param str  - The cstring. Can be a NULL string.
+ * @return void
+ */
+#define cstring_edit_apply(edit, str)                                                                         \
+    do {                                                                                                      \
+        const size_t nops_s22__ = cstring_edit_size(edit);                                                    \
+        if (nops_s22__) {                                                                                     \
+            size_t siz_s22__, head_s22__, newsiz_s22__;                                                       \
+            pvt_clib_assert(sizeof(*(edit).text) == sizeof(*(str)));                                          \
+            if (!(str)) {                                                                                     \
+                cstring_reserve((str), 0);                                                                    \
+            }                                                                                                 \
+            siz_s22__  = cstring_size(str);                                                                   \
+            head_s22__ = pvt_edit_plan_((edit).ops, nops_s22__, siz_s22__, &newsiz_s22__);                    \
+            if (pvt_ttl_cap_(str) < siz_s22__ + head_s22__ + 1) {                                             \
+                pvt_grow_((str), siz_s22__ + head_s22__ + 1);                                                 \
+            }                                                                                                 \
+            pvt_edit_run_((str), sizeof(*(str)), siz_s22__, head_s22__, (edit).ops, nops_s22__, (edit).text); \
+            pvt_set_ttl_siz_((str), newsiz_s22__ + 1);                                                        \
+            (str)[newsiz_s22__] = 0;                                                                          \
+        }                                                                                                     \
+        cstring_edit_clear(edit);                                                                             \
+    } while (0)
+
+/** @} */
+
+/* ================= */
+/* === STREAMING === */
+/* ================= */
+
+/**
+ * @defgroup cstring_stream_api Streaming search and replacement
+ * @details Search and replacement in text that arrives in chunks, without the
+ *          need to keep the whole text in memory.
+ * @{
+ */
+
+/**
+ * @brief cstring_replacer_type - The type of a streaming replacer.
+ * @details A replacer replaces all non-overlapping occurrences of a string in
+ *          text that is fed chunk by chunk. Occurrences that span chunk
+ *          boundaries are found. Only a tail of less than the length of the
+ *          string to search for is held back between chunks, so the memory
+ *          needed is bounded by the chunk size plus the length of the string to
+ *          search for.
+ * @param type - The character type of the processed text.
+ */
+#define cstring_replacer_type(type) \
+    struct {                        \
+        const type *needle;         \
+        ptrdiff_t size;             \
+        const type *repl;           \
+        size_t repl_size;           \
+        pvt_twoway_t crit;          \
+        type *carry;                \
+    }
+
+/**
+ * @brief cstring_replacer_init - Initialize a streaming replacer.
+ * @param rep    - The replacer.
+ * @param pat    - Pointer to the first character of the string to search for.
+ *                 It must stay valid while the replacer is in use.
+ * @param n      - Length of the string to search for.
+ * @param ptr    - Pointer to the first replacement character. It must stay
+ *                 valid while the replacer is in use.
+ * @param count  - Number of consecutive replacement characters to be used.
+ * @return void
+ */
+#define cstring_replacer_init(rep, pat, n, ptr, count)                     \
+    do {                                                                   \
+        (rep).needle    = (pat);                                           \
+        (rep).size      = (ptrdiff_t)(n);                                  \
+        (rep).repl      = (ptr);                                           \
+        (rep).repl_size = (size_t)(count);                                 \
+        (rep).carry     = NULL;                                            \
+        if ((rep).needle && (rep).size > 0) {                              \
+            pvt_make_find_sub_crit_((rep).needle, (rep).size, (rep).crit); \
+        } else {                                                           \
+            (rep).size = 0;                                                \
+        }                                                                  \
+    } while (0)
+
+/**
+ * @brief cstring_replacer_feed - Process the next chunk of the text.
+ * @param rep   - The replacer.
+ * @param ptr   - Pointer to the first character of the chunk.
+ * @param count - Length of the chunk.
+ * @param out   - The cstring that receives the output which is complete so
+ *                far. Its previous content is discarded, its capacity is
+ *                reused. Can be a NULL string.
+ * @return void
+ */
+#define cstring_replacer_feed(rep, ptr, count, out) \
+    pvt_replacer_feed_((rep), (ptr), (count), (out))
+
+/**
+ * @brief cstring_replacer_finish - Complete the text.
+ * @details The held back tail is flushed, and the replacer is ready to
+ *          process another text.
+ * @param rep - The replacer.
+ * @param out - The cstring that receives the rest of the output. Its previous
+ *              content is discarded.
+ * @return void
+ */
+#define cstring_replacer_finish(rep, out)                                  \
+    do {                                                                   \
+        cstring_clear(out);                                                \
+        if (cstring_size((rep).carry)) {                                   \
+            cstring_append((out), (rep).carry, cstring_size((rep).carry)); \
+        }                                                                  \
+        cstring_clear((rep).carry);                                        \
+    } while (0)
+
+/**
+ * @brief cstring_replacer_free - Release the resources of a streaming
+ *                                replacer.
+ * @param rep - The replacer.
+ * @return void
+ */
+#define cstring_replacer_free(rep) \
+    cstring_free((rep).carry)
+
+/**
+ * @brief cstring_scanner_type - The type of a resumable search in a growing
+ *                               string.
+ * @details A scanner looks for the non-overlapping occurrences of a string in
+ *          a buffer that is repeatedly appended to, e.g. for a frame delimiter
+ *          in data received from the network. It remembers how far the buffer
+ *          was scanned, including a partial occurrence at its end, so that
+ *          each call only inspects the characters appended since the previous
+ *          call. The cost is amortized O(1) per character, no matter how small
+ *          the appended pieces are.
+ * @param type - The character type of the scanned string.
+ */
+#define cstring_scanner_type(type) \
+    struct {                       \
+        const type *needle;        \
+        ptrdiff_t size;            \
+        pvt_twoway_t crit;         \
+        size_t *border;            \
+        size_t scanned;            \
+        size_t state;              \
+    }
+
+/**
+ * @brief cstring_scanner_init - Initialize a scanner.
+ * @param scan  - The scanner.
+ * @param ptr   - Pointer to the first character of the string to search for.
+ *                It must stay valid while the scanner is in use.
+ * @param count - Length of the string to search for.
+ * @return void
+ */
+#define cstring_scanner_init(scan, ptr, count)                                    \
+    do {                                                                          \
+        (scan).needle  = (ptr);                                                   \
+        (scan).size    = (ptrdiff_t)(count);                                      \
+        (scan).border  = NULL;                                                    \
+        (scan).scanned = 0;                                                       \
+        (scan).state   = 0;                                                       \
+        if ((scan).needle && (scan).size > 0) {                                   \
+            pvt_make_find_sub_crit_((scan).needle, (scan).size, (scan).crit);     \
+            pvt_make_borders_((scan).needle, (size_t)(scan).size, (scan).border); \
+        } else {                                                                  \
+            (scan).size = 0;                                                      \
+        }                                                                         \
+    } while (0)
+
+/**
+ * @brief cstring_scanner_next - Find the next occurrence in a cstring that
+ *                               may have grown since the previous call.
+ * @param scan       - The scanner.
+ * @param str        - The cstring. Characters must only be appended to it
+ *                     between the calls, see `cstring_scanner_consume()` for
+ *                     removing characters from its front.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the occurrence, or -1 if the string doesn't contain
+ *                     another complete occurrence yet.
+ * @return void
+ */
+#define cstring_scanner_next(scan, str, ret_offset) \
+    pvt_scanner_next_((scan), (str), cstring_size(str), (ret_offset))
+
+/**
+ * @brief cstring_view_scanner_next - Find the next occurrence in a view that
+ *                                    may have grown since the previous call.
+ * @param scan       - The scanner.
+ * @param view       - The cstring_view.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the occurrence, or -1.
+ * @return void
+ */
+#define cstring_view_scanner_next(scan, view, ret_offset) \
+    pvt_scanner_next_((scan), (view).data, (view).size, (ret_offset))
+
+/**
+ * @brief cstring_scanner_consume - Inform the scanner that characters were
+ *                                  removed from the front of the string.
+ * @param scan - The scanner.
+ * @param n    - Number of characters removed.
+ * @return void
+ */
+#define cstring_scanner_consume(scan, n)                    \
+    do {                                                    \
+        if ((size_t)(n) <= (scan).scanned - (scan).state) { \
+            (scan).scanned -= (size_t)(n);                  \
+        } else {                                            \
+            (scan).scanned = 0;                             \
+            (scan).state   = 0;                             \
+        }                                                   \
+    } while (0)
+
+/**
+ * @brief cstring_scanner_reset - Start scanning a string from the beginning.
+ * @param scan - The scanner.
+ * @return void
+ */
+#define cstring_scanner_reset(scan) \
+    do {                            \
+        (scan).scanned = 0;         \
+        (scan).state   = 0;         \
+    } while (0)
+
+/**
+ * @brief cstring_scanner_free - Release the resources of a scanner.
+ * @param scan - The scanner.
+ * @return void
+ */
+#define cstring_scanner_free(scan) \
+    cstring_free((scan).border)
+
+/**
+ * @brief cstring_buffer_type - The type of a buffer that is consumed from the
+ *                              front.
+ * @details A buffer wraps a cstring with a start offset. Removing characters
+ *          from the front only advances the offset, and the remaining content
+ *          is moved to the front of the cstring lazily, once the consumed
+ *          characters outnumber the remaining ones or an append needs room.
+ *          Hence the cost of consuming is amortized O(1) per character, which
+ *          makes it suitable for parsers that consume input as it arrives.
+ * @param type - The character type of the buffer.
+ */
+#define cstring_buffer_type(type) \
+    struct {                      \
+        type *str;                \
+        size_t head;              \
+    }
+
+/**
+ * @brief cstring_buffer_init - Initialize an empty buffer.
+ * @param buf - The buffer.
+ * @return void
+ */
+#define cstring_buffer_init(buf) \
+    do {                         \
+        (buf).str  = NULL;       \
+        (buf).head = 0;          \
+    } while (0)
+
+/**
+ * @brief cstring_buffer_data - Get a pointer to the first character of the
+ *                              content of a buffer.
+ * @details The content is null-terminated. The pointer is invalidated by
+ *          `cstring_buffer_append()`, `cstring_buffer_consume()` and
+ *          `cstring_buffer_compact()`.
+ * @param buf - The buffer.
+ * @return The pointer, NULL if the buffer has never been appended to.
+ */
+#define cstring_buffer_data(buf) \
+    ((buf).str ? (buf).str + (buf).head : (buf).str)
+
+/**
+ * @brief cstring_buffer_size - Get the number of characters in a buffer.
+ * @param buf - The buffer.
+ * @return The length as a `size_t`.
+ */
+#define cstring_buffer_size(buf) \
+    (cstring_size((buf).str) - (buf).head)
+
+/**
+ * @brief cstring_buffer_view - Let a view refer to the content of a buffer.
+ * @param buf      - The buffer.
+ * @param ret_view - The cstring_view that receives the result.
+ * @return void
+ */
+#define cstring_buffer_view(buf, ret_view) \
+    pvt_view_sub_((buf).str, cstring_size((buf).str), (buf).head, cstring_size((buf).str), (ret_view))
+
+/**
+ * @brief cstring_buffer_append - Append characters to a buffer.
+ * @details If the capacity is exhausted and at least as many characters have
+ *          been consumed as remain, the buffer is compacted instead of grown.
+ * @param buf   - The buffer.
+ * @param ptr   - Pointer to the first character appended.
+ * @param count - Number of consecutive characters to be used.
+ * @return void
+ */
+#define cstring_buffer_append(buf, ptr, count)                                                   \
+    do {                                                                                         \
+        if ((buf).head && pvt_ttl_cap_((buf).str) - pvt_ttl_siz_((buf).str) < (size_t)(count) && \
+            (buf).head >= cstring_buffer_size(buf)) {                                            \
+            cstring_buffer_compact(buf);                                                         \
+        }                                                                                        \
+        cstring_append((buf).str, (ptr), (count));                                               \
+    } while (0)
+
+/**
+ * @brief cstring_buffer_consume - Remove characters from the front of a
+ *                                 buffer.
+ * @param buf - The buffer.
+ * @param n   - Number of characters to remove. All characters are removed if
+ *              `n` exceeds the size of the buffer.
+ * @return void
+ */
+#define cstring_buffer_consume(buf, n)                                                     \
+    do {                                                                                   \
+        const size_t siz_s23__ = cstring_buffer_size(buf);                                 \
+        if ((size_t)(n) >= siz_s23__) {                                                    \
+            cstring_clear((buf).str);                                                      \
+            (buf).head = 0;                                                                \
+        } else {                                                                           \
+            (buf).head += (size_t)(n);                                                     \
+            if ((buf).head >= pvt_headroom_min && (buf).head >= siz_s23__ - (size_t)(n)) { \
+                cstring_buffer_compact(buf);                                               \
+            }                                                                              \
+        }                                                                                  \
+    } while (0)
+
+/**
+ * @brief cstring_buffer_compact - Move the content of a buffer to the front of
+ *                                 its cstring.
+ * @details Afterwards `(buf).str` is an ordinary cstring holding the content.
+ * @param buf - The buffer.
+ * @return void
+ */
+#define cstring_buffer_compact(buf)                  \
+    do {                                             \
+        if ((buf).head) {                            \
+            cstring_erase((buf).str, 0, (buf).head); \
+            (buf).head = 0;                          \
+        }                                            \
+    } while (0)
+
+/**
+ * @brief cstring_buffer_free - Release the resources of a buffer.
+ * @param buf - The buffer.
+ * @return void
+ */
+#define cstring_buffer_free(buf) \
+    do {                         \
+        cstring_free((buf).str); \
+        (buf).head = 0;          \
+    } while (0)
+
+/** @} */
+
+/* ================== */
+/* === GAP BUFFER === */
+/* ================== */
+
+/**
+ * @defgroup cstring_gap_api The cstring gap buffer
+ * @details A gap buffer keeps the text in front of and behind a cursor at the
+ *          two ends of one allocation, with the unused capacity (the gap) in
+ *          between. Insertions and erasures at the cursor only change the
+ *          bounds of the gap, and moving the cursor only moves the characters
+ *          between its old and new position. Hence editing close to a cursor
+ *          costs amortized O(1) per character, regardless of the length of the
+ *          text. <br>
+ *          The allocation is a cstring buffer with the usual metadata, whose
+ *          size is the length of the text, not counting the gap. It's not
+ *          null-terminated while it's edited, see `cstring_gap_flatten()` and
+ *          `cstring_gap_copy()` for getting an ordinary cstring.
+ * @{
+ */
+
+/**
+ * @brief cstring_gap_type - The type of a gap buffer.
+ * @param type - The character type of the text.
+ */
+#define cstring_gap_type(type) \
+    struct {                   \
+        type *buf;             \
+        size_t gap;            \
+        size_t gap_end;        \
+    }
+
+/**
+ * @brief cstring_gap_init - Initialize an empty gap buffer.
+ * @param gb - The gap buffer.
+ * @return void
+ */
+#define cstring_gap_init(gb) \
+    do {                     \
+        (gb).buf     = NULL; \
+        (gb).gap     = 0;    \
+        (gb).gap_end = 0;    \
+    } while (0)
+
+/**
+ * @brief cstring_gap_size - Get the length of the text in a gap buffer.
+ * @param gb - The gap buffer.
+ * @return The length as a `size_t`.
+ */
+#define cstring_gap_size(gb) \
+    cstring_size((gb).buf)
+
+/**
+ * @brief cstring_gap_cursor - Get the position of the cursor of a gap buffer.
+ * @param gb - The gap buffer.
+ * @return The position as a `size_t`.
+ */
+#define cstring_gap_cursor(gb) \
+    ((gb).gap)
+
+/**
+ * @brief cstring_gap_at - Get the character at a position in a gap buffer.
+ * @param gb  - The gap buffer.
+ * @param pos - Position of the character, less than `cstring_gap_size(gb)`.
+ * @return The character.
+ */
+#define cstring_gap_at(gb, pos) \
+    ((gb).buf[((size_t)(pos) < (gb).gap) ? (size_t)(pos) : (size_t)(pos) + (gb).gap_end - (gb).gap])
+
+/**
+ * @brief cstring_gap_move - Move the cursor of a gap buffer.
+ * @param gb  - The gap buffer.
+ * @param pos - The new position of the cursor. It's moved to the end of the
+ *              text if `pos` exceeds it.
+ * @return void
+ */
+#define cstring_gap_move(gb, pos) \
+    pvt_gap_move_((gb), (pos))
+
+/**
+ * @brief cstring_gap_insert - Insert characters at the cursor of a gap
+ *                             buffer.
+ * @details The cursor is placed behind the inserted characters.
+ * @param gb    - The gap buffer.
+ * @param ptr   - Pointer to the first inserted character.
+ * @param count - Number of consecutive characters to be used.
+ * @return void
+ */
+#define cstring_gap_insert(gb, ptr, count)                                                    \
+    do {                                                                                      \
+        if ((size_t)(count)) {                                                                \
+            pvt_gap_reserve_((gb), (size_t)(count));                                          \
+            pvt_clib_memcpy((gb).buf + (gb).gap, (ptr), (size_t)(count) * sizeof(*(gb).buf)); \
+            (gb).gap += (size_t)(count);                                                      \
+            pvt_set_ttl_siz_((gb).buf, pvt_ttl_siz_((gb).buf) + (size_t)(count));             \
+        }                                                                                     \
+    } while (0)
+
+/**
+ * @brief cstring_gap_erase - Erase characters behind the cursor of a gap
+ *                            buffer, like the delete key does.
+ * @param gb - The gap buffer.
+ * @param n  - Number of characters to be erased. It's limited to the end of
+ *             the text.
+ * @return void
+ */
+#define cstring_gap_erase(gb, n)                                                             \
+    do {                                                                                     \
+        if ((gb).buf) {                                                                      \
+            const size_t tail_s24__ = pvt_ttl_cap_((gb).buf) - (gb).gap_end;                 \
+            const size_t n_s24__    = ((size_t)(n) < tail_s24__) ? (size_t)(n) : tail_s24__; \
+            (gb).gap_end += n_s24__;                                                         \
+            pvt_set_ttl_siz_((gb).buf, pvt_ttl_siz_((gb).buf) - n_s24__);                    \
+        }                                                                                    \
+    } while (0)
+
+/**
+ * @brief cstring_gap_backspace - Erase characters in front of the cursor of a
+ *                                gap buffer, like the backspace key does.
+ * @param gb - The gap buffer.
+ * @param n  - Number of characters to be erased. It's limited to the
+ *             beginning of the text.
+ * @return void
+ */
+#define cstring_gap_backspace(gb, n)                                              \
+    do {                                                                          \
+        const size_t n_s25__ = ((size_t)(n) < (gb).gap) ? (size_t)(n) : (gb).gap; \
+        if (n_s25__) {                                                            \
+            (gb).gap -= n_s25__;                                                  \
+            pvt_set_ttl_siz_((gb).buf, pvt_ttl_siz_((gb).buf) - n_s25__);         \
+        }                                                                         \
+    } while (0)
+
+/**
+ * @brief cstring_gap_replace - Replace characters behind the cursor of a gap
+ *                              buffer.
+ * @details The cursor is placed behind the replacement.
+ * @param gb    - The gap buffer.
+ * @param n     - Number of characters to be replaced.
+ * @param ptr   - Pointer to the first replacement character.
+ * @param count - Number of consecutive replacement characters to be used.
+ * @return void
+ */
+#define cstring_gap_replace(gb, n, ptr, count)    \
+    do {                                          \
+        cstring_gap_erase((gb), (n));             \
+        cstring_gap_insert((gb), (ptr), (count)); \
+    } while (0)
+
+/**
+ * @brief cstring_gap_flatten - Make the text of a gap buffer an ordinary
+ *                              cstring.
+ * @details The cursor is moved to the end of the text and the text is
+ *          null-terminated. Until the next edit, `(gb).buf` can be used
+ *          wherever a constant cstring is expected. It's NULL if nothing has
+ *          been inserted yet.
+ * @param gb - The gap buffer.
+ * @return void
+ */
+#define cstring_gap_flatten(gb)                          \
+    do {                                                 \
+        if ((gb).buf) {                                  \
+            pvt_gap_move_((gb), cstring_size((gb).buf)); \
+            (gb).buf[(gb).gap] = 0;                      \
+        }                                                \
+    } while (0)
+
+/**
+ * @brief cstring_gap_copy - Copy the text of a gap buffer into a cstring.
+ * @param gb - The gap buffer.
+ * @param to - The cstring. Can be a NULL string. Its previous content is
+ *             overwritten.
+ * @return void
+ */
+#define cstring_gap_copy(gb, to)                                             \
+    do {                                                                     \
+        cstring_clear(to);                                                   \
+        if ((gb).buf) {                                                      \
+            const size_t tail_s26__ = pvt_ttl_cap_((gb).buf) - (gb).gap_end; \
+            cstring_reserve((to), cstring_size((gb).buf));                   \
+            if ((gb).gap) {                                                  \
+                cstring_append((to), (gb).buf, (gb).gap);                    \
+            }                                                                \
+            if (tail_s26__) {                                                \
+                cstring_append((to), (gb).buf + (gb).gap_end, tail_s26__);   \
+            }                                                                \
+        }                                                                    \
+    } while (0)
+
+/**
+ * @brief cstring_gap_free - Release the resources of a gap buffer.
+ * @param gb - The gap buffer.
+ * @return void
+ */
+#define cstring_gap_free(gb)    \
+    do {                        \
+        cstring_free((gb).buf); \
+        (gb).gap     = 0;       \
+        (gb).gap_end = 0;       \
+    } while (0)
+
+/** @} */
+
+/* ============ */
+/* === ROPE === */
+/* ============ */
+
+/**
+ * @defgroup cstring_rope_api The cstring rope
+ * @details A rope represents a long string as a balanced tree of immutable
+ *          chunks of at most `pvt_rope_leaf_bytes` bytes. Concatenation,
+ *          splitting, insertion, erasure and indexing take O(log n) time
+ *          because they only create the nodes along one or two paths of the
+ *          tree and share all other nodes. Substrings and copies of a rope
+ *          therefore share the characters with the original. Each rope has to
+ *          be released using `cstring_rope_free()`. <br>
+ *          The reference count of the shared nodes is not updated atomically.
+ *          Ropes that share characters, including substrings and copies, must
+ *          not be modified or released concurrently by different threads.
+ * @{
+ */
+
+/**
+ * @brief cstring_rope_type - The type of a rope.
+ * @details The `tag` member only determines the character type. It's never
+ *          set to anything but NULL.
+ * @param type - The character type of the rope.
+ */
+#define cstring_rope_type(type) \
+    struct {                    \
+        pvt_rope_node_t *root;  \
+        const type *tag;        \
+    }
+
+/**
+ * @brief cstring_rope_init - Initialize an empty rope.
+ * @param rope - The rope.
+ * @return void
+ */
+#define cstring_rope_init(rope) \
+    do {                        \
+        (rope).root = NULL;     \
+        (rope).tag  = NULL;     \
+    } while (0)
+
+/**
+ * @brief cstring_rope_free - Release a rope and make it empty.
+ * @details Characters that are shared with other ropes are kept for them.
+ * @param rope - The rope.
+ * @return void
+ */
+#define cstring_rope_free(rope)         \
+    do {                                \
+        pvt_rope_release_((rope).root); \
+        (rope).root = NULL;             \
+    } while (0)
+
+/**
+ * @brief cstring_rope_size - Get the length of a rope.
+ * @param rope - The rope.
+ * @return The length as a `size_t`.
+ */
+#define cstring_rope_size(rope) \
+    ((rope).root ? (rope).root->size : (size_t)0)
+
+/**
+ * @brief cstring_rope_assign - Replace the content of a rope with a copy of a
+ *                              string.
+ * @param rope  - The rope.
+ * @param ptr   - Pointer to the first character of the string.
+ * @param count - Number of consecutive characters to be used.
+ * @return void
+ */
+#define cstring_rope_assign(rope, ptr, count)                                                    \
+    do {                                                                                         \
+        pvt_rope_node_t *const new_s27__ = pvt_rope_build_((ptr), (count), sizeof(*(rope).tag)); \
+        pvt_rope_release_((rope).root);                                                          \
+        (rope).root = new_s27__;                                                                 \
+    } while (0)
+
+/**
+ * @brief cstring_rope_append - Append a copy of a string to a rope.
+ * @param rope  - The rope.
+ * @param ptr   - Pointer to the first character of the string.
+ * @param count - Number of consecutive characters to be used.
+ * @return void
+ */
+#define cstring_rope_append(rope, ptr, count) \
+    ((rope).root = pvt_rope_join_((rope).root, pvt_rope_build_((ptr), (count), sizeof(*(rope).tag)), sizeof(*(rope).tag)))
+
+/**
+ * @brief cstring_rope_concat - Append another rope to a rope.
+ * @details The characters are shared, not copied. `other` is unchanged, and
+ *          it can be the same rope as `rope`.
+ * @param rope  - The rope.
+ * @param other - The appended rope.
+ * @return void
+ */
+#define cstring_rope_concat(rope, other) \
+    ((rope).root = pvt_rope_join_((rope).root, pvt_rope_retain_((other).root), sizeof(*(rope).tag)))
+
+/**
+ * @brief cstring_rope_insert - Insert a copy of a string into a rope.
+ * @param rope  - The rope.
+ * @param pos   - Position where the characters are inserted. The end of the
+ *                rope if it exceeds the length.
+ * @param ptr   - Pointer to the first inserted character.
+ * @param count - Number of consecutive characters to be used.
+ * @return void
+ */
+#define cstring_rope_insert(rope, pos, ptr, count) \
+    ((rope).root = pvt_rope_insert_((rope).root, (pos), pvt_rope_build_((ptr), (count), sizeof(*(rope).tag)), sizeof(*(rope).tag)))
+
+/**
+ * @brief cstring_rope_insert_rope - Insert another rope into a rope.
+ * @details The characters are shared, not copied.
+ * @param rope  - The rope.
+ * @param pos   - Position where the other rope is inserted.
+ * @param other - The inserted rope.
+ * @return void
+ */
+#define cstring_rope_insert_rope(rope, pos, other) \
+    ((rope).root = pvt_rope_insert_((rope).root, (pos), pvt_rope_retain_((other).root), sizeof(*(rope).tag)))
+
+/**
+ * @brief cstring_rope_erase - Erase characters from a rope.
+ * @param rope - The rope.
+ * @param pos  - Position of the first erased character.
+ * @param n    - Number of consecutive characters to be erased. It's limited to
+ *               the end of the rope.
+ * @return void
+ */
+#define cstring_rope_erase(rope, pos, n) \
+    ((rope).root = pvt_rope_erase_((rope).root, (pos), (n), sizeof(*(rope).tag)))
+
+/**
+ * @brief cstring_rope_substring - Let a rope refer to a part of another rope.
+ * @details The characters are shared, not copied.
+ * @param from     - The source rope.
+ * @param pos      - Position of the first character of the substring.
+ * @param n        - Number of consecutive characters. It's limited to the end
+ *                   of the source rope.
+ * @param ret_rope - The rope that receives the substring. Its previous content
+ *                   is released. It can be the same rope as `from`.
+ * @return void
+ */
+#define cstring_rope_substring(from, pos, n, ret_rope)                                                  \
+    do {                                                                                                \
+        pvt_rope_node_t *const sub_s28__ = pvt_rope_sub_((from).root, (pos), (n), sizeof(*(from).tag)); \
+        pvt_rope_release_((ret_rope).root);                                                             \
+        (ret_rope).root = sub_s28__;                                                                    \
+    } while (0)
+
+/**
+ * @brief cstring_rope_at - Get the character at a position in a rope.
+ * @param rope     - The rope.
+ * @param pos      - Position of the character, less than the length of the
+ *                   rope.
+ * @param ret_char - Variable of the character type of the rope that receives
+ *                   the character.
+ * @return void
+ */
+#define cstring_rope_at(rope, pos, ret_char)                                                                         \
+    do {                                                                                                             \
+        pvt_clib_assert(sizeof(ret_char) == sizeof(*(rope).tag));                                                    \
+        pvt_clib_memcpy(&(ret_char), pvt_rope_chunk_((rope).root, (pos), sizeof(ret_char), NULL), sizeof(ret_char)); \
+    } while (0)
+
+/**
+ * @brief cstring_rope_chunk - Get the characters from a position up to the end
+ *                             of the chunk containing it.
+ * @details For iterating a rope, e.g. to write it to a file, advance the
+ *          position by the size of each returned view.
+ * @param rope     - The rope.
+ * @param pos      - The position.
+ * @param ret_view - The cstring_view that receives the characters. It's empty
+ *                   if `pos` is not less than the length of the rope.
+ * @return void
+ */
+#define cstring_rope_chunk(rope, pos, ret_view)                                                           \
+    do {                                                                                                  \
+        if ((size_t)(pos) < cstring_rope_size(rope)) {                                                    \
+            (ret_view).data = pvt_rope_chunk_((rope).root, (pos), sizeof(*(rope).tag), &(ret_view).size); \
+        } else {                                                                                          \
+            (ret_view).data = NULL;                                                                       \
+            (ret_view).size = 0;                                                                          \
+        }                                                                                                 \
+    } while (0)
+
+/**
+ * @brief cstring_rope_flatten - Copy the content of a rope into a cstring.
+ * @param rope - The rope.
+ * @param to   - The cstring. Can be a NULL string. Its previous content is
+ *               overwritten.
+ * @return void
+ */
+#define cstring_rope_flatten(rope, to)                                  \
+    do {                                                                \
+        const size_t siz_s29__ = cstring_rope_size(rope);               \
+        pvt_clib_assert(sizeof(*(rope).tag) == sizeof(*(to)));          \
+        cstring_clear(to);                                              \
+        cstring_reserve((to), siz_s29__);                               \
+        pvt_rope_copy_((rope).root, 0, siz_s29__, (to), sizeof(*(to))); \
+        pvt_set_ttl_siz_((to), siz_s29__ + 1);                          \
+        (to)[siz_s29__] = 0;                                            \
+    } while (0)
+
+/**
+ * @brief cstring_rope_find - Find the first occurrence of a string in a rope.
+ * @details Each chunk is searched using the same algorithm as
+ *          `cstring_find()`. Occurrences spanning the boundary of two chunks
+ *          are found by searching the characters around it.
+ * @param rope       - The rope.
+ * @param pos        - Position at which to start the search.
+ * @param ptr        - Pointer to the first character of the string to search
+ *                     for.
+ * @param count      - Length of the string to search for.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the occurrence or -1.
+ * @return void
+ */
+#define cstring_rope_find(rope, pos, ptr, count, ret_offset) \
+    ((ret_offset) = pvt_rope_find_((rope).root, (ptrdiff_t)(pos), (ptr), (ptrdiff_t)(count), sizeof(*(rope).tag)))
+
+/** @} */
+
+/* ====================== */
+/* === SLAB ALLOCATOR === */
+/* ====================== */
+
+/**
+ * @defgroup cstring_slab_api The cstring slab allocator
+ * @details An optional size-class allocator, tuned for the metadata header
+ *          plus small payload of typical cstring objects. Blocks of up to 4096
+ *          bytes are carved from chunks that are cached per thread, larger
+ *          blocks are passed through to the C library. <br>
+ *          Plug it into the library by defining the allocation hooks before
+ *          including this header: <br>
+ *          `#define pvt_clib_malloc cstring_slab_malloc` <br>
+ *          `#define pvt_clib_realloc cstring_slab_realloc` <br>
+ *          `#define pvt_clib_free cstring_slab_free` <br>
+ *          `#define pvt_clib_usable_size cstring_slab_usable_size` <br>
+ *          The blocks are aligned like those of `malloc`. A block can be
+ *          released in any thread. It is then cached in the releasing thread.
+ *          Only chunks that are completely cached in the calling thread are
+ *          returned to the system by `cstring_slab_trim()`. When a thread
+ *          exits, the chunks of its cache that do not contain any block in use
+ *          are returned to the system, and the rest of the cache is taken over
+ *          by the next thread that uses the slab allocator or calls
+ *          `cstring_slab_trim()`. This requires a thread exit hook, which is
+ *          available on Windows and POSIX platforms (link with `-pthread` if
+ *          your C library needs it). Define `pvt_no_slab_exit` to go without.
+ * @{
+ */
+
+/**
+ * @brief cstring_slab_malloc - Allocate a block from the slab allocator.
+ * @param size - Number of bytes to allocate.
+ * @return Pointer to the allocated block, or NULL if the allocation failed.
+ */
+#define cstring_slab_malloc(size) \
+    pvt_slab_malloc_((size_t)(size))
+
+/**
+ * @brief cstring_slab_realloc - Resize a block of the slab allocator.
+ * @details The block is kept in place as long as the new size belongs to the
+ *          same size class. Otherwise the content is moved to a block of the
+ *          matching size class.
+ * @param ptr  - Pointer to the block, or NULL to allocate a new block.
+ * @param size - New size of the block in bytes.
+ * @return Pointer to the resized block, or NULL if the allocation failed.
+ */
+#define cstring_slab_realloc(ptr, size) \
+    pvt_slab_realloc_((ptr), (size_t)(size))
+
+/**
+ * @brief cstring_slab_free - Return a block to the slab allocator.
+ * @param ptr - Pointer to the block. Can be NULL.
+ * @return void
+ */
+#define cstring_slab_free(ptr) \
+    pvt_slab_free_(ptr)
+
+/**
+ * @brief cstring_slab_usable_size - Get the number of bytes usable in a block
+ *                                   of the slab allocator.
+ * @param ptr - Pointer to the block.
+ * @return The usable size as a `size_t`.
+ */
+#define cstring_slab_usable_size(ptr) \
+    pvt_slab_usable_size_(ptr)
+
+/**
+ * @brief cstring_slab_trim - Return all chunks of the calling thread that do
+ *                            not contain any block in use to the system.
+ * @return void
+ */
+#define cstring_slab_trim() \
+    pvt_slab_trim_()
+
+/** @} */
+
+/* ======================= */
+/* === ARENA ALLOCATOR === */
+/* ======================= */
+
+/**
+ * @defgroup cstring_arena_api The cstring arena allocator
+ * @details Strings and vectors created in an arena are bump-allocated from
+ *          chunks owned by the arena. Releasing an object is a no-op, the
+ *          memory is reclaimed in bulk by `cstring_arena_rollback()`,
+ *          `cstring_arena_reset()` or `cstring_arena_release()`. <br>
+ *          The arena is bound to the object. Growing the object keeps it in the
+ *          arena, and the strings of a cstring_array created in an arena are
+ *          allocated in the same arena. The most recently allocated object is
+ *          extended in place as long as the chunk has enough space left. <br>
+ *          Objects allocated after a checkpoint must not be used after the
+ *          arena has been rolled back to that checkpoint. No object of the
+ *          arena must be used after the arena has been reset or released.
+ * @{
+ */
+
+/**
+ * @brief cstring_arena_type - The type of an arena.
+ */
+#define cstring_arena_type pvt_arena_t
+
+/**
+ * @brief cstring_arena_mark_type - The type of a checkpoint of an arena.
+ */
+#define cstring_arena_mark_type pvt_arena_mark_t
+
+/**
+ * @brief cstring_arena_init - Initialize an arena.
+ * @details No memory is allocated until the first object is created.
+ * @param arena      - Pointer to the arena.
+ * @param chunk_size - Minimum number of bytes requested from the C library at
+ *                     once. Zero for the default.
+ * @return void
+ */
+#define cstring_arena_init(arena, chunk_size) \
+    pvt_arena_init_((arena), (size_t)(chunk_size))
+
+/**
+ * @brief cstring_arena_reserve - Create a cstring in an arena, or request that
+ *                                the capacity is at least enough to contain
+ *                                `n` characters.
+ * @details If `str` refers to an existing cstring, this is equivalent to
+ *          `cstring_reserve()`, and the cstring keeps its allocator.
+ * @param str   - The cstring. Can be a NULL string.
+ * @param n     - The minimum capacity, not counting the string terminator.
+ * @param arena - Pointer to the arena.
+ * @return void
+ */
+#define cstring_arena_reserve(str, n, arena) \
+    cstring_reserve_with((str), (n), cstring_arena_allocator, (arena))
+
+/**
+ * @brief cstring_array_arena_reserve - Create a cstring_array in an arena, or
+ *                                      request that the capacity is at least
+ *                                      enough to contain `n` strings.
+ * @details Strings added to a vector created in an arena are allocated in the
+ *          same arena.
+ * @param arr   - The cstring_array. Can be a NULL vector.
+ * @param n     - The minimum capacity.
+ * @param arena - Pointer to the arena.
+ * @return void
+ */
+#define cstring_array_arena_reserve(arr, n, arena) \
+    cstring_arena_reserve((arr), (n), (arena))
+
+/**
+ * @brief cstring_arena_checkpoint - Remember the current fill level of an
+ *                                   arena.
+ * @param arena    - Pointer to the arena.
+ * @param ret_mark - A `cstring_arena_mark_type` variable that receives the
+ *                   checkpoint.
+ * @return void
+ */
+#define cstring_arena_checkpoint(arena, ret_mark) \
+    do {                                          \
+        (ret_mark).chunk = (arena)->chunk;        \
+        (ret_mark).top   = (arena)->top;          \
+    } while (0)
+
+/**
+ * @brief cstring_arena_rollback - Release all objects that were allocated
+ *                                 after the checkpoint in O(1) per chunk.
+ * @param arena - Pointer to the arena.
+ * @param mark  - The checkpoint obtained by `cstring_arena_checkpoint()`.
+ * @return void
+ */
+#define cstring_arena_rollback(arena, mark) \
+    pvt_arena_rollback_((arena), (mark).chunk, (mark).top)
+
+/**
+ * @brief cstring_arena_reset - Release all objects of an arena, but keep the
+ *                              first chunk for reuse.
+ * @param arena - Pointer to the arena.
+ * @return void
+ */
+#define cstring_arena_reset(arena) \
+    pvt_arena_reset_((arena), 1)
+
+/**
+ * @brief cstring_arena_release - Release all objects and all chunks of an
+ *                                arena.
+ * @details The arena can be used again afterwards.
+ * @param arena - Pointer to the arena.
+ * @return void
+ */
+#define cstring_arena_release(arena) \
+    pvt_arena_reset_((arena), 0)
+
+/** @} */
+
+/* ========================== */
+/* === ALLOCATOR BINDING === */
+/* ========================== */
+
+/**
+ * @defgroup cstring_allocator_api Per-object allocator binding
+ * @details Every cstring and cstring_array records the allocator that owns it
+ *          in the metadata member that is otherwise only reserved for the
+ *          binary compatibility with c-vector. Objects of different allocators
+ *          can be mixed freely, even in the same cstring_array. All macros that
+ *          grow or release an object route the request to its allocator.
+ *          The c-vector macros take the member for an element destructor, and
+ *          they release the metadata pointer using their own `free`. Only
+ *          objects for which `cstring_get_allocator()` returns NULL may
+ *          therefore be passed to c-vector. This excludes every bound object,
+ *          including cstring_local strings and packed cstring_arrays.
+ *          Objects created using `cstring_reserve()`, `cstring_assign()` etc.
+ *          on a NULL string use the `pvt_clib_*` functions as before. Strings
+ *          created by a cstring_array macro use the allocator of the vector.
+ *          <br>
+ *          An allocator is an entry point of type `void (*)(void *)` plus a
+ *          context pointer. The entry point receives a pointer to a
+ *          `cstring_allocator_request_type` and has to fulfill the request as
+ *          follows: <br>
+ *          - If `size` is zero, release the object referred to by `base`. <br>
+ *          - Otherwise, provide a block of `cstring_allocator_prefix_size`
+ *            plus `size` bytes and let `base` point to the first byte that
+ *            follows the prefix. If `base` referred to an existing object,
+ *            preserve its first `keep` bytes (or `size` bytes, if this is less).
+ *            Call `cstring_allocator_bind()` on the resulting `base`. Set
+ *            `base` to NULL if the allocation failed. Optionally, increase
+ *            `size` to the number of usable bytes of the block. <br>
+ *          The prefix of a new object is expected to refer to `ctx`. An entry
+ *          point may store any other value there, as it is only read by the
+ *          entry point itself and passed as `ctx` to the entry point if a
+ *          cstring_array creates a new string.
+ * @{
+ */
+
+/**
+ * @brief cstring_allocator_request_type - The type of a request passed to the
+ *                                         entry point of an allocator.
+ */
+#define cstring_allocator_request_type pvt_alloc_req_t
+
+/**
+ * @brief cstring_allocator_prefix_size - The number of bytes an allocator has
+ *                                        to reserve in front of an object.
+ */
+#define cstring_allocator_prefix_size sizeof(void *)
+
+/**
+ * @brief cstring_allocator_bind - Record an allocator in an object, for use in
+ *                                 the entry point of an allocator.
+ * @param base     - The `base` member of the request.
+ * @param alloc_fn - The entry point of the allocator.
+ * @param ctx      - The value stored in the prefix of the object.
+ * @return void
+ */
+#define cstring_allocator_bind(base, alloc_fn, ctx) \
+    do {                                            \
+        pvt_ctx_(base) = (void *)(ctx);             \
+        (base)->unused = (alloc_fn);                \
+    } while (0)
+
+/**
+ * @brief cstring_allocator_context - Get the value stored in the prefix of an
+ *                                    object, for use in the entry point of an
+ *                                    allocator.
+ * @param base - The `base` member of the request.
+ * @return The context as a `void *`.
+ */
+#define cstring_allocator_context(base) \
+    pvt_ctx_(base)
+
+/**
+ * @brief cstring_get_allocator - Get the entry point of the allocator that
+ *                                owns the cstring or cstring_array.
+ * @param str - The cstring or cstring_array. Can be NULL.
+ * @return The entry point, or NULL for objects owned by the `pvt_clib_*`
+ *         functions.
+ */
+#define cstring_get_allocator(str) \
+    ((str) ? pvt_dat_to_const_base_(str)->unused : NULL)
+
+/**
+ * @brief cstring_heap_allocator - The entry point of an allocator that uses the
+ *                                 `pvt_clib_*` functions. Pass NULL as context.
+ */
+#define cstring_heap_allocator pvt_heap_fn_
+
+/**
+ * @brief cstring_slab_allocator - The entry point of an allocator that uses the
+ *                                 slab allocator. Pass NULL as context.
+ */
+#define cstring_slab_allocator pvt_slab_fn_
+
+/**
+ * @brief cstring_arena_allocator - The entry point of an allocator that uses an
+ *                                  arena. Pass a pointer to the
+ *                                  `cstring_arena_type` as context.
+ */
+#define cstring_arena_allocator pvt_arena_fn_
+
+/**
+ * @brief cstring_mmap_allocator - The entry point of an allocator that maps
+ *                                 anonymous pages for every object. Pass NULL
+ *                                 as context.
+ * @details Intended for big buffers. Falls back to `cstring_heap_allocator` if
+ *          the platform does not support `mmap()`.
+ */
+#define cstring_mmap_allocator pvt_mmap_fn_
+
+/**
+ * @brief cstring_reserve_with - Create a cstring owned by the specified
+ *                               allocator, or request that the capacity is at
+ *                               least enough to contain `n` characters.
+ * @details If `str` refers to an existing cstring, this is equivalent to
+ *          `cstring_reserve()`, and the cstring keeps its allocator.
+ * @param str       - The cstring. Can be a NULL string.
+ * @param n         - The minimum capacity, not counting the string terminator.
+ * @param alloc_fn  - The entry point of the allocator.
+ * @param alloc_ctx - The context of the allocator.
+ * @return void
+ */
+#define cstring_reserve_with(str, n, alloc_fn, alloc_ctx)                           \
+    do {                                                                            \
+        if (!(str)) {                                                               \
+            pvt_new_with_((str), (size_t)(n) + 1, (alloc_fn), (void *)(alloc_ctx)); \
+            pvt_set_ttl_siz_((str), 1);                                             \
+            (str)[0] = 0;                                                           \
+        } else {                                                                    \
+            cstring_reserve((str), (n));                                            \
+        }                                                                           \
+    } while (0)
+
+/**
+ * @brief cstring_array_reserve_with - Create a cstring_array owned by the
+ *                                     specified allocator, or request that the
+ *                                     capacity is at least enough to contain
+ *                                     `n` strings.
+ * @details Strings added to the vector are owned by the same allocator.
+ * @param arr       - The cstring_array. Can be a NULL vector.
+ * @param n         - The minimum capacity.
+ * @param alloc_fn  - The entry point of the allocator.
+ * @param alloc_ctx - The context of the allocator.
+ * @return void
+ */
+#define cstring_array_reserve_with(arr, n, alloc_fn, alloc_ctx) \
+    cstring_reserve_with((arr), (n), (alloc_fn), (alloc_ctx))
+
+/** @} */
+
+/* ========================== */
+/* === INTERNAL INTERFACE === */
+/* ========================== */
+
+/** @cond INTERNAL */
+
+/**
+ * @defgroup internal_api The private API, for internal use only
+ * @{
+ */
+
+#include <limits.h>
+#include <stddef.h>
+
+/* in case C library functions need extra protection, allow these defines to be overridden. */
+/* functions for allocation and deallocation need to correspond to each other, fall back to C library functions if not all are overridden */
+#if !defined(pvt_clib_free) || !defined(pvt_clib_malloc) || !defined(pvt_clib_realloc)
+#ifdef pvt_clib_free
+#undef pvt_clib_free
+#endif
+#ifdef pvt_clib_malloc
+#undef pvt_clib_malloc
+#endif
+#ifdef pvt_clib_realloc
+#undef pvt_clib_realloc
+#endif
+#include <stdlib.h>
+#define pvt_clib_free free
+#define pvt_clib_malloc malloc
+#define pvt_clib_realloc realloc
+/* if the C library tells the usable size of an allocated block, the slack is folded into the capacity of a growing buffer */
+#ifdef pvt_clib_usable_size
+#undef pvt_clib_usable_size
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#define pvt_clib_usable_size malloc_usable_size
+#elif defined(_MSC_VER)
+#include <malloc.h>
+#define pvt_clib_usable_size _msize
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define pvt_clib_usable_size malloc_size
+#endif
+#endif
+/* functions independent of memory allocation */
+#ifndef pvt_clib_assert
+#include <assert.h>
+#define pvt_clib_assert assert
+#endif
+#ifndef pvt_clib_memcpy
+#include <string.h>
+#define pvt_clib_memcpy memcpy
+#endif
+#ifndef pvt_clib_memmove
+#include <string.h>
+#define pvt_clib_memmove memmove
+#endif
+#ifndef pvt_clib_memset
+#include <string.h>
+#define pvt_clib_memset memset
+#endif
+#ifndef pvt_clib_memcmp
+#include <string.h>
+#define pvt_clib_memcmp memcmp
+#endif
+#ifndef pvt_clib_memchr
+#include <string.h>
+#define pvt_clib_memchr memchr
+#endif
+#ifndef pvt_clib_wmemchr
+#include <wchar.h>
+#define pvt_clib_wmemchr wmemchr
+#endif
+/* growth policy of macros that incrementally enlarge a string or vector, allow these defines to be overridden */
+/* the capacity grows by the factor `pvt_growth_num / pvt_growth_den`, however at least by `pvt_growth_min` elements */
+/* define `pvt_growth_exact_fit` to always allocate the exactly requested capacity */
+#ifndef pvt_growth_num
+#define pvt_growth_num 3
+#endif
+#ifndef pvt_growth_den
+#define pvt_growth_den 2
+#endif
+#ifndef pvt_growth_min
+#define pvt_growth_min 8
+#endif
+/* a cstring_buffer moves its content to the front once at least `pvt_headroom_min` consumed elements outnumber the remaining ones */
+#ifndef pvt_headroom_min
+#define pvt_headroom_min 64
+#endif
+/* the leaves of a cstring_rope hold at most `pvt_rope_leaf_bytes` bytes of characters */
+#ifndef pvt_rope_leaf_bytes
+#define pvt_rope_leaf_bytes 1024
+#endif
+/* vectorized search kernels are used if the target supports SSE2 or AVX2, define `pvt_no_simd` to use the portable code only */
+#if !defined(pvt_no_simd) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define pvt_simd_sse2_
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define pvt_simd_avx2_
+#endif
+#endif
+
+/**
+ * @brief pvt_metadata_t - Header type that prefixes a cstring or cstring_array.
+ */
+typedef struct pvt_metadata_ {
+    size_t size;            /*!< The size incl. terminator. */
+    size_t capacity;        /*!< The capacity incl. space for the string terminator. */
+    void (*unused)(void *); /*!< This maintains binary compatibility with `cvector_metadata_t` of the c-vector library. NULL for objects allocated using the `pvt_clib_*` functions, otherwise the entry point of the owning allocator. Only objects with NULL are binary compatible with a `cvector`. */
+} pvt_metadata_t;
+
+/**
+ * @brief pvt_alloc_req_t - Request passed to the entry point of an allocator
+ *                          that owns a cstring or cstring_array.
+ * @details An object owned by an allocator is prefixed with a `void *` that
+ *          precedes the metadata and refers to the allocator context. The entry
+ *          point allocates a new object if `base` is NULL, releases the object
+ *          if `size` is zero, and reallocates it otherwise. It updates `base`,
+ *          the `unused` member of the metadata and the context pointer of the
+ *          resulting object.
+ */
+typedef struct pvt_alloc_req_ {
+    pvt_metadata_t *base; /*!< The metadata of the object, NULL to allocate a new object. Receives the metadata of the resulting object. */
+    size_t size;          /*!< The number of bytes incl. metadata, 0 to release the object. Can be increased by the entry point to report the usable size. */
+    size_t keep;          /*!< The number of leading bytes incl. metadata that have to be preserved. */
+    void *ctx;            /*!< The allocator context for a new object. */
+} pvt_alloc_req_t;
+
+/**
+ * @brief pvt_twoway_t - Critical factorization of a string to search for, used
+ *                       for the Two-Way string matching algorithm.
+ */
+typedef struct pvt_twoway_ {
+    ptrdiff_t ell;  /*!< Position of the last character of the left part of the factorization. -1 if the left part is empty. */
+    ptrdiff_t per;  /*!< The period of the string, or the shift used if the string is not periodic. */
+    int periodic;   /*!< 1 if the left part is repeated at the period, 0 otherwise. */
+} pvt_twoway_t;
+
+/**
+ * @brief pvt_charset_slots_ - For internal use, the number of slots in the hash
+ *                             table of a pvt_charset_t.
+ */
+#define pvt_charset_slots_ 64
+
+/**
+ * @brief pvt_charset_t - Set of characters used for the find_first_of and
+ *                        find_last_of families.
+ */
+typedef struct pvt_charset_ {
+    unsigned char low[32];           /*!< Exact bitmap of the characters with values below 256. */
+    size_t high[pvt_charset_slots_]; /*!< Hash table of the characters with greater values, 0 marks an empty slot. */
+    size_t used;                     /*!< The number of occupied slots in `high`. */
+    int overflow;                    /*!< 1 if not all characters fit into `high`, requiring a linear check for characters not found. */
+} pvt_charset_t;
+
+/**
+ * @brief pvt_matcher_t - Aho-Corasick automaton of a multi-pattern matcher.
+ * @details The struct is followed by the pattern lengths and the tables in the
+ *          same allocation.
+ */
+typedef struct pvt_matcher_ {
+    size_t states;           /*!< The number of states, 0 is the root. */
+    size_t classes;          /*!< The number of byte classes, i.e. the row length of the transition table. */
+    size_t patterns;         /*!< The number of patterns. */
+    size_t elsize;           /*!< The size of the characters in bytes. */
+    unsigned short cls[256]; /*!< The class of each byte, 0 for bytes that don't occur in any pattern. */
+    size_t *len;             /*!< The length of each pattern in characters. */
+    unsigned *next;          /*!< The transition table, a row of `classes` entries per state. */
+    unsigned *out;           /*!< 1 + ID of the longest pattern ending in the state, 0 for none. */
+    unsigned *link;          /*!< The nearest state along the failure links with an output, 0 for none. */
+} pvt_matcher_t;
+
+/**
+ * @brief pvt_matcher_cursor_t - Position of a pass of a pvt_matcher_t.
+ */
+typedef struct pvt_matcher_cursor_ {
+    size_t pos;     /*!< The number of bytes consumed. */
+    unsigned state; /*!< The current state. */
+    unsigned chain; /*!< The next state with an output to be reported at `pos`, 0 for none. */
+} pvt_matcher_cursor_t;
+
+/**
+ * @brief pvt_rope_node_t - Node of a cstring_rope.
+ * @details Nodes are immutable and reference counted, so that ropes can share
+ *          them. The characters of a leaf follow the struct in the same
+ *          allocation.
+ */
+typedef struct pvt_rope_node_ {
+    struct pvt_rope_node_ *left;  /*!< The left subtree, NULL for a leaf. */
+    struct pvt_rope_node_ *right; /*!< The right subtree, NULL for a leaf. */
+    size_t size;                  /*!< The number of characters in the subtree. */
+    size_t height;                /*!< 1 for a leaf, 1 + the height of the higher subtree otherwise. */
+    size_t refs;                  /*!< The reference count, not updated atomically. */
+} pvt_rope_node_t;
+
+/**
+ * @brief pvt_dat_to_base_ - For internal use, convert a buffer pointer to a
+ *                           metadata pointer.
+ * @param dat - The data pointer.
+ * @return The metadata pointer of the cstring.
+ */
+#define pvt_dat_to_base_(dat) \
+    (((pvt_metadata_t *)(void *)(dat)) - 1)
+
+/**
+ * @brief pvt_dat_to_const_base_ - For internal use, convert a buffer pointer to
+ *                                 a pointer to constant metadata.
+ * @param dat - The data pointer.
+ * @return The pointer to constant metadata of the cstring.
+ */
+#define pvt_dat_to_const_base_(dat) \
+    (((const pvt_metadata_t *)(const void *)(dat)) - 1)
+
+/**
+ * @brief pvt_ttl_cap_ - For internal use, get the current capacity of the
+ *                       buffer incl. terminator.
+ * @param dat - The data pointer.
+ * @return The capacity as a `size_t`.
+ */
+#define pvt_ttl_cap_(dat) \
+    ((dat) ? pvt_dat_to_const_base_(dat)->capacity : (size_t)0)
+
+/**
+ * @brief pvt_ttl_siz_ - For internal use, get the current size of the buffer
+ *                       incl. terminator.
+ * @param dat - The data pointer.
+ * @return The size as a `size_t`.
+ */
+#define pvt_ttl_siz_(dat) \
+    ((dat) ? pvt_dat_to_const_base_(dat)->size : (size_t)0)
+
+/**
+ * @brief pvt_set_ttl_siz_ - For internal use, set the size member of the
+ *                           metadata.
+ * @param dat - The data pointer.
+ * @param siz - The new size to set.
+ * @return void
+ */
+#define pvt_set_ttl_siz_(dat, siz)           \
+    do {                                     \
+        pvt_dat_to_base_(dat)->size = (siz); \
+    } while (0)
+
+/**
+ * @brief pvt_ctx_ - For internal use, access the allocator context of an
+ *                   object that is owned by an allocator.
+ * @details The address is computed as an integer, because the compiler
+ *          cannot know that the object lives behind the prefix.
+ * @param base - The metadata pointer.
+ * @return The context pointer as lvalue of type `void *`.
+ */
+#define pvt_ctx_(base) \
+    (*(void **)((size_t)(base) - sizeof(void *)))
+
+/**
+ * @brief pvt_resize_ - For internal use, set the capacity of the buffer to
+ *                      `count` elements.
+ * @details Objects owned by an allocator are passed to its entry point, all
+ *          others to pvt_clib_fn_.
+ * @param dat   - The data pointer. Can be NULL.
+ * @param count - The new capacity to set.
+ * @param preserve - Non-zero to preserve the content, zero to discard it.
+ * @return void
+ */
+#define pvt_resize_(dat, count, preserve)                                                                              \
+    do {                                                                                                               \
+        pvt_alloc_req_t req_p00__;                                                                                     \
+        req_p00__.base = (dat) ? pvt_dat_to_base_(dat) : NULL;                                                         \
+        req_p00__.size = (size_t)(count) * sizeof(*(dat)) + sizeof(pvt_metadata_t);                                    \
+        req_p00__.keep = sizeof(pvt_metadata_t) + (((dat) && (preserve)) ? req_p00__.base->size * sizeof(*(dat)) : 0); \
+        req_p00__.ctx  = NULL;                                                                                         \
+        ((req_p00__.base && req_p00__.base->unused) ? req_p00__.base->unused : pvt_clib_fn_)(&req_p00__);              \
+        pvt_clib_assert(req_p00__.base);                                                                               \
+        req_p00__.base->capacity = (req_p00__.size - sizeof(pvt_metadata_t)) / sizeof(*(dat));                         \
+        (dat)                    = (void *)(req_p00__.base + 1);                                                       \
+    } while (0)
+
+/**
+ * @brief pvt_grow_ - For internal use, ensure that the buffer is at least
+ *                    `count` elements big.
+ * @param dat   - The data pointer.
+ * @param count - The new capacity to set.
+ * @return void
+ */
+#define pvt_grow_(dat, count) \
+    pvt_resize_((dat), (count), 1)
+
+/**
+ * @brief pvt_renew_ - For internal use, discard the content of the buffer and
+ *                     ensure that it is at least `count` elements big.
+ * @details Unlike freeing the buffer and allocating a new one, the allocator
+ *          that owns the buffer is retained.
+ * @param dat   - The data pointer. Can be NULL.
+ * @param count - The new capacity to set.
+ * @return void
+ */
+#define pvt_renew_(dat, count) \
+    pvt_resize_((dat), (count), 0)
+
+/**
+ * @brief pvt_new_with_ - For internal use, allocate a NULL buffer using the
+ *                        specified allocator.
+ * @param dat   - The data pointer. Must be NULL.
+ * @param count - The capacity to set.
+ * @param alloc_fn  - Entry point of the allocator.
+ * @param alloc_ctx - Context of the allocator.
+ * @return void
+ */
+#define pvt_new_with_(dat, count, alloc_fn, alloc_ctx)                                         \
+    do {                                                                                       \
+        pvt_alloc_req_t req_p10__;                                                             \
+        req_p10__.base = NULL;                                                                 \
+        req_p10__.size = (size_t)(count) * sizeof(*(dat)) + sizeof(pvt_metadata_t);            \
+        req_p10__.keep = 0;                                                                    \
+        req_p10__.ctx  = (alloc_ctx);                                                          \
+        (alloc_fn)(&req_p10__);                                                                \
+        pvt_clib_assert(req_p10__.base);                                                       \
+        req_p10__.base->capacity = (req_p10__.size - sizeof(pvt_metadata_t)) / sizeof(*(dat)); \
+        (dat)                    = (void *)(req_p10__.base + 1);                               \
+    } while (0)
+
+/**
+ * @brief pvt_grow_like_ - For internal use, allocate a NULL buffer using the
+ *                         allocator that owns another object.
+ * @param dat   - The data pointer. Must be NULL.
+ * @param count - The capacity to set.
+ * @param owner - The data pointer of the object whose allocator is used.
+ * @return void
+ */
+#define pvt_grow_like_(dat, count, owner)                                                                                  \
+    do {                                                                                                                   \
+        if ((owner) && pvt_dat_to_const_base_(owner)->unused) {                                                            \
+            pvt_new_with_((dat), (count), pvt_dat_to_const_base_(owner)->unused, pvt_ctx_(pvt_dat_to_const_base_(owner))); \
+        } else {                                                                                                           \
+            pvt_grow_((dat), (count));                                                                                     \
+        }                                                                                                                  \
+    } while (0)
+
+/**
+ * @brief pvt_free_ - For internal use, release the buffer.
+ * @details Objects owned by an allocator are passed to its entry point, all
+ *          others to pvt_clib_fn_.
+ * @param dat - The data pointer. Must not be NULL.
+ * @return void
+ */
+#define pvt_free_(dat)                                                                \
+    do {                                                                              \
+        pvt_alloc_req_t req_p11__;                                                    \
+        req_p11__.base = pvt_dat_to_base_(dat);                                       \
+        req_p11__.size = 0;                                                           \
+        req_p11__.keep = 0;                                                           \
+        req_p11__.ctx  = NULL;                                                        \
+        (req_p11__.base->unused ? req_p11__.base->unused : pvt_clib_fn_)(&req_p11__); \
+    } while (0)
+
+/**
+ * @brief pvt_elem_assign_ - For internal use, create the string at position
+ *                           `pos` of a cstring_array using the allocator of the
+ *                           vector.
+ * @param arr   - The cstring_array.
+ * @param pos   - Position of the string in the vector.
+ * @param ptr   - Pointer to the first character assigned to the string.
+ * @param count - Number of consecutive characters to be used.
+ * @return void
+ */
+#define pvt_elem_assign_(arr, pos, ptr, count)                    \
+    do {                                                          \
+        (arr)[(pos)] = NULL;                                      \
+        pvt_grow_like_((arr)[(pos)], (size_t)(count) + 1, (arr)); \
+        cstring_assign((arr)[(pos)], (ptr), (count));             \
+    } while (0)
+
+/**
+ * @brief pvt_grow_amortized_ - For internal use, ensure that the buffer is at
+ *                              least `count` elements big, applying the growth
+ *                              policy.
+ * @details A NULL buffer is allocated with the exact size. An existing buffer
+ *          grows geometrically in order to keep the number of reallocations of
+ *          repeated appends logarithmic. If `pvt_clib_usable_size` is
+ *          available, the slack of the allocated block is added to the
+ *          capacity.
+ * @param dat   - The data pointer.
+ * @param count - The minimum capacity to set.
+ * @return void
+ */
+#ifdef pvt_growth_exact_fit
+#define pvt_grow_amortized_(dat, count) \
+    pvt_grow_((dat), (count))
+#else
+#define pvt_grow_amortized_(dat, count)                                                                                   \
+    do {                                                                                                                  \
+        size_t cap_p08__ = (size_t)(count);                                                                               \
+        if (dat) {                                                                                                        \
+            const size_t oldcap_p08__ = pvt_dat_to_const_base_(dat)->capacity;                                            \
+            const size_t geo_p08__    = oldcap_p08__ + oldcap_p08__ / pvt_growth_den * (pvt_growth_num - pvt_growth_den); \
+            const size_t min_p08__    = oldcap_p08__ + pvt_growth_min;                                                    \
+            if (cap_p08__ < geo_p08__) {                                                                                  \
+                cap_p08__ = geo_p08__;                                                                                    \
+            }                                                                                                             \
+            if (cap_p08__ < min_p08__) {                                                                                  \
+                cap_p08__ = min_p08__;                                                                                    \
+            }                                                                                                             \
+            pvt_grow_((dat), cap_p08__);                                                                                  \
+            if (!pvt_dat_to_const_base_(dat)->unused) {                                                                   \
+                pvt_add_slack_(dat);                                                                                      \
+            }                                                                                                             \
+        } else {                                                                                                          \
+            pvt_grow_((dat), cap_p08__);                                                                                  \
+        }                                                                                                                 \
+    } while (0)
+#endif
+
+/**
+ * @brief pvt_add_slack_ - For internal use, update the capacity of a heap
+ *                         allocated buffer to the usable size of its block.
+ * @param dat - The data pointer.
+ * @return void
+ */
+#ifdef pvt_clib_usable_size
+#define pvt_add_slack_(dat)                                                                                                          \
+    do {                                                                                                                             \
+        const size_t usable_p09__ = ((size_t)pvt_clib_usable_size(pvt_dat_to_base_(dat)) - sizeof(pvt_metadata_t)) / sizeof(*(dat)); \
+        if (usable_p09__ > pvt_dat_to_base_(dat)->capacity) {                                                                        \
+            pvt_dat_to_base_(dat)->capacity = usable_p09__;                                                                          \
+        }                                                                                                                            \
+    } while (0)
+#else
+#define pvt_add_slack_(dat) \
+    do {                    \
+    } while (0)
+#endif
+
+/**
+ * @brief pvt_str_n_eq_ - For internal use, check the equality of two string
+ *                        sequences.
+ * @details The character types have no padding bits, so this is a byte-wise
+ *          comparison that `pvt_clib_memcmp` performs with wide loads.
+ * @param s1     - Pointer to the first string sequence.
+ * @param s2     - Pointer to the second string sequence.
+ * @param n      - The number of characters to compare.
+ * @param ret_eq - Variable of type `int` that is set either to 1 if the
+ *                 sequences are equal, or to 0 otherwise.
+ * @return void
+ */
+#define pvt_str_n_eq_(s1, s2, n, ret_eq) \
+    ((ret_eq) = !pvt_clib_memcmp((s1), (s2), (size_t)(n) * sizeof(*(s1))))
+
+/**
+ * @brief pvt_fwd_at_ - For internal use, access a character of a string in
+ *                      forward order.
+ * @param s - Pointer to the first character of the string.
+ * @param n - Length of the string.
+ * @param i - Position of the character.
+ * @return The character.
+ */
+#define pvt_fwd_at_(s, n, i) \
+    ((s)[(i)])
+
+/**
+ * @brief pvt_rev_at_ - For internal use, access a character of a string in
+ *                      reverse order.
+ * @param s - Pointer to the first character of the string.
+ * @param n - Length of the string.
+ * @param i - Position of the character, counted from the end of the string.
+ * @return The character.
+ */
+#define pvt_rev_at_(s, n, i) \
+    ((s)[(n) - (ptrdiff_t)1 - (i)])
+
+/**
+ * @brief pvt_max_suffix_ - For internal use, find the maximal suffix of a
+ *                          string.
+ * @param at      - Either pvt_fwd_at_ or pvt_rev_at_.
+ * @param ptr     - Pointer to the first character of the string.
+ * @param count   - Length of the string.
+ * @param inv     - 0 for the maximal suffix, 1 for the maximal suffix with
+ *                  respect to the inverted order of the characters.
+ * @param ret_ms  - Variable of type `ptrdiff_t` that receives the position
+ *                  preceding the suffix.
+ * @param ret_per - Variable of type `ptrdiff_t` that receives the period of
+ *                  the suffix.
+ * @return void
+ */
+#define pvt_max_suffix_(at, ptr, count, inv, ret_ms, ret_per)                                      \
+    do {                                                                                           \
+        const ptrdiff_t cnt_p22__ = (ptrdiff_t)(count);                                            \
+        ptrdiff_t j_p22__         = 0;                                                             \
+        ptrdiff_t k_p22__         = 1;                                                             \
+        (ret_ms)                  = (ptrdiff_t)-1;                                                 \
+        (ret_per)                 = 1;                                                             \
+        while (j_p22__ + k_p22__ < cnt_p22__) {                                                    \
+            const ptrdiff_t a_p22__ = j_p22__ + k_p22__;                                           \
+            const ptrdiff_t b_p22__ = (ret_ms) + k_p22__;                                          \
+            if (at((ptr), cnt_p22__, a_p22__) == at((ptr), cnt_p22__, b_p22__)) {                  \
+                if (k_p22__ == (ret_per)) {                                                        \
+                    j_p22__ += (ret_per);                                                          \
+                    k_p22__ = 1;                                                                   \
+                } else {                                                                           \
+                    ++k_p22__;                                                                     \
+                }                                                                                  \
+            } else if ((at((ptr), cnt_p22__, a_p22__) < at((ptr), cnt_p22__, b_p22__)) != (inv)) { \
+                j_p22__ += k_p22__;                                                                \
+                k_p22__   = 1;                                                                     \
+                (ret_per) = j_p22__ - (ret_ms);                                                    \
+            } else {                                                                               \
+                (ret_ms) = j_p22__++;                                                              \
+                k_p22__ = (ret_per) = 1;                                                           \
+            }                                                                                      \
+        }                                                                                          \
+    } while (0)
+
+/**
+ * @brief pvt_twoway_prepare_ - For internal use, calculate the critical
+ *                              factorization of a string to search for.
+ * @param at       - Either pvt_fwd_at_ or pvt_rev_at_.
+ * @param ptr      - Pointer to the first character of the string to search for.
+ * @param count    - Length of the string to search for.
+ * @param ret_crit - Variable of type `pvt_twoway_t` that receives the
+ *                   factorization.
+ * @return void
+ */
+#define pvt_twoway_prepare_(at, ptr, count, ret_crit)                                                               \
+    do {                                                                                                            \
+        const ptrdiff_t cnt_p23__ = (ptrdiff_t)(count);                                                             \
+        ptrdiff_t ms_p23__, per_p23__, msinv_p23__, perinv_p23__;                                                   \
+        ptrdiff_t i_p23__ = 0;                                                                                      \
+        pvt_max_suffix_(at, (ptr), cnt_p23__, 0, ms_p23__, per_p23__);                                              \
+        pvt_max_suffix_(at, (ptr), cnt_p23__, 1, msinv_p23__, perinv_p23__);                                        \
+        if (msinv_p23__ >= ms_p23__) {                                                                              \
+            ms_p23__  = msinv_p23__;                                                                                \
+            per_p23__ = perinv_p23__;                                                                               \
+        }                                                                                                           \
+        while (i_p23__ <= ms_p23__ && at((ptr), cnt_p23__, i_p23__) == at((ptr), cnt_p23__, i_p23__ + per_p23__)) { \
+            ++i_p23__;                                                                                              \
+        }                                                                                                           \
+        (ret_crit).ell      = ms_p23__;                                                                             \
+        (ret_crit).periodic = (i_p23__ > ms_p23__);                                                                 \
+        if (!(ret_crit).periodic) {                                                                                 \
+            per_p23__ = ((ms_p23__ + 1 > cnt_p23__ - ms_p23__ - 1) ? ms_p23__ + 1 : cnt_p23__ - ms_p23__ - 1) + 1;  \
+        }                                                                                                           \
+        (ret_crit).per = per_p23__;                                                                                 \
+    } while (0)
+
+/**
+ * @brief pvt_twoway_try_ - For internal use, compare the string to search for
+ *                          at one position using the Two-Way algorithm.
+ * @details On a mismatch or on a match that is not reported, `start` and
+ *          `memory` are advanced to the next position to compare, so a scan
+ *          can be continued from the state left behind by an earlier match.
+ * @param at         - Either pvt_fwd_at_ or pvt_rev_at_.
+ * @param str        - Pointer to the first character of the string to search
+ *                     in.
+ * @param siz        - Length of the string to search in.
+ * @param ptr        - Pointer to the first character of the string to search
+ *                     for.
+ * @param count      - Length of the string to search for.
+ * @param crit       - Factorization calculated using pvt_twoway_prepare_ with
+ *                     the same `at`.
+ * @param start      - Variable of type `ptrdiff_t` that holds the position to
+ *                     compare at.
+ * @param memory     - Variable of type `ptrdiff_t` that holds the length of
+ *                     the prefix known to match at `start`.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives `start` if the
+ *                     string matches there. Left unchanged otherwise.
+ * @return void
+ */
+#define pvt_twoway_try_(at, str, siz, ptr, count, crit, start, memory, ret_offset)                                \
+    do {                                                                                                          \
+        const ptrdiff_t cnt_p42__ = (ptrdiff_t)(count);                                                           \
+        const ptrdiff_t sfx_p42__ = (crit).ell + 1;                                                               \
+        ptrdiff_t i_p42__         = (sfx_p42__ > (memory)) ? sfx_p42__ : (memory);                                \
+        while (i_p42__ < cnt_p42__ && at((ptr), cnt_p42__, i_p42__) == at((str), (siz), i_p42__ + (start))) {     \
+            ++i_p42__;                                                                                            \
+        }                                                                                                         \
+        if (i_p42__ < cnt_p42__) {                                                                                \
+            (start) += i_p42__ - sfx_p42__ + 1;                                                                   \
+            (memory) = 0;                                                                                         \
+        } else {                                                                                                  \
+            i_p42__ = sfx_p42__ - 1;                                                                              \
+            while (i_p42__ >= (memory) && at((ptr), cnt_p42__, i_p42__) == at((str), (siz), i_p42__ + (start))) { \
+                --i_p42__;                                                                                        \
+            }                                                                                                     \
+            if (i_p42__ < (memory)) {                                                                             \
+                (ret_offset) = (start);                                                                           \
+            } else {                                                                                              \
+                (start) += (crit).per;                                                                            \
+                (memory) = (crit).periodic ? cnt_p42__ - (crit).per : 0;                                          \
+            }                                                                                                     \
+        }                                                                                                         \
+    } while (0)
+
+/**
+ * @brief pvt_twoway_search_ - For internal use, find the first occurrence of a
+ *                             string using the Two-Way algorithm.
+ * @details Runs in linear time and constant space, regardless of the content
+ *          of the strings.
+ * @param at         - Either pvt_fwd_at_ or pvt_rev_at_. pvt_rev_at_ finds the
+ *                     last occurrence, counted from the end of `str`.
+ * @param str        - Pointer to the first character of the string to search
+ *                     in.
+ * @param siz        - Length of the string to search in.
+ * @param ptr        - Pointer to the first character of the string to search
+ *                     for.
+ * @param count      - Length of the string to search for.
+ * @param crit       - Factorization calculated using pvt_twoway_prepare_ with
+ *                     the same `at`.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the found substring, or -1 if no such substring is
+ *                     found.
+ * @return void
+ */
+#define pvt_twoway_search_(at, str, siz, ptr, count, crit, ret_offset)                          \
+    do {                                                                                        \
+        const ptrdiff_t ttl_p24__ = (ptrdiff_t)(siz);                                           \
+        const ptrdiff_t cnt_p24__ = (ptrdiff_t)(count);                                         \
+        ptrdiff_t j_p24__         = 0;                                                          \
+        ptrdiff_t mem_p24__       = 0;                                                          \
+        (ret_offset)              = (ptrdiff_t)-1;                                              \
+        while ((ret_offset) == -1 && j_p24__ <= ttl_p24__ - cnt_p24__) {                        \
+            pvt_twoway_try_(at, (str), ttl_p24__, (ptr), cnt_p24__, (crit), j_p24__, mem_p24__, \
+                            (ret_offset));                                                      \
+        }                                                                                       \
+    } while (0)
+
+/**
+ * @brief pvt_make_find_sub_crit_ - For internal use, pre-calculate the
+ *                                  factorization used for pvt_find_.
+ * @param ptr      - Pointer to the first character of the string to search for.
+ * @param count    - Length of the string to search for.
+ * @param ret_crit - Variable of type `pvt_twoway_t` that receives the
+ *                   factorization.
+ * @return void
+ */
+#define pvt_make_find_sub_crit_(ptr, count, ret_crit) \
+    pvt_twoway_prepare_(pvt_fwd_at_, (ptr), (count), (ret_crit))
+
+/**
+ * @brief pvt_make_rfind_sub_crit_ - For internal use, pre-calculate the
+ *                                   factorization used for pvt_rfind_crit_.
+ * @param ptr      - Pointer to the first character of the string to search for.
+ * @param count    - Length of the string to search for.
+ * @param ret_crit - Variable of type `pvt_twoway_t` that receives the
+ *                   factorization.
+ * @return void
+ */
+#define pvt_make_rfind_sub_crit_(ptr, count, ret_crit) \
+    pvt_twoway_prepare_(pvt_rev_at_, (ptr), (count), (ret_crit))
+
+/**
+ * @brief pvt_find_ - For internal use, find the first occurrence of the given
+ *                    substring.
+ * @param str        - Pointer to the first character of the string to search
+ *                     in.
+ * @param siz        - Length of the string to search in.
+ * @param pos        - Position at which to start the search, i.e. the found
+ *                     substring must not begin in a position preceding `pos`.
+ *                     Zero means that the whole `str` is searched. Evaluated
+ *                     once, before `ret_offset` is written, so it may refer to
+ *                     `ret_offset`.
+ * @param ptr        - Pointer to the first character of the string to search
+ *                     for.
+ * @param count      - Length of the string to search for.
+ * @param crit       - Factorization of the string to search for, calculated
+ *                     using pvt_make_find_sub_crit_.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the first character of the found substring or -1 if no
+ *                     such substring is found.
+ * @return void
+ */
+#define pvt_find_(str, siz, pos, ptr, count, crit, ret_offset)                                            \
+    do {                                                                                                  \
+        const void *const chk_p03__ = (const void *)(ptr);                                                \
+        const ptrdiff_t ttl_p03__   = (ptrdiff_t)(siz);                                                   \
+        const ptrdiff_t pos_p03__   = (ptrdiff_t)(pos);                                                   \
+        const ptrdiff_t cnt_p03__ = (ptrdiff_t)(count), siz_p03__ = ttl_p03__ - pos_p03__;                \
+        if (!chk_p03__ || pos_p03__ < 0 || cnt_p03__ > siz_p03__ || siz_p03__ <= 0 || cnt_p03__ <= 0) {   \
+            (ret_offset) = (ptrdiff_t)-1;                                                                 \
+        } else if (cnt_p03__ == siz_p03__) {                                                              \
+            int eq_p03__;                                                                                 \
+            pvt_str_n_eq_((str) + pos_p03__, (ptr), cnt_p03__, eq_p03__);                                 \
+            (ret_offset) = eq_p03__ ? pos_p03__ : (ptrdiff_t)-1;                                          \
+        } else if (cnt_p03__ == 1) {                                                                      \
+            pvt_find_first_char_(0, (str), ttl_p03__, pos_p03__, (ptr), (ret_offset));                    \
+        } else {                                                                                          \
+            ptrdiff_t rsm_p03__;                                                                          \
+            (ret_offset) = pvt_find_simd_((str) + pos_p03__, siz_p03__, (ptr), cnt_p03__, sizeof(*(str)), \
+                                          &rsm_p03__);                                                    \
+            if (rsm_p03__ != -1) {                                                                        \
+                pvt_twoway_search_(pvt_fwd_at_, (str) + pos_p03__ + rsm_p03__, siz_p03__ - rsm_p03__,     \
+                                   (ptr), cnt_p03__, (crit), (ret_offset));                               \
+                if ((ret_offset) != -1) {                                                                 \
+                    (ret_offset) += rsm_p03__;                                                            \
+                }                                                                                         \
+            }                                                                                             \
+            if ((ret_offset) != -1) {                                                                     \
+                (ret_offset) += pos_p03__;                                                                \
+            }                                                                                             \
+        }                                                                                                 \
+    } while (0)
+
+/**
+ * @brief pvt_find_first_char_ - For internal use, find the first character
+ *                               equal or not equal (depending on `not_eq`) to
+ *                               the character pointed to by `pchar`.
+ * @details Strings of at least one vector width are scanned using
+ *          pvt_find_char_simd_.
+ * @param not_eq     - 0 to find the first occurrence that equals the character,
+ *                     1 to find the first occurrence that does not equal the
+ *                     character
+ * @param str        - Pointer to the first character of the string to search
+ *                     in.
+ * @param siz        - Length of the string to search in.
+ * @param pos        - Position at which to begin searching.
+ * @param pchar      - Pointer to the character to search for.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the found character or -1 if no such character is
+ *                     found.
+ * @return void
+ */
+#define pvt_find_first_char_(not_eq, str, siz, pos, pchar, ret_offset)                                        \
+    do {                                                                                                      \
+        const ptrdiff_t siz_p04__ = (ptrdiff_t)(siz);                                                         \
+        (ret_offset)              = (ptrdiff_t)(pos);                                                         \
+        if (!pvt_find_char_simd_((str), siz_p04__, &(ret_offset), (pchar), sizeof(*(str)), (not_eq))) {       \
+            for (; (ret_offset) < siz_p04__ && ((str)[(ret_offset)] == *(pchar)) == (not_eq); ++(ret_offset)) \
+                ;                                                                                             \
+            if ((ret_offset) == siz_p04__) {                                                                  \
+                (ret_offset) = (ptrdiff_t)-1;                                                                 \
+            }                                                                                                 \
+        }                                                                                                     \
+    } while (0)
+
+/**
+ * @brief pvt_find_last_char_ - For internal use, find the last character equal
+ *                              or not equal (depending on `not_eq`) to the
+ *                              character pointed to by `pchar`.
+ * @param not_eq     - 0 to find the first occurrence that equals the character,
+ *                     1 to find the first occurrence that does not equal the
+ *                     character
+ * @param str        - The cstring.
+ * @param pos        - Position at which to begin searching.
+ * @param pchar      - Pointer to the character to search for.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the found character or -1 if no such character is
+ *                     found.
+ * @return void
+ */
+#define pvt_find_last_char_(not_eq, str, pos, pchar, ret_offset)                                                  \
+    do {                                                                                                          \
+        (ret_offset) = (ptrdiff_t)(pos);                                                                          \
+        if (!pvt_rfind_char_simd_((str), &(ret_offset), (pchar), sizeof(*(str)), (not_eq))) {                     \
+            for (; (ret_offset) > (ptrdiff_t)-1 && ((str)[(ret_offset)] == *(pchar)) == (not_eq); --(ret_offset)) \
+                ;                                                                                                 \
+        }                                                                                                         \
+    } while (0)
+
+/**
+ * @brief pvt_get_typemask_ - For internal use, calculate the bit mask with all
+ *                            bits of the size of the referenced character set.
+ * @details The value is considered a constant expression, calculated at compile
+ *          time. The receiving variables are declared as `static const` to make
+ *          this clear to the compiler.
+ * @param ptr - Pointer to a character.
+ * @return The calculated bit mask as value of type `size_t`.
+ */
+#define pvt_get_typemask_(ptr) \
+    ((sizeof(size_t) <= sizeof(*(ptr))) ? (size_t)-1 : (((size_t)1 << (sizeof(*(ptr)) * CHAR_BIT)) - 1))
+
+/**
+ * @brief pvt_make_charset_ - For internal use, create the set of characters
+ *                            used for pvt_find_first_of_ and pvt_find_last_of_.
+ * @param ptr     - Pointer to the first character of the character sequence.
+ * @param count   - Length of the character sequence.
+ * @param ret_set - Variable of type `pvt_charset_t` that receives the set.
+ * @return void
+ */
+#define pvt_make_charset_(ptr, count, ret_set)                                  \
+    do {                                                                        \
+        static const size_t tpmsk_p05__ = pvt_get_typemask_(ptr);               \
+        ptrdiff_t i_p05__               = 0;                                    \
+        pvt_charset_clear_(&(ret_set));                                         \
+        for (; i_p05__ < (ptrdiff_t)(count); ++i_p05__) {                       \
+            pvt_charset_add_(&(ret_set), (size_t)(ptr)[i_p05__] & tpmsk_p05__); \
+        }                                                                       \
+    } while (0)
+
+/**
+ * @brief pvt_charset_has_ - For internal use, check whether a character is in
+ *                           the given character sequence.
+ * @param set    - The set created by pvt_make_charset_.
+ * @param chr    - The character.
+ * @param ptr    - Pointer to the first character of the character sequence.
+ * @param count  - Length of the character sequence.
+ * @param ret_in - Variable of type `int` that receives 1 if the character is
+ *                 in the sequence, 0 otherwise.
+ * @return void
+ */
+#define pvt_charset_has_(set, chr, ptr, count, ret_in)                                            \
+    do {                                                                                          \
+        static const size_t tpmsk_p28__ = pvt_get_typemask_(ptr);                                 \
+        (ret_in)                        = pvt_charset_test_(&(set), (size_t)(chr) & tpmsk_p28__); \
+        if ((ret_in) < 0) {                                                                       \
+            ptrdiff_t i_p28__ = 0;                                                                \
+            while (i_p28__ < (ptrdiff_t)(count) && (ptr)[i_p28__] != (chr)) {                     \
+                ++i_p28__;                                                                        \
+            }                                                                                     \
+            (ret_in) = (i_p28__ < (ptrdiff_t)(count));                                            \
+        }                                                                                         \
+    } while (0)
+
+/**
+ * @brief pvt_find_first_of_ - For internal use, find the first character equal
+ *                             to one or none (depending on `not_of`) of the
+ *                             characters in the given character sequence.
+ * @param not_of     - 0 for find_first_of behavior, 1 for find_first_not_of
+ *                     behavior.
+ * @param str        - Pointer to the first character of the string to search
+ *                     in.
+ * @param siz        - Length of the string to search in.
+ * @param pos        - Position at which to begin searching.
+ * @param ptr        - Pointer to the first character of the string identifying
+ *                     characters to search for.
+ * @param count      - Length of the string of characters to search for.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the first found character or -1 if no such character
+ *                     is found.
+ * @return void
+ */
+#define pvt_find_first_of_(not_of, str, siz, pos, ptr, count, ret_offset)                                          \
+    do {                                                                                                           \
+        const void *const chk_p06__ = (const void *)(ptr);                                                         \
+        const ptrdiff_t cnt_p06__ = (ptrdiff_t)(count), siz_p06__ = (ptrdiff_t)(siz);                              \
+        if (!chk_p06__ || (ptrdiff_t)(pos) < 0 || siz_p06__ <= (ptrdiff_t)(pos) || cnt_p06__ <= 0) {               \
+            (ret_offset) = (ptrdiff_t)-1;                                                                          \
+        } else if (cnt_p06__ == 1) {                                                                               \
+            pvt_find_first_char_((not_of), (str), siz_p06__, (pos), (ptr), (ret_offset));                          \
+        } else {                                                                                                   \
+            (ret_offset) = (ptrdiff_t)(pos);                                                                       \
+            if (!pvt_find_of_simd_((str), siz_p06__, &(ret_offset), (ptr), cnt_p06__, sizeof(*(str)), (not_of))) { \
+                pvt_charset_t set_p06__;                                                                           \
+                int in_p06__;                                                                                      \
+                pvt_make_charset_((ptr), cnt_p06__, set_p06__);                                                    \
+                for (; (ret_offset) < siz_p06__; ++(ret_offset)) {                                                 \
+                    pvt_charset_has_(set_p06__, (str)[(ret_offset)], (ptr), cnt_p06__, in_p06__);                  \
+                    if (in_p06__ != (not_of)) {                                                                    \
+                        break;                                                                                     \
+                    }                                                                                              \
+                }                                                                                                  \
+                if ((ret_offset) == siz_p06__) {                                                                   \
+                    (ret_offset) = (ptrdiff_t)-1;                                                                  \
+                }                                                                                                  \
+            }                                                                                                      \
+        }                                                                                                          \
+    } while (0)
+
+/**
+ * @brief pvt_find_last_of_ - For internal use, find the last character equal to
+ *                            one or none (depending on `not_of`) of the
+ *                            characters in the given character sequence.
+ * @param not_of     - 0 for find_last_of behavior, 1 for find_last_not_of
+ *                     behavior.
+ * @param str        - Pointer to the first character of the string to search
+ *                     in.
+ * @param siz        - Length of the string to search in.
+ * @param pos        - Position at which to begin searching.
+ * @param ptr        - Pointer to the first character of the string identifying
+ *                     characters to search for.
+ * @param count      - Length of the string of characters to search for.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the first found character or -1 if no such character
+ *                     is found.
+ * @return void
+ */
+#define pvt_find_last_of_(not_of, str, siz, pos, ptr, count, ret_offset)                                 \
+    do {                                                                                                 \
+        const void *const chk_p07__ = (const void *)(ptr);                                               \
+        const ptrdiff_t cnt_p07__   = (ptrdiff_t)(count);                                                \
+        const ptrdiff_t siz_p07__   = (ptrdiff_t)(siz);                                                  \
+        ptrdiff_t stroff_p07__      = ((ptrdiff_t)(pos) == -1 || (ptrdiff_t)(pos) >= siz_p07__)          \
+                                          ? siz_p07__ - 1                                                \
+                                          : (ptrdiff_t)(pos);                                            \
+        if (!chk_p07__ || (ptrdiff_t)(pos) < -1 || stroff_p07__ < 0 || cnt_p07__ <= 0) {                 \
+            (ret_offset) = (ptrdiff_t)-1;                                                                \
+        } else if (cnt_p07__ == 1) {                                                                     \
+            pvt_find_last_char_((not_of), (str), stroff_p07__, (ptr), (ret_offset));                     \
+        } else {                                                                                         \
+            (ret_offset) = stroff_p07__;                                                                 \
+            if (!pvt_rfind_of_simd_((str), &(ret_offset), (ptr), cnt_p07__, sizeof(*(str)), (not_of))) { \
+                pvt_charset_t set_p07__;                                                                 \
+                int in_p07__;                                                                            \
+                pvt_make_charset_((ptr), cnt_p07__, set_p07__);                                          \
+                for (; (ret_offset) >= 0; --(ret_offset)) {                                              \
+                    pvt_charset_has_(set_p07__, (str)[(ret_offset)], (ptr), cnt_p07__, in_p07__);        \
+                    if (in_p07__ != (not_of)) {                                                          \
+                        break;                                                                           \
+                    }                                                                                    \
+                }                                                                                        \
+            }                                                                                            \
+        }                                                                                                \
+    } while (0)
+
+/**
+ * @brief pvt_find_sub_ - For internal use, find the first occurrence of the
+ *                        given substring.
+ * @param str        - Pointer to the first character of the string to search
+ *                     in.
+ * @param siz        - Length of the string to search in.
+ * @param pos        - Position at which to start the search.
+ * @param ptr        - Pointer to the first character of the string to search
+ *                     for.
+ * @param count      - Length of the string to search for.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the first character of the found substring or -1 if no
+ *                     such substring is found.
+ * @return void
+ */
+#define pvt_find_sub_(str, siz, pos, ptr, count, ret_offset)                      \
+    do {                                                                          \
+        const void *const chk_p13__ = (const void *)(ptr);                        \
+        pvt_twoway_t crit_p13__     = {0, 0, 0};                                  \
+        if (chk_p13__ && (ptrdiff_t)(count) > 1) {                                \
+            pvt_make_find_sub_crit_((ptr), (ptrdiff_t)(count), crit_p13__);       \
+        }                                                                         \
+        pvt_find_((str), (siz), (pos), (ptr), (count), crit_p13__, (ret_offset)); \
+    } while (0)
+
+/**
+ * @brief pvt_rfind_crit_ - For internal use, find the last occurrence of the
+ *                          given substring.
+ * @param str        - Pointer to the first character of the string to search
+ *                     in.
+ * @param siz        - Length of the string to search in.
+ * @param pos        - Position at which to start the search, proceeded from
+ *                     right to left. -1 means that the whole string is
+ *                     searched.
+ * @param ptr        - Pointer to the first character of the string to search
+ *                     for.
+ * @param count      - Length of the string to search for.
+ * @param crit       - Factorization of the string to search for, calculated
+ *                     using pvt_make_rfind_sub_crit_.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the first character of the found substring or -1 if no
+ *                     such substring is found.
+ * @return void
+ */
+#define pvt_rfind_crit_(str, siz, pos, ptr, count, crit, ret_offset)                                        \
+    do {                                                                                                    \
+        const void *const chk_p14__ = (const void *)(ptr);                                                  \
+        const ptrdiff_t cnt_p14__   = (ptrdiff_t)(count);                                                   \
+        const ptrdiff_t ttl_p14__   = (ptrdiff_t)(siz);                                                     \
+        const ptrdiff_t siz_p14__   = ((ptrdiff_t)(pos) == -1 || (ptrdiff_t)(pos) + cnt_p14__ > ttl_p14__)  \
+                                          ? ttl_p14__                                                       \
+                                          : ((ptrdiff_t)(pos) + cnt_p14__);                                 \
+        if (!chk_p14__ || (ptrdiff_t)(pos) < -1 || cnt_p14__ > siz_p14__ || !siz_p14__ || cnt_p14__ <= 0) { \
+            (ret_offset) = (ptrdiff_t)-1;                                                                   \
+        } else if (cnt_p14__ == siz_p14__) {                                                                \
+            int eq_p14__;                                                                                   \
+            pvt_str_n_eq_((str), (ptr), cnt_p14__, eq_p14__);                                               \
+            (ret_offset) = eq_p14__ ? (ptrdiff_t)0 : (ptrdiff_t)-1;                                         \
+        } else if (cnt_p14__ == 1) {                                                                        \
+            pvt_find_last_char_(0, (str), siz_p14__ - 1, (ptr), (ret_offset));                              \
+        } else {                                                                                            \
+            pvt_twoway_search_(pvt_rev_at_, (str), siz_p14__, (ptr), cnt_p14__, (crit), (ret_offset));      \
+            if ((ret_offset) != -1) {                                                                       \
+                (ret_offset) = siz_p14__ - (ret_offset) - cnt_p14__;                                        \
+            }                                                                                               \
+        }                                                                                                   \
+    } while (0)
+
+/**
+ * @brief pvt_rfind_ - For internal use, find the last occurrence of the given
+ *                     substring.
+ * @param str        - Pointer to the first character of the string to search
+ *                     in.
+ * @param siz        - Length of the string to search in.
+ * @param pos        - Position at which to start the search, proceeded from
+ *                     right to left. -1 means that the whole string is
+ *                     searched.
+ * @param ptr        - Pointer to the first character of the string to search
+ *                     for.
+ * @param count      - Length of the string to search for.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the first character of the found substring or -1 if no
+ *                     such substring is found.
+ * @return void
+ */
+#define pvt_rfind_(str, siz, pos, ptr, count, ret_offset)                               \
+    do {                                                                                \
+        const void *const chk_p26__ = (const void *)(ptr);                              \
+        pvt_twoway_t crit_p26__     = {0, 0, 0};                                        \
+        if (chk_p26__ && (ptrdiff_t)(count) > 1) {                                      \
+            pvt_make_rfind_sub_crit_((ptr), (ptrdiff_t)(count), crit_p26__);            \
+        }                                                                               \
+        pvt_rfind_crit_((str), (siz), (pos), (ptr), (count), crit_p26__, (ret_offset)); \
+    } while (0)
+
+/**
+ * @brief pvt_find_next_ - For internal use, find the next occurrence of the
+ *                         given substring after an occurrence found before.
+ * @details Overlapping occurrences of a periodic substring are found by
+ *          continuing the Two-Way scan with the prefix it already knows to
+ *          match, so no character is compared again for every hit. The scan
+ *          falls back to pvt_find_ after the first mismatch.
+ * @param str     - Pointer to the first character of the string to search in.
+ * @param siz     - Length of the string to search in.
+ * @param ptr     - Pointer to the first character of the string to search for.
+ * @param count   - Length of the string to search for.
+ * @param crit    - Factorization of the string to search for, calculated using
+ *                  pvt_make_find_sub_crit_.
+ * @param overlap - Nonzero to include occurrences that overlap the previous
+ *                  one.
+ * @param offset  - Variable of type `ptrdiff_t` that holds the position of the
+ *                  previous occurrence and receives the position of the next
+ *                  occurrence, or -1 if there is none.
+ * @return void
+ */
+#define pvt_find_next_(str, siz, ptr, count, crit, overlap, offset)                                      \
+    do {                                                                                                 \
+        const ptrdiff_t ttl_p43__ = (ptrdiff_t)(siz);                                                    \
+        const ptrdiff_t cnt_p43__ = (ptrdiff_t)(count);                                                  \
+        ptrdiff_t j_p43__         = (offset) + cnt_p43__;                                                \
+        ptrdiff_t mem_p43__       = 0;                                                                   \
+        if ((overlap) && cnt_p43__ > 1) {                                                                \
+            j_p43__   = (offset) + (crit).per;                                                           \
+            mem_p43__ = (crit).periodic ? cnt_p43__ - (crit).per : 0;                                    \
+        } else if (overlap) {                                                                            \
+            j_p43__ = (offset) + 1;                                                                      \
+        }                                                                                                \
+        (offset) = (ptrdiff_t)-1;                                                                        \
+        while ((offset) == -1 && mem_p43__ > 0 && j_p43__ <= ttl_p43__ - cnt_p43__) {                    \
+            pvt_twoway_try_(pvt_fwd_at_, (str), ttl_p43__, (ptr), cnt_p43__, (crit), j_p43__, mem_p43__, \
+                            (offset));                                                                   \
+        }                                                                                                \
+        if ((offset) == -1) {                                                                            \
+            pvt_find_((str), ttl_p43__, j_p43__, (ptr), cnt_p43__, (crit), (offset));                    \
+        }                                                                                                \
+    } while (0)
+
+/**
+ * @brief pvt_count_ - For internal use, count the occurrences of the given
+ *                     substring.
+ * @param str       - Pointer to the first character of the string to search
+ *                    in.
+ * @param siz       - Length of the string to search in.
+ * @param ptr       - Pointer to the first character of the string to search
+ *                    for.
+ * @param count     - Length of the string to search for.
+ * @param crit      - Factorization of the string to search for, calculated
+ *                    using pvt_make_find_sub_crit_.
+ * @param overlap   - Nonzero to count overlapping occurrences.
+ * @param ret_count - Variable of type `size_t` that receives the number of
+ *                    occurrences.
+ * @return void
+ */
+#define pvt_count_(str, siz, ptr, count, crit, overlap, ret_count)                        \
+    do {                                                                                  \
+        const ptrdiff_t cnt_p27__ = (ptrdiff_t)(count);                                   \
+        ptrdiff_t off_p27__       = (ptrdiff_t)-1;                                        \
+        (ret_count)               = 0;                                                    \
+        if ((str) && cnt_p27__ > 0) {                                                     \
+            pvt_find_((str), (siz), 0, (ptr), cnt_p27__, (crit), off_p27__);              \
+        }                                                                                 \
+        while (off_p27__ != -1) {                                                         \
+            ++(ret_count);                                                                \
+            pvt_find_next_((str), (siz), (ptr), cnt_p27__, (crit), (overlap), off_p27__); \
+        }                                                                                 \
+    } while (0)
+
+/**
+ * @brief pvt_count_sub_ - For internal use, count the occurrences of the given
+ *                         substring.
+ * @param str       - Pointer to the first character of the string to search
+ *                    in.
+ * @param siz       - Length of the string to search in.
+ * @param ptr       - Pointer to the first character of the string to search
+ *                    for.
+ * @param count     - Length of the string to search for.
+ * @param overlap   - Nonzero to count overlapping occurrences.
+ * @param ret_count - Variable of type `size_t` that receives the number of
+ *                    occurrences.
+ * @return void
+ */
+#define pvt_count_sub_(str, siz, ptr, count, overlap, ret_count)                      \
+    do {                                                                              \
+        const void *const chk_p32__ = (const void *)(ptr);                            \
+        pvt_twoway_t crit_p32__     = {0, 0, 0};                                      \
+        if (chk_p32__ && (ptrdiff_t)(count) > 1) {                                    \
+            pvt_make_find_sub_crit_((ptr), (ptrdiff_t)(count), crit_p32__);           \
+        }                                                                             \
+        pvt_count_((str), (siz), (ptr), (count), crit_p32__, (overlap), (ret_count)); \
+    } while (0)
+
+/**
+ * @brief pvt_find_all_ - For internal use, collect the positions of all
+ *                        occurrences of the given substring.
+ * @param str         - Pointer to the first character of the string to search
+ *                      in.
+ * @param siz         - Length of the string to search in.
+ * @param ptr         - Pointer to the first character of the string to search
+ *                      for.
+ * @param count       - Length of the string to search for.
+ * @param crit        - Factorization of the string to search for, calculated
+ *                      using pvt_make_find_sub_crit_.
+ * @param overlap     - Nonzero to include overlapping occurrences.
+ * @param ret_offsets - Variable of type `ptrdiff_t *` that receives the vector
+ *                      of positions.
+ * @return void
+ */
+#define pvt_find_all_(str, siz, ptr, count, crit, overlap, ret_offsets)                   \
+    do {                                                                                  \
+        const ptrdiff_t cnt_p31__ = (ptrdiff_t)(count);                                   \
+        ptrdiff_t off_p31__       = (ptrdiff_t)-1;                                        \
+        cstring_clear(ret_offsets);                                                       \
+        if ((str) && cnt_p31__ > 0) {                                                     \
+            pvt_find_((str), (siz), 0, (ptr), cnt_p31__, (crit), off_p31__);              \
+        }                                                                                 \
+        while (off_p31__ != -1) {                                                         \
+            cstring_push_back((ret_offsets), off_p31__);                                  \
+            pvt_find_next_((str), (siz), (ptr), cnt_p31__, (crit), (overlap), off_p31__); \
+        }                                                                                 \
+    } while (0)
+
+/**
+ * @brief pvt_find_all_sub_ - For internal use, collect the positions of all
+ *                            occurrences of the given substring.
+ * @param str         - Pointer to the first character of the string to search
+ *                      in.
+ * @param siz         - Length of the string to search in.
+ * @param ptr         - Pointer to the first character of the string to search
+ *                      for.
+ * @param count       - Length of the string to search for.
+ * @param overlap     - Nonzero to include overlapping occurrences.
+ * @param ret_offsets - Variable of type `ptrdiff_t *` that receives the vector
+ *                      of positions.
+ * @return void
+ */
+#define pvt_find_all_sub_(str, siz, ptr, count, overlap, ret_offsets)                      \
+    do {                                                                                   \
+        const void *const chk_p33__ = (const void *)(ptr);                                 \
+        pvt_twoway_t crit_p33__     = {0, 0, 0};                                           \
+        if (chk_p33__ && (ptrdiff_t)(count) > 1) {                                         \
+            pvt_make_find_sub_crit_((ptr), (ptrdiff_t)(count), crit_p33__);                \
+        }                                                                                  \
+        pvt_find_all_((str), (siz), (ptr), (count), crit_p33__, (overlap), (ret_offsets)); \
+    } while (0)
+
+/**
+ * @brief pvt_replace_all_ - For internal use, replace all non-overlapping
+ *                           occurrences of a substring.
+ * @details If the string grows, its content is moved to the end of the grown
+ *          buffer first. The result is then written from the front while the
+ *          search proceeds in the moved content. The write position never
+ *          passes the read position because each replacement adds no more than
+ *          its share of the precomputed growth.
+ * @param str    - The cstring.
+ * @param needle - Pointer to the first character of the string to search for.
+ * @param n      - Length of the string to search for.
+ * @param ptr    - Pointer to the first replacement character.
+ * @param count  - Number of consecutive replacement characters.
+ * @return void
+ */
+#define pvt_replace_all_(str, needle, n, ptr, count)                                                              \
+    do {                                                                                                          \
+        const void *const chk_p34__ = (const void *)(needle);                                                     \
+        const ptrdiff_t n_p34__     = (ptrdiff_t)(n);                                                             \
+        const ptrdiff_t cnt_p34__   = (ptrdiff_t)(count);                                                         \
+        const size_t siz_p34__      = cstring_size(str);                                                          \
+        if (chk_p34__ && n_p34__ > 0 && cnt_p34__ >= 0 && (size_t)n_p34__ <= siz_p34__) {                         \
+            pvt_twoway_t crit_p34__ = {0, 0, 0};                                                                  \
+            size_t grow_p34__       = 0, rd_p34__ = 0, wr_p34__ = 0;                                              \
+            ptrdiff_t off_p34__;                                                                                  \
+            if (n_p34__ > 1) {                                                                                    \
+                pvt_make_find_sub_crit_((needle), n_p34__, crit_p34__);                                           \
+            }                                                                                                     \
+            if (cnt_p34__ > n_p34__) {                                                                            \
+                size_t k_p34__;                                                                                   \
+                pvt_count_((str), siz_p34__, (needle), n_p34__, crit_p34__, 0, k_p34__);                          \
+                grow_p34__ = k_p34__ * (size_t)(cnt_p34__ - n_p34__);                                             \
+                if (grow_p34__) {                                                                                 \
+                    if (pvt_ttl_cap_(str) < siz_p34__ + grow_p34__ + 1) {                                         \
+                        pvt_grow_((str), siz_p34__ + grow_p34__ + 1);                                             \
+                    }                                                                                             \
+                    pvt_clib_memmove((str) + grow_p34__, (str), (siz_p34__ + 1) * sizeof(*(str)));                \
+                }                                                                                                 \
+            }                                                                                                     \
+            if (cnt_p34__ <= n_p34__ || grow_p34__) {                                                             \
+                pvt_find_((str) + grow_p34__, siz_p34__, 0, (needle), n_p34__, crit_p34__, off_p34__);            \
+                while (off_p34__ != -1) {                                                                         \
+                    pvt_clib_memmove((str) + wr_p34__, (str) + grow_p34__ + rd_p34__,                             \
+                                     ((size_t)off_p34__ - rd_p34__) * sizeof(*(str)));                            \
+                    wr_p34__ += (size_t)off_p34__ - rd_p34__;                                                     \
+                    pvt_clib_memcpy((str) + wr_p34__, (ptr), (size_t)cnt_p34__ * sizeof(*(str)));                 \
+                    wr_p34__ += (size_t)cnt_p34__;                                                                \
+                    rd_p34__ = (size_t)(off_p34__ + n_p34__);                                                     \
+                    pvt_find_((str) + grow_p34__, siz_p34__, rd_p34__, (needle), n_p34__, crit_p34__, off_p34__); \
+                }                                                                                                 \
+                if (wr_p34__ != grow_p34__ + rd_p34__) {                                                          \
+                    pvt_clib_memmove((str) + wr_p34__, (str) + grow_p34__ + rd_p34__,                             \
+                                     (siz_p34__ - rd_p34__ + 1) * sizeof(*(str)));                                \
+                }                                                                                                 \
+                pvt_set_ttl_siz_((str), siz_p34__ - rd_p34__ + wr_p34__ + 1);                                     \
+            }                                                                                                     \
+        }                                                                                                         \
+    } while (0)
+
+/**
+ * @brief pvt_edit_push_ - For internal use, add an operation to an edit batch.
+ * @details Each operation occupies four elements of the `ops` vector: the
+ *          position, the number of erased characters, the offset of the
+ *          replacement in `text`, and the length of the replacement.
+ * @param edit  - The edit batch.
+ * @param pos   - Position in the original string.
+ * @param n     - Number of erased characters.
+ * @param count - Length of the replacement.
+ * @return void
+ */
+#define pvt_edit_push_(edit, pos, n, count)                 \
+    do {                                                    \
+        const size_t off_p35__ = cstring_size((edit).text); \
+        cstring_push_back((edit).ops, (size_t)(pos));       \
+        cstring_push_back((edit).ops, (size_t)(n));         \
+        cstring_push_back((edit).ops, off_p35__);           \
+        cstring_push_back((edit).ops, (size_t)(count));     \
+    } while (0)
+
+/**
+ * @brief pvt_replacer_feed_ - For internal use, process the next chunk of a
+ *                             streaming replacement.
+ * @details The chunk is appended to the held back tail and the combined text
+ *          is searched. Everything up to the last occurrence is emitted, and of
+ *          the rest only the last `size - 1` characters are held back because
+ *          only they can begin an occurrence that continues in the next chunk.
+ * @param rep   - The replacer.
+ * @param ptr   - Pointer to the first character of the chunk.
+ * @param count - Length of the chunk.
+ * @param out   - The cstring that receives the output.
+ * @return void
+ */
+#define pvt_replacer_feed_(rep, ptr, count, out)                                                          \
+    do {                                                                                                  \
+        size_t siz_p36__, rd_p36__ = 0;                                                                   \
+        ptrdiff_t off_p36__        = (ptrdiff_t)-1;                                                       \
+        cstring_clear(out);                                                                               \
+        if ((size_t)(count)) {                                                                            \
+            cstring_append((rep).carry, (ptr), (size_t)(count));                                          \
+        }                                                                                                 \
+        siz_p36__ = cstring_size((rep).carry);                                                            \
+        if ((rep).size > 0) {                                                                             \
+            pvt_find_((rep).carry, siz_p36__, 0, (rep).needle, (rep).size, (rep).crit, off_p36__);        \
+        }                                                                                                 \
+        while (off_p36__ != -1) {                                                                         \
+            if ((size_t)off_p36__ > rd_p36__) {                                                           \
+                cstring_append((out), (rep).carry + rd_p36__, (size_t)off_p36__ - rd_p36__);              \
+            }                                                                                             \
+            if ((rep).repl_size) {                                                                        \
+                cstring_append((out), (rep).repl, (rep).repl_size);                                       \
+            }                                                                                             \
+            rd_p36__ = (size_t)(off_p36__ + (rep).size);                                                  \
+            pvt_find_((rep).carry, siz_p36__, rd_p36__, (rep).needle, (rep).size, (rep).crit, off_p36__); \
+        }                                                                                                 \
+        if ((rep).size > 0 && siz_p36__ - rd_p36__ >= (size_t)(rep).size) {                               \
+            const size_t keep_p36__ = siz_p36__ - (size_t)((rep).size - 1);                               \
+            cstring_append((out), (rep).carry + rd_p36__, keep_p36__ - rd_p36__);                         \
+            rd_p36__ = keep_p36__;                                                                        \
+        } else if ((rep).size <= 0 && siz_p36__) {                                                        \
+            cstring_append((out), (rep).carry, siz_p36__);                                                \
+            rd_p36__ = siz_p36__;                                                                         \
+        }                                                                                                 \
+        if (rd_p36__) {                                                                                   \
+            cstring_erase((rep).carry, 0, rd_p36__);                                                      \
+        }                                                                                                 \
+    } while (0)
+
+/**
+ * @brief pvt_make_borders_ - For internal use, calculate the length of the
+ *                            longest proper border of each prefix of a string.
+ * @param ptr        - Pointer to the first character of the string.
+ * @param count      - Length of the string, greater than zero.
+ * @param ret_border - Variable of type `size_t *` that receives a vector of
+ *                     `count` elements, managed like a cstring.
+ * @return void
+ */
+#define pvt_make_borders_(ptr, count, ret_border)                 \
+    do {                                                          \
+        size_t i_p38__, k_p38__ = 0;                              \
+        cstring_clear(ret_border);                                \
+        cstring_resize((ret_border), (size_t)(count), 0);         \
+        for (i_p38__ = 1; i_p38__ < (size_t)(count); ++i_p38__) { \
+            while (k_p38__ && (ptr)[k_p38__] != (ptr)[i_p38__]) { \
+                k_p38__ = (ret_border)[k_p38__ - 1];              \
+            }                                                     \
+            if ((ptr)[k_p38__] == (ptr)[i_p38__]) {               \
+                ++k_p38__;                                        \
+            }                                                     \
+            (ret_border)[i_p38__] = k_p38__;                      \
+        }                                                         \
+    } while (0)
+
+/**
+ * @brief pvt_scanner_next_ - For internal use, resume a scanner.
+ * @details A partial occurrence at the end of the scanned part is continued
+ *          character by character (Knuth-Morris-Pratt). As soon as no partial
+ *          occurrence is pending, the rest is searched using pvt_find_. If that
+ *          fails, only the last `size - 1` characters are run through the
+ *          automaton to determine the new partial occurrence.
+ * @param scan       - The scanner.
+ * @param str        - Pointer to the first character of the string.
+ * @param siz        - Length of the string.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the occurrence, or -1.
+ * @return void
+ */
+#define pvt_scanner_next_(scan, str, siz, ret_offset)                                                          \
+    do {                                                                                                       \
+        const size_t siz_p37__ = (size_t)(siz);                                                                \
+        const size_t m_p37__   = (size_t)(scan).size;                                                          \
+        size_t pos_p37__;                                                                                      \
+        (ret_offset) = (ptrdiff_t)-1;                                                                          \
+        if ((scan).scanned > siz_p37__) {                                                                      \
+            cstring_scanner_reset(scan);                                                                       \
+        }                                                                                                      \
+        pos_p37__ = (scan).scanned;                                                                            \
+        if (m_p37__) {                                                                                         \
+            while ((scan).state && pos_p37__ < siz_p37__) {                                                    \
+                pvt_scanner_step_((scan), (str)[pos_p37__]);                                                   \
+                ++pos_p37__;                                                                                   \
+                if ((scan).state == m_p37__) {                                                                 \
+                    (ret_offset) = (ptrdiff_t)(pos_p37__ - m_p37__);                                           \
+                    (scan).state = 0;                                                                          \
+                    break;                                                                                     \
+                }                                                                                              \
+            }                                                                                                  \
+            if ((ret_offset) == -1 && pos_p37__ < siz_p37__) {                                                 \
+                pvt_find_((str), siz_p37__, pos_p37__, (scan).needle, (scan).size, (scan).crit, (ret_offset)); \
+                if ((ret_offset) != -1) {                                                                      \
+                    pos_p37__ = (size_t)(ret_offset) + m_p37__;                                                \
+                } else {                                                                                       \
+                    if (siz_p37__ - pos_p37__ >= m_p37__) {                                                    \
+                        pos_p37__ = siz_p37__ - (m_p37__ - 1);                                                 \
+                    }                                                                                          \
+                    for (; pos_p37__ < siz_p37__; ++pos_p37__) {                                               \
+                        pvt_scanner_step_((scan), (str)[pos_p37__]);                                           \
+                    }                                                                                          \
+                }                                                                                              \
+            }                                                                                                  \
+            (scan).scanned = pos_p37__;                                                                        \
+        }                                                                                                      \
+    } while (0)
+
+/**
+ * @brief pvt_scanner_step_ - For internal use, advance the automaton of a
+ *                            scanner by one character.
+ * @param scan - The scanner.
+ * @param c    - The character.
+ * @return void
+ */
+#define pvt_scanner_step_(scan, c)                                   \
+    do {                                                             \
+        while ((scan).state && (scan).needle[(scan).state] != (c)) { \
+            (scan).state = (scan).border[(scan).state - 1];          \
+        }                                                            \
+        if ((scan).needle[(scan).state] == (c)) {                    \
+            ++(scan).state;                                          \
+        }                                                            \
+    } while (0)
+
+/**
+ * @brief pvt_gap_move_ - For internal use, move the gap of a gap buffer.
+ * @param gb  - The gap buffer.
+ * @param pos - The new position of the gap.
+ * @return void
+ */
+#define pvt_gap_move_(gb, pos)                                                                                      \
+    do {                                                                                                            \
+        const size_t siz_p39__ = cstring_size((gb).buf);                                                            \
+        const size_t pos_p39__ = ((size_t)(pos) < siz_p39__) ? (size_t)(pos) : siz_p39__;                           \
+        if (pos_p39__ < (gb).gap) {                                                                                 \
+            const size_t n_p39__ = (gb).gap - pos_p39__;                                                            \
+            pvt_clib_memmove((gb).buf + (gb).gap_end - n_p39__, (gb).buf + pos_p39__, n_p39__ * sizeof(*(gb).buf)); \
+            (gb).gap -= n_p39__;                                                                                    \
+            (gb).gap_end -= n_p39__;                                                                                \
+        } else if (pos_p39__ > (gb).gap) {                                                                          \
+            const size_t n_p39__ = pos_p39__ - (gb).gap;                                                            \
+            pvt_clib_memmove((gb).buf + (gb).gap, (gb).buf + (gb).gap_end, n_p39__ * sizeof(*(gb).buf));            \
+            (gb).gap += n_p39__;                                                                                    \
+            (gb).gap_end += n_p39__;                                                                                \
+        }                                                                                                           \
+    } while (0)
+
+/**
+ * @brief pvt_gap_reserve_ - For internal use, ensure that the gap of a gap
+ *                           buffer can take `count` more characters.
+ * @details One element of the gap is always kept free for the terminator
+ *          written by `cstring_gap_flatten()`. To grow the buffer, the text
+ *          behind the gap is moved to the gap first, so that the content is
+ *          contiguous within the size recorded in the metadata, which is what
+ *          the allocators preserve. Afterwards it's moved to the end of the
+ *          grown buffer.
+ * @param gb    - The gap buffer.
+ * @param count - Number of characters to make room for.
+ * @return void
+ */
+#define pvt_gap_reserve_(gb, count)                                                                         \
+    do {                                                                                                    \
+        if (!(gb).buf) {                                                                                    \
+            pvt_grow_amortized_((gb).buf, (size_t)(count) + 1);                                             \
+            pvt_set_ttl_siz_((gb).buf, 1);                                                                  \
+            (gb).gap     = 0;                                                                               \
+            (gb).gap_end = pvt_ttl_cap_((gb).buf);                                                          \
+        } else if ((gb).gap_end - (gb).gap < (size_t)(count) + 1) {                                         \
+            const size_t tail_p40__ = pvt_ttl_cap_((gb).buf) - (gb).gap_end;                                \
+            pvt_clib_memmove((gb).buf + (gb).gap, (gb).buf + (gb).gap_end, tail_p40__ * sizeof(*(gb).buf)); \
+            pvt_grow_amortized_((gb).buf, pvt_ttl_siz_((gb).buf) + (size_t)(count));                        \
+            (gb).gap_end = pvt_ttl_cap_((gb).buf) - tail_p40__;                                             \
+            pvt_clib_memmove((gb).buf + (gb).gap_end, (gb).buf + (gb).gap, tail_p40__ * sizeof(*(gb).buf)); \
+        }                                                                                                   \
+    } while (0)
+
+/**
+ * @brief pvt_rope_find_as_ - For internal use, find the first occurrence of a
+ *                            string in a rope, reading the characters as
+ *                            `type`.
+ * @details Each chunk is searched from `pos` up to its end. If that fails, the
+ *          occurrences which begin in the last `count - 1` characters of the
+ *          chunk are checked using pvt_rope_match_, which walks the following
+ *          leaves without copying them.
+ * @param type       - Unsigned integer type of the size of the characters.
+ * @param root       - The root node of the rope.
+ * @param pos        - Position at which to start the search.
+ * @param ptr        - Pointer to the first character of the string to search
+ *                     for.
+ * @param count      - Length of the string to search for.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position
+ *                     of the occurrence or -1.
+ * @return void
+ */
+#define pvt_rope_find_as_(type, root, pos, ptr, count, ret_offset)                                                       \
+    do {                                                                                                                 \
+        const type *const ndl_p41__ = (const type *)(ptr);                                                               \
+        const size_t siz_p41__      = (root) ? (root)->size : (size_t)0;                                                 \
+        const ptrdiff_t cnt_p41__   = (ptrdiff_t)(count);                                                                \
+        size_t at_p41__             = (size_t)(pos);                                                                     \
+        (ret_offset)                = (ptrdiff_t)-1;                                                                     \
+        if (ndl_p41__ && cnt_p41__ > 0 && (ptrdiff_t)(pos) >= 0 && at_p41__ + (size_t)cnt_p41__ <= siz_p41__) {          \
+            const size_t lap_p41__  = (size_t)cnt_p41__ - 1;                                                             \
+            pvt_twoway_t crit_p41__ = {0, 0, 0};                                                                         \
+            if (lap_p41__) {                                                                                             \
+                pvt_make_find_sub_crit_(ndl_p41__, cnt_p41__, crit_p41__);                                               \
+            }                                                                                                            \
+            while (at_p41__ < siz_p41__ && (ret_offset) == -1) {                                                         \
+                size_t len_p41__;                                                                                        \
+                ptrdiff_t off_p41__;                                                                                     \
+                const type *const chr_p41__ = (const type *)pvt_rope_chunk_((root), at_p41__, sizeof(type), &len_p41__); \
+                pvt_find_(chr_p41__, len_p41__, 0, ndl_p41__, cnt_p41__, crit_p41__, off_p41__);                         \
+                if (off_p41__ != -1) {                                                                                   \
+                    (ret_offset) = (ptrdiff_t)at_p41__ + off_p41__;                                                      \
+                } else if (lap_p41__) {                                                                                  \
+                    const size_t end_p41__ = at_p41__ + len_p41__;                                                       \
+                    size_t beg_p41__       = (len_p41__ > lap_p41__) ? end_p41__ - lap_p41__ : at_p41__;                 \
+                    for (; beg_p41__ < end_p41__ && beg_p41__ + (size_t)cnt_p41__ <= siz_p41__; ++beg_p41__) {           \
+                        if (chr_p41__[beg_p41__ - at_p41__] == *ndl_p41__ &&                                             \
+                            pvt_rope_match_((root), beg_p41__, ndl_p41__, (size_t)cnt_p41__, sizeof(type))) {            \
+                            (ret_offset) = (ptrdiff_t)beg_p41__;                                                         \
+                            break;                                                                                       \
+                        }                                                                                                \
+                    }                                                                                                    \
+                }                                                                                                        \
+                at_p41__ += len_p41__;                                                                                   \
+            }                                                                                                            \
+        }                                                                                                                \
+    } while (0)
+
+/**
+ * @brief pvt_compare_ - For internal use, lexicographically compare two
+ *                       strings.
+ * @param str1      - Pointer to the first character of the first string.
+ * @param siz1      - Length of the first string.
+ * @param str2      - Pointer to the first character of the second string.
+ * @param siz2      - Length of the second string.
+ * @param ret_order - Variable of type `int` that receives -1, 0, or 1.
+ * @return void
+ */
+#define pvt_compare_(str1, siz1, str2, siz2, ret_order)                                                                                     \
+    do {                                                                                                                                    \
+        const size_t siz1_p15__ = (size_t)(siz1), siz2_p15__ = (size_t)(siz2);                                                              \
+        const size_t siz_p15__  = (siz1_p15__ < siz2_p15__) ? siz1_p15__ : siz2_p15__;                                                      \
+        const size_t i_p15__    = pvt_find_mismatch_((str1), (str2), siz_p15__, sizeof(*(str1)));                                           \
+        if (i_p15__ == siz_p15__) {                                                                                                         \
+            (ret_order) = (siz1_p15__ == siz2_p15__) ? 0 : ((siz1_p15__ < siz2_p15__) ? -1 : 1);                                            \
+        } else {                                                                                                                            \
+            static const size_t tpmsk_p15__ = pvt_get_typemask_(str1);                                                                      \
+            (ret_order)                     = (((size_t)(str1)[i_p15__] & tpmsk_p15__) < ((size_t)(str2)[i_p15__] & tpmsk_p15__)) ? -1 : 1; \
+        }                                                                                                                                   \
+    } while (0)
+
+/**
+ * @brief pvt_mismatch_ - For internal use, find the first position at which
+ *                        two strings differ.
+ * @param str1       - Pointer to the first character of the first string.
+ * @param siz1       - Length of the first string.
+ * @param str2       - Pointer to the first character of the second string.
+ * @param siz2       - Length of the second string.
+ * @param ret_offset - Variable of type `ptrdiff_t` that receives the position,
+ *                     or -1 if the strings are equal.
+ * @return void
+ */
+#define pvt_mismatch_(str1, siz1, str2, siz2, ret_offset)                                                    \
+    do {                                                                                                     \
+        const size_t siz1_p29__ = (size_t)(siz1), siz2_p29__ = (size_t)(siz2);                               \
+        const size_t siz_p29__  = (siz1_p29__ < siz2_p29__) ? siz1_p29__ : siz2_p29__;                       \
+        (ret_offset)            = (ptrdiff_t)pvt_find_mismatch_((str1), (str2), siz_p29__, sizeof(*(str1))); \
+        if ((size_t)(ret_offset) == siz_p29__ && siz1_p29__ == siz2_p29__) {                                 \
+            (ret_offset) = (ptrdiff_t)-1;                                                                    \
+        }                                                                                                    \
+    } while (0)
+
+/**
+ * @brief pvt_equal_ - For internal use, check the equality of two strings.
+ * @details Strings of different length are told apart without reading them.
+ * @param str1      - Pointer to the first character of the first string.
+ * @param siz1      - Length of the first string.
+ * @param str2      - Pointer to the first character of the second string.
+ * @param siz2      - Length of the second string.
+ * @param ret_equal - Variable of type `int` that receives 0 or 1.
+ * @return void
+ */
+#define pvt_equal_(str1, siz1, str2, siz2, ret_equal)              \
+    do {                                                           \
+        const size_t siz_p30__ = (size_t)(siz1);                   \
+        (ret_equal)            = (siz_p30__ == (size_t)(siz2));    \
+        if ((ret_equal) && siz_p30__) {                            \
+            pvt_str_n_eq_((str1), (str2), siz_p30__, (ret_equal)); \
+        }                                                          \
+    } while (0)
+
+/**
+ * @brief pvt_starts_with_ - For internal use, check if a string begins with the
+ *                           given prefix.
+ * @param str       - Pointer to the first character of the string.
+ * @param siz       - Length of the string.
+ * @param ptr       - Pointer to the first character of the prefix.
+ * @param count     - Length of the prefix.
+ * @param ret_found - Variable of type `int` that receives 0 or 1.
+ * @return void
+ */
+#define pvt_starts_with_(str, siz, ptr, count, ret_found)                        \
+    do {                                                                         \
+        const void *const chk_p16__  = (const void *)(ptr);                      \
+        const ptrdiff_t subsiz_p16__ = (ptrdiff_t)(count);                       \
+        (ret_found)                  = 0;                                        \
+        if (chk_p16__ && subsiz_p16__ > 0 && subsiz_p16__ <= (ptrdiff_t)(siz)) { \
+            pvt_str_n_eq_((str), (ptr), subsiz_p16__, (ret_found));              \
+        }                                                                        \
+    } while (0)
+
+/**
+ * @brief pvt_ends_with_ - For internal use, check if a string ends with the
+ *                         given suffix.
+ * @param str       - Pointer to the first character of the string.
+ * @param siz       - Length of the string.
+ * @param ptr       - Pointer to the first character of the suffix.
+ * @param count     - Length of the suffix.
+ * @param ret_found - Variable of type `int` that receives 0 or 1.
+ * @return void
+ */
+#define pvt_ends_with_(str, siz, ptr, count, ret_found)                                        \
+    do {                                                                                       \
+        const void *const chk_p17__  = (const void *)(ptr);                                    \
+        const ptrdiff_t subsiz_p17__ = (ptrdiff_t)(count);                                     \
+        const ptrdiff_t siz_p17__    = (ptrdiff_t)(siz);                                       \
+        (ret_found)                  = 0;                                                      \
+        if (chk_p17__ && subsiz_p17__ > 0 && subsiz_p17__ <= siz_p17__) {                      \
+            pvt_str_n_eq_((str) + siz_p17__ - subsiz_p17__, (ptr), subsiz_p17__, (ret_found)); \
+        }                                                                                      \
+    } while (0)
+
+/**
+ * @brief pvt_contains_ - For internal use, check if a string contains the given
+ *                        substring.
+ * @param str       - Pointer to the first character of the string.
+ * @param siz       - Length of the string.
+ * @param ptr       - Pointer to the first character of the substring.
+ * @param count     - Length of the substring.
+ * @param ret_found - Variable of type `int` that receives 0 or 1.
+ * @return void
+ */
+#define pvt_contains_(str, siz, ptr, count, ret_found)             \
+    do {                                                           \
+        ptrdiff_t off_p18__;                                       \
+        pvt_find_sub_((str), (siz), 0, (ptr), (count), off_p18__); \
+        (ret_found) = (off_p18__ >= 0);                            \
+    } while (0)
+
+/**
+ * @brief pvt_split_crit_ - For internal use, tokenize a string into a
+ *                          cstring_array vector.
+ * @param str       - Pointer to the first character of the string.
+ * @param siz       - Length of the string.
+ * @param max_tok   - Maximum number of tokens to be created. -1 specifies that
+ *                    all tokens are created.
+ * @param ptr       - Pointer to the first character of the delimiter string.
+ * @param count     - Number of consecutive characters to be used as delimiter.
+ * @param crit      - Factorization of the delimiter string, calculated using
+ *                    pvt_make_find_sub_crit_.
+ * @param ret_array - Variable of cstring_array(type) that receives the created
+ *                    vector.
+ * @return void
+ */
+#define pvt_split_crit_(str, siz, max_tok, ptr, count, crit, ret_array)                               \
+    do {                                                                                              \
+        const void *const chk_p19__ = (const void *)(ptr);                                            \
+        const ptrdiff_t cnt_p19__   = (ptrdiff_t)(count);                                             \
+        const size_t siz_p19__      = (size_t)(siz);                                                  \
+        cstring_array_clear(ret_array);                                                               \
+        if ((str) && (max_tok) && (ptrdiff_t)(max_tok) > -2 && chk_p19__ && cnt_p19__ > 0) {          \
+            ptrdiff_t off_p19__;                                                                      \
+            ptrdiff_t beg_p19__       = 0;                                                            \
+            size_t i_p19__            = 0;                                                            \
+            const size_t delcnt_p19__ = (size_t)(max_tok) - (size_t)1;                                \
+            cstring_array_reserve((ret_array), 63);                                                   \
+            pvt_set_ttl_siz_((ret_array), 1);                                                         \
+            pvt_find_((str), siz_p19__, beg_p19__, (ptr), cnt_p19__, (crit), off_p19__);              \
+            for (; off_p19__ != -1 && i_p19__ < delcnt_p19__; ++i_p19__) {                            \
+                cstring_push_back((ret_array), NULL);                                                 \
+                pvt_elem_assign_((ret_array), i_p19__, (str) + beg_p19__, off_p19__ - beg_p19__);     \
+                beg_p19__ = off_p19__ + cnt_p19__;                                                    \
+                pvt_find_((str), siz_p19__, beg_p19__, (ptr), cnt_p19__, (crit), off_p19__);          \
+            }                                                                                         \
+            cstring_push_back((ret_array), NULL);                                                     \
+            pvt_elem_assign_((ret_array), i_p19__, (str) + beg_p19__, siz_p19__ - (size_t)beg_p19__); \
+            (ret_array)[i_p19__ + 1] = NULL;                                                          \
+        }                                                                                             \
+    } while (0)
+
+/**
+ * @brief pvt_split_ - For internal use, tokenize a string into a cstring_array
+ *                     vector.
+ * @param str       - Pointer to the first character of the string.
+ * @param siz       - Length of the string.
+ * @param max_tok   - Maximum number of tokens to be created. -1 specifies that
+ *                    all tokens are created.
+ * @param ptr       - Pointer to the first character of the delimiter string.
+ * @param count     - Number of consecutive characters to be used as delimiter.
+ * @param ret_array - Variable of cstring_array(type) that receives the created
+ *                    vector.
+ * @return void
+ */
+#define pvt_split_(str, siz, max_tok, ptr, count, ret_array)                               \
+    do {                                                                                   \
+        const void *const chk_p25__ = (const void *)(ptr);                                 \
+        pvt_twoway_t crit_p25__     = {0, 0, 0};                                           \
+        if (chk_p25__ && (ptrdiff_t)(count) > 1) {                                         \
+            pvt_make_find_sub_crit_((ptr), (ptrdiff_t)(count), crit_p25__);                \
+        }                                                                                  \
+        pvt_split_crit_((str), (siz), (max_tok), (ptr), (count), crit_p25__, (ret_array)); \
+    } while (0)
+
+/**
+ * @brief pvt_split_into_ - For internal use, tokenize a string into an existing
+ *                          cstring_array vector.
+ * @param str       - Pointer to the first character of the string.
+ * @param siz       - Length of the string.
+ * @param max_tok   - Maximum number of tokens to be created.
+ * @param ptr       - Pointer to the first character of the delimiter string.
+ * @param count     - Number of consecutive characters to be used as delimiter.
+ * @param ret_array - Variable of cstring_array(type) that receives the created
+ *                    vector.
+ * @return void
+ */
+#define pvt_split_into_(str, siz, max_tok, ptr, count, ret_array)                                              \
+    do {                                                                                                       \
+        const void *const chk_p21__ = (const void *)(ptr);                                                     \
+        const ptrdiff_t cnt_p21__   = (ptrdiff_t)(count);                                                      \
+        const size_t siz_p21__      = (size_t)(siz);                                                           \
+        const size_t old_p21__      = cstring_size(ret_array);                                                 \
+        size_t i_p21__              = 0;                                                                       \
+        if ((str) && (max_tok) && (ptrdiff_t)(max_tok) > -2 && chk_p21__ && cnt_p21__ > 0) {                   \
+            ptrdiff_t off_p21__;                                                                               \
+            ptrdiff_t beg_p21__       = 0;                                                                     \
+            pvt_twoway_t crit_p21__   = {0, 0, 0};                                                             \
+            const size_t delcnt_p21__ = (size_t)(max_tok) - (size_t)1;                                         \
+            if (cnt_p21__ > 1) {                                                                               \
+                pvt_make_find_sub_crit_((ptr), cnt_p21__, crit_p21__);                                         \
+            }                                                                                                  \
+            pvt_find_((str), siz_p21__, beg_p21__, (ptr), cnt_p21__, crit_p21__, off_p21__);                   \
+            for (; off_p21__ != -1 && i_p21__ < delcnt_p21__; ++i_p21__) {                                     \
+                pvt_split_put_((ret_array), i_p21__, old_p21__, (str) + beg_p21__, off_p21__ - beg_p21__);     \
+                beg_p21__ = off_p21__ + cnt_p21__;                                                             \
+                pvt_find_((str), siz_p21__, beg_p21__, (ptr), cnt_p21__, crit_p21__, off_p21__);               \
+            }                                                                                                  \
+            pvt_split_put_((ret_array), i_p21__, old_p21__, (str) + beg_p21__, siz_p21__ - (size_t)beg_p21__); \
+            ++i_p21__;                                                                                         \
+        }                                                                                                      \
+        if (ret_array) {                                                                                       \
+            size_t j_p21__ = i_p21__;                                                                          \
+            for (; j_p21__ < old_p21__; ++j_p21__) {                                                           \
+                pvt_free_((ret_array)[j_p21__]);                                                               \
+            }                                                                                                  \
+            pvt_set_ttl_siz_((ret_array), i_p21__ + 1);                                                        \
+            (ret_array)[i_p21__] = NULL;                                                                       \
+        }                                                                                                      \
+    } while (0)
+
+/**
+ * @brief pvt_split_put_ - For internal use, store a token in a cstring_array
+ *                         vector, reusing an existing string if possible.
+ * @param arr   - The cstring_array.
+ * @param pos   - Position of the token.
+ * @param old   - Number of existing strings in the vector.
+ * @param ptr   - Pointer to the first character of the token.
+ * @param count - Length of the token.
+ * @return void
+ */
+#define pvt_split_put_(arr, pos, old, ptr, count)               \
+    do {                                                        \
+        if ((size_t)(pos) < (size_t)(old)) {                    \
+            cstring_assign((arr)[pos], (ptr), (size_t)(count)); \
+        } else {                                                \
+            cstring_push_back((arr), NULL);                     \
+            pvt_elem_assign_((arr), (pos), (ptr), (count));     \
+        }                                                       \
+    } while (0)
+
+/**
+ * @brief pvt_view_sub_ - For internal use, let a view refer to a part of a
+ *                        string.
+ * @param str      - Pointer to the first character of the string.
+ * @param siz      - Length of the string.
+ * @param pos      - Position where the view begins.
+ * @param n        - Number of consecutive characters.
+ * @param ret_view - The cstring_view that receives the result.
+ * @return void
+ */
+#define pvt_view_sub_(str, siz, pos, n, ret_view)                                                             \
+    do {                                                                                                      \
+        const size_t siz_p20__ = (size_t)(siz);                                                               \
+        const size_t pos_p20__ = ((size_t)(pos) < siz_p20__) ? (size_t)(pos) : siz_p20__;                     \
+        (ret_view).data        = (str) ? (str) + pos_p20__ : (str);                                           \
+        (ret_view).size        = ((size_t)(n) < siz_p20__ - pos_p20__) ? (size_t)(n) : siz_p20__ - pos_p20__; \
+    } while (0)
+
+/**
+ * @brief pvt_tokenizer_init_ - For internal use, initialize a tokenizer.
+ * @param tok     - The tokenizer.
+ * @param str     - Pointer to the first character of the string.
+ * @param siz     - Length of the string.
+ * @param max_tok - Maximum number of tokens to be yielded.
+ * @param ptr     - Pointer to the first character of the delimiter string.
+ * @param count   - Number of consecutive characters to be used as delimiter.
+ * @return void
+ */
+#define pvt_tokenizer_init_(tok, str, siz, max_tok, ptr, count)                                            \
+    do {                                                                                                   \
+        (tok).data       = (str);                                                                          \
+        (tok).size       = (size_t)(siz);                                                                  \
+        (tok).delim      = (ptr);                                                                          \
+        (tok).delim_size = (ptrdiff_t)(count);                                                             \
+        (tok).remaining  = (size_t)(max_tok) - (size_t)1;                                                  \
+        if ((tok).data && (max_tok) && (ptrdiff_t)(max_tok) > -2 && (tok).delim && (tok).delim_size > 0) { \
+            (tok).pos = 0;                                                                                 \
+            pvt_make_find_sub_crit_((tok).delim, (tok).delim_size, (tok).crit);                            \
+        } else {                                                                                           \
+            (tok).pos = (ptrdiff_t)-1;                                                                     \
+        }                                                                                                  \
+    } while (0)
+
+/**
+ * @brief pvt_inline_ - For internal use, the function specifier of functions
+ *                      defined in this header.
+ */
+#if defined(_MSC_VER)
+#define pvt_inline_ static __inline
+#elif defined(__GNUC__)
+#define pvt_inline_ static __inline__
+#else
+#define pvt_inline_ static
+#endif
+
+/**
+ * @brief pvt_kernel_ - For internal use, the function specifier of the
+ *                      vectorized search kernels.
+ * @details The kernels are called out of line. Inlined into the caller, GCC
+ *          checks their vector loads against the block a string was allocated
+ *          in, without being able to relate it to the length passed.
+ */
+#if defined(_MSC_VER)
+#define pvt_kernel_ static __declspec(noinline)
+#elif defined(__GNUC__)
+#define pvt_kernel_ static __attribute__((__noinline__, __unused__))
+#else
+#define pvt_kernel_ static
+#endif
+
+/**
+ * @brief pvt_thread_local_ - For internal use, the storage class specifier of
+ *                            per-thread data.
+ */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define pvt_thread_local_ _Thread_local
+#elif defined(_MSC_VER)
+#define pvt_thread_local_ __declspec(thread)
+#elif defined(__GNUC__)
+#define pvt_thread_local_ __thread
+#else
+#define pvt_thread_local_
+#endif
+
+/* the slab allocator always obtains its chunks from the C library */
+#include <stdlib.h>
+#include <string.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+/* the caches of exiting threads are handed over to the remaining threads, define `pvt_no_slab_exit` if the platform has no thread exit hook */
+#if !defined(pvt_no_slab_exit)
+#if defined(_WIN32)
+#include <windows.h>
+#define pvt_slab_exit_hook_
+#elif defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#define pvt_slab_exit_hook_
+#endif
+#endif
+
+/**
+ * @brief pvt_slab_classes_ - For internal use, the number of size classes.
+ */
+#define pvt_slab_classes_ 27
+
+/**
+ * @brief pvt_slab_max_ - For internal use, the size of the biggest size class.
+ */
+#define pvt_slab_max_ 4096
+
+/**
+ * @brief pvt_slab_head_t - For internal use, header that precedes every block
+ *                          of the slab allocator.
+ * @details The members other than `info` make the header as big as the
+ *          strictest fundamental alignment, so that the blocks are suitably
+ *          aligned for any type, like those of `malloc`.
+ */
+typedef union pvt_slab_head_ {
+    struct {
+        struct pvt_slab_chunk_ *chunk; /*!< The chunk of the block, NULL for blocks passed through to the C library. */
+        size_t size;                   /*!< The requested size of a block passed through to the C library. */
+    } info;
+    long double align_ld; /*!< Alignment only. */
+    double align_d;       /*!< Alignment only. */
+    long align_l;         /*!< Alignment only. */
+    void *align_p;        /*!< Alignment only. */
+    void (*align_f)(void); /*!< Alignment only. */
+} pvt_slab_head_t;
+
+/**
+ * @brief pvt_slab_chunk_ - For internal use, header of a chunk of equally
+ *                          sized blocks.
+ */
+typedef struct pvt_slab_chunk_ {
+    struct pvt_slab_chunk_ *next; /*!< The next chunk owned by the same thread. */
+    const void *owner;            /*!< The thread cache that owns the chunk. */
+    size_t cls;                   /*!< The size class of the blocks. */
+    size_t count;                 /*!< The number of blocks in the chunk. */
+    size_t tally;                 /*!< Counter of cached blocks, updated in pvt_slab_release_. */
+} pvt_slab_chunk_t;
+
+/**
+ * @brief pvt_slab_lead_ - For internal use, the offset of the first block in a
+ *                         chunk.
+ */
+#define pvt_slab_lead_ \
+    ((sizeof(pvt_slab_chunk_t) + sizeof(pvt_slab_head_t) - 1) / sizeof(pvt_slab_head_t) * sizeof(pvt_slab_head_t))
+
+/**
+ * @brief pvt_slab_cache_ - For internal use, the per-thread state of the slab
+ *                          allocator.
+ */
+typedef struct pvt_slab_cache_ {
+    pvt_slab_head_t *free[pvt_slab_classes_];  /*!< Lists of released blocks. */
+    char *bump[pvt_slab_classes_];             /*!< Next block not yet carved from the current chunk. */
+    char *end[pvt_slab_classes_];              /*!< End of the current chunk. */
+    pvt_slab_chunk_t *cur[pvt_slab_classes_];  /*!< The current chunk. */
+    pvt_slab_chunk_t *chunks;                  /*!< All chunks owned by the thread. */
+    int attached;                              /*!< 1 if the thread exit hook is registered for the cache. */
+} pvt_slab_cache_t;
+
+/**
+ * @brief pvt_slab_next_ - For internal use, access the link of a cached block.
+ * @param head - Pointer to the header of the block.
+ * @return The next cached block as lvalue of type `pvt_slab_head_t *`.
+ */
+#define pvt_slab_next_(head) \
+    (*(pvt_slab_head_t **)(void *)((head) + 1))
+
+/**
+ * @brief pvt_slab_size_ - For internal use, get the block size of a size class.
+ * @param cls - The size class.
+ * @return The size in bytes.
+ */
+pvt_inline_ size_t pvt_slab_size_(size_t cls) {
+    static const unsigned short sizes[pvt_slab_classes_] = {
+        32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448,
+        512, 640, 768, 896, 1024, 1280, 1536, 1792, 2048, 2560, 3072, 3584, 4096};
+    return (size_t)sizes[cls];
+}
+
+/**
+ * @brief pvt_slab_class_ - For internal use, get the smallest size class that
+ *                          fits the requested size.
+ * @param size - The requested size, not greater than pvt_slab_max_.
+ * @return The size class.
+ */
+pvt_inline_ size_t pvt_slab_class_(size_t size) {
+    size_t cls = (size <= 128) ? ((size <= 32) ? 0 : (size - 17) / 16) : 7;
+    while (pvt_slab_size_(cls) < size) {
+        ++cls;
+    }
+    return cls;
+}
+
+/**
+ * @brief pvt_slab_orphans_ - For internal use, get the chunks and cached blocks
+ *                            left behind by exited threads.
+ * @details Only accessed while pvt_slab_lock_ is held.
+ * @return Pointer to the cache of exited threads.
+ */
+pvt_inline_ pvt_slab_cache_t *pvt_slab_orphans_(void) {
+    static pvt_slab_cache_t orphans;
+    return &orphans;
+}
+
+/**
+ * @brief pvt_slab_adopt_ - For internal use, move the chunks and cached blocks
+ *                          of a cache to another cache.
+ * @param cache - The receiving cache.
+ * @param donor - The cache whose content is moved.
+ * @return void
+ */
+pvt_inline_ void pvt_slab_adopt_(pvt_slab_cache_t *cache, pvt_slab_cache_t *donor) {
+    pvt_slab_chunk_t *chunk;
+    size_t cls;
+    if (donor->chunks) {
+        for (chunk = donor->chunks;; chunk = chunk->next) {
+            chunk->owner = cache;
+            if (!chunk->next) {
+                break;
+            }
+        }
+        chunk->next   = cache->chunks;
+        cache->chunks = donor->chunks;
+        donor->chunks = NULL;
+    }
+    for (cls = 0; cls < pvt_slab_classes_; ++cls) {
+        pvt_slab_head_t *head = donor->free[cls];
+        if (head) {
+            while (pvt_slab_next_(head)) {
+                head = pvt_slab_next_(head);
+            }
+            pvt_slab_next_(head) = cache->free[cls];
+            cache->free[cls]     = donor->free[cls];
+            donor->free[cls]     = NULL;
+        }
+    }
+}
+
+/**
+ * @brief pvt_slab_release_ - For internal use, return all chunks of a thread
+ *                            cache that do not contain any block in use to the
+ *                            system.
+ * @param cache - The thread cache.
+ * @return void
+ */
+pvt_inline_ void pvt_slab_release_(pvt_slab_cache_t *cache) {
+    pvt_slab_chunk_t **link;
+    pvt_slab_chunk_t *chunk;
+    size_t cls;
+    for (chunk = cache->chunks; chunk; chunk = chunk->next) {
+        chunk->tally = 0;
+    }
+    /* count the cached blocks of each chunk owned by this thread */
+    for (cls = 0; cls < pvt_slab_classes_; ++cls) {
+        pvt_slab_head_t *head;
+        for (head = cache->free[cls]; head; head = pvt_slab_next_(head)) {
+            chunk = head->info.chunk;
+            if (chunk->owner == cache) {
+                ++chunk->tally;
+            }
+        }
+        if (cache->cur[cls]) {
+            cache->cur[cls]->tally += (size_t)(cache->end[cls] - cache->bump[cls]) / (sizeof(pvt_slab_head_t) + pvt_slab_size_(cls));
+        }
+    }
+    /* unlink the blocks of chunks that are about to be released */
+    for (cls = 0; cls < pvt_slab_classes_; ++cls) {
+        pvt_slab_head_t **headlink = &cache->free[cls];
+        while (*headlink) {
+            chunk = (*headlink)->info.chunk;
+            if (chunk->owner == cache && chunk->tally == chunk->count) {
+                *headlink = pvt_slab_next_(*headlink);
+            } else {
+                headlink = &pvt_slab_next_(*headlink);
+            }
+        }
+        if (cache->cur[cls] && cache->cur[cls]->tally == cache->cur[cls]->count) {
+            cache->cur[cls]  = NULL;
+            cache->bump[cls] = NULL;
+            cache->end[cls]  = NULL;
+        }
+    }
+    link = &cache->chunks;
+    while (*link) {
+        chunk = *link;
+        if (chunk->tally == chunk->count) {
+            *link = chunk->next;
+            free(chunk);
+        } else {
+            link = &chunk->next;
+        }
+    }
+}
+
+#ifdef pvt_slab_exit_hook_
+/**
+ * @brief pvt_slab_lock_ - For internal use, acquire or release the lock that
+ *                         protects the cache of exited threads.
+ * @param acquire - Non-zero to acquire the lock, zero to release it.
+ * @return void
+ */
+pvt_inline_ void pvt_slab_lock_(int acquire) {
+#if defined(_WIN32)
+    static SRWLOCK lock = SRWLOCK_INIT;
+    if (acquire) {
+        AcquireSRWLockExclusive(&lock);
+    } else {
+        ReleaseSRWLockExclusive(&lock);
+    }
+#else
+    static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    if (acquire) {
+        pthread_mutex_lock(&lock);
+    } else {
+        pthread_mutex_unlock(&lock);
+    }
+#endif
+}
+
+/**
+ * @brief pvt_slab_detach_ - For internal use, release the cache of an exiting
+ *                           thread.
+ * @details Chunks that do not contain any block in use are returned to the
+ *          system. The remaining chunks and the cached blocks are handed over
+ *          to the cache of exited threads, which is adopted by the next thread
+ *          that attaches its cache or calls cstring_slab_trim.
+ * @param cache - The thread cache.
+ * @return void
+ */
+pvt_inline_ void pvt_slab_detach_(pvt_slab_cache_t *cache) {
+    size_t cls;
+    pvt_slab_release_(cache);
+    /* the blocks not yet carved from the current chunks become cached blocks */
+    for (cls = 0; cls < pvt_slab_classes_; ++cls) {
+        const size_t blk = sizeof(pvt_slab_head_t) + pvt_slab_size_(cls);
+        for (; cache->bump[cls] != cache->end[cls]; cache->bump[cls] += blk) {
+            pvt_slab_head_t *const head = (pvt_slab_head_t *)(void *)cache->bump[cls];
+            head->info.chunk            = cache->cur[cls];
+            pvt_slab_next_(head)        = cache->free[cls];
+            cache->free[cls]            = head;
+        }
+        cache->cur[cls]  = NULL;
+        cache->bump[cls] = NULL;
+        cache->end[cls]  = NULL;
+    }
+    pvt_slab_lock_(1);
+    pvt_slab_adopt_(pvt_slab_orphans_(), cache);
+    pvt_slab_lock_(0);
+    cache->attached = 0;
+}
+
+/**
+ * @brief pvt_slab_exit_ - For internal use, the callback of the thread exit
+ *                         hook.
+ * @param cache - The thread cache.
+ * @return void
+ */
+#if defined(_WIN32)
+pvt_inline_ VOID NTAPI pvt_slab_exit_(PVOID cache) {
+    pvt_slab_detach_((pvt_slab_cache_t *)cache);
+}
+#else
+pvt_inline_ void pvt_slab_exit_(void *cache) {
+    pvt_slab_detach_((pvt_slab_cache_t *)cache);
+}
+#endif
+
+/**
+ * @brief pvt_slab_attach_ - For internal use, register the thread exit hook
+ *                           for the cache of the calling thread, and adopt the
+ *                           chunks and cached blocks of exited threads.
+ * @param cache - The thread cache.
+ * @return void
+ */
+pvt_inline_ void pvt_slab_attach_(pvt_slab_cache_t *cache) {
+    static int created;
+#if defined(_WIN32)
+    static DWORD key;
+#else
+    static pthread_key_t key;
+#endif
+    int hooked;
+    pvt_slab_lock_(1);
+    if (!created) {
+#if defined(_WIN32)
+        key     = FlsAlloc(pvt_slab_exit_);
+        created = (key != FLS_OUT_OF_INDEXES) ? 1 : -1;
+#else
+        created = (pthread_key_create(&key, pvt_slab_exit_) == 0) ? 1 : -1;
+#endif
+    }
+    hooked = (created == 1);
+    pvt_slab_adopt_(cache, pvt_slab_orphans_());
+    pvt_slab_lock_(0);
+    if (hooked) {
+#if defined(_WIN32)
+        FlsSetValue(key, cache);
+#else
+        pthread_setspecific(key, cache);
+#endif
+    }
+    cache->attached = 1;
+}
+#endif
+
+/**
+ * @brief pvt_slab_cache_get_ - For internal use, get the cache of the calling
+ *                              thread.
+ * @return Pointer to the thread cache.
+ */
+pvt_inline_ pvt_slab_cache_t *pvt_slab_cache_get_(void) {
+    static pvt_thread_local_ pvt_slab_cache_t cache;
+#ifdef pvt_slab_exit_hook_
+    if (!cache.attached) {
+        pvt_slab_attach_(&cache);
+    }
+#endif
+    return &cache;
+}
+
+/**
+ * @brief pvt_slab_malloc_ - For internal use, implementation of
+ *                           cstring_slab_malloc.
+ * @details Every block is prefixed with a pvt_slab_head_t that refers to its
+ *          chunk. The chunk is NULL for blocks passed through to the C library,
+ *          whose header records the requested size instead.
+ * @param size - Number of bytes to allocate.
+ * @return Pointer to the allocated block, or NULL.
+ */
+pvt_inline_ void *pvt_slab_malloc_(size_t size) {
+    pvt_slab_head_t *head;
+    if (size > pvt_slab_max_) {
+        head = (pvt_slab_head_t *)malloc(sizeof(*head) + size);
+        if (!head) {
+            return NULL;
+        }
+        head->info.chunk = NULL;
+        head->info.size  = size;
+    } else {
+        pvt_slab_cache_t *const cache = pvt_slab_cache_get_();
+        const size_t cls              = pvt_slab_class_(size);
+        head                          = cache->free[cls];
+        if (head) {
+            cache->free[cls] = pvt_slab_next_(head);
+        } else {
+            const size_t blk = sizeof(*head) + pvt_slab_size_(cls);
+            if (cache->bump[cls] == cache->end[cls]) {
+                const size_t count      = (65536 / blk < 8) ? 8 : 65536 / blk;
+                pvt_slab_chunk_t *chunk = (pvt_slab_chunk_t *)malloc(pvt_slab_lead_ + count * blk);
+                if (!chunk) {
+                    return NULL;
+                }
+                chunk->next       = cache->chunks;
+                chunk->owner      = cache;
+                chunk->cls        = cls;
+                chunk->count      = count;
+                chunk->tally      = 0;
+                cache->chunks     = chunk;
+                cache->cur[cls]   = chunk;
+                cache->bump[cls]  = (char *)chunk + pvt_slab_lead_;
+                cache->end[cls]   = cache->bump[cls] + count * blk;
+            }
+            head             = (pvt_slab_head_t *)(void *)cache->bump[cls];
+            head->info.chunk = cache->cur[cls];
+            cache->bump[cls] += blk;
+        }
+    }
+    return head + 1;
+}
+
+/**
+ * @brief pvt_slab_free_ - For internal use, implementation of
+ *                         cstring_slab_free.
+ * @param ptr - Pointer to the block. Can be NULL.
+ * @return void
+ */
+pvt_inline_ void pvt_slab_free_(void *ptr) {
+    if (ptr) {
+        pvt_slab_head_t *const head = (pvt_slab_head_t *)ptr - 1;
+        if (head->info.chunk) {
+            pvt_slab_cache_t *const cache = pvt_slab_cache_get_();
+            const size_t cls              = head->info.chunk->cls;
+            pvt_slab_next_(head)          = cache->free[cls];
+            cache->free[cls]              = head;
+        } else {
+            free(head);
+        }
+    }
+}
+
+/**
+ * @brief pvt_slab_realloc_ - For internal use, implementation of
+ *                            cstring_slab_realloc.
+ * @param ptr  - Pointer to the block, or NULL.
+ * @param size - New size of the block in bytes.
+ * @return Pointer to the resized block, or NULL.
+ */
+pvt_inline_ void *pvt_slab_realloc_(void *ptr, size_t size) {
+    pvt_slab_head_t *head;
+    void *newptr;
+    size_t keep = size;
+    if (!ptr) {
+        return pvt_slab_malloc_(size);
+    }
+    head = (pvt_slab_head_t *)ptr - 1;
+    if (head->info.chunk) {
+        const size_t cls = head->info.chunk->cls;
+        if (size <= pvt_slab_size_(cls) && (cls == 0 || size > pvt_slab_size_(cls - 1))) {
+            return ptr;
+        }
+        if (keep > pvt_slab_size_(cls)) {
+            keep = pvt_slab_size_(cls);
+        }
+    } else if (size > pvt_slab_max_) {
+        head = (pvt_slab_head_t *)realloc(head, sizeof(*head) + size);
+        if (!head) {
+            return NULL;
+        }
+        head->info.size = size;
+        return head + 1;
+    } else if (keep > head->info.size) {
+        keep = head->info.size;
+    }
+    newptr = pvt_slab_malloc_(size);
+    if (newptr) {
+        pvt_clib_memcpy(newptr, ptr, keep);
+        pvt_slab_free_(ptr);
+    }
+    return newptr;
+}
+
+/**
+ * @brief pvt_slab_usable_size_ - For internal use, implementation of
+ *                                cstring_slab_usable_size.
+ * @param ptr - Pointer to the block.
+ * @return The usable size in bytes.
+ */
+pvt_inline_ size_t pvt_slab_usable_size_(void *ptr) {
+    const pvt_slab_head_t *const head = (const pvt_slab_head_t *)ptr - 1;
+    return head->info.chunk ? pvt_slab_size_(head->info.chunk->cls) : head->info.size;
+}
+
+/**
+ * @brief pvt_slab_trim_ - For internal use, implementation of
+ *                         cstring_slab_trim.
+ * @return void
+ */
+pvt_inline_ void pvt_slab_trim_(void) {
+    pvt_slab_cache_t *const cache = pvt_slab_cache_get_();
+#ifdef pvt_slab_exit_hook_
+    pvt_slab_lock_(1);
+    pvt_slab_adopt_(cache, pvt_slab_orphans_());
+    pvt_slab_lock_(0);
+#endif
+    pvt_slab_release_(cache);
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+}
+
+/**
+ * @brief pvt_clib_fn_ - For internal use, the entry point of objects that are
+ *                       not bound to an allocator.
+ * @details Requests are fulfilled using the `pvt_clib_*` functions. Unlike the
+ *          entry points of the cstring_allocator_api, the objects have no
+ *          prefix, and `unused` is NULL. Calling it in place of a NULL `unused`
+ *          keeps every call of `pvt_clib_realloc` and `pvt_clib_free` on the
+ *          metadata in a function that only receives heap blocks.
+ * @param req - Pointer to a `pvt_alloc_req_t`.
+ * @return void
+ */
+pvt_inline_ void pvt_clib_fn_(void *req) {
+    pvt_alloc_req_t *const r = (pvt_alloc_req_t *)req;
+    if (!r->size) {
+        pvt_clib_free(r->base);
+    } else if (r->base && r->keep > sizeof(pvt_metadata_t)) {
+        r->base = (pvt_metadata_t *)pvt_clib_realloc(r->base, r->size);
+    } else {
+        if (r->base) {
+            pvt_clib_free(r->base);
+        }
+        r->base = (pvt_metadata_t *)pvt_clib_malloc(r->size);
+        pvt_clib_assert(r->base);
+        r->base->unused = NULL;
+    }
+}
+
+/**
+ * @brief pvt_arena_align_ - For internal use, the alignment of the blocks
+ *                           allocated in an arena.
+ */
+#define pvt_arena_align_ (2 * sizeof(void *))
+
+/**
+ * @brief pvt_arena_chunk_size_ - For internal use, the default chunk size of an
+ *                                arena.
+ */
+#define pvt_arena_chunk_size_ 4096
+
+/**
+ * @brief pvt_arena_chunk_ - For internal use, header of a chunk of an arena.
+ */
+typedef union pvt_arena_chunk_ {
+    struct {
+        union pvt_arena_chunk_ *prev; /*!< The chunk allocated before. */
+        char *end;                    /*!< End of the chunk. */
+    } hdr;
+    char align[2 * pvt_arena_align_]; /*!< Keeps the payload aligned. */
+} pvt_arena_chunk_t;
+
+/**
+ * @brief pvt_arena_ - For internal use, the state of an arena.
+ */
+typedef struct pvt_arena_ {
+    pvt_arena_chunk_t *chunk; /*!< The current chunk. */
+    char *top;                /*!< Next free byte of the current chunk. */
+    char *end;                /*!< End of the current chunk. */
+    pvt_metadata_t *last;     /*!< The most recently allocated object. */
+    size_t chunk_size;        /*!< Minimum chunk size in bytes. */
+} pvt_arena_t;
+
+/**
+ * @brief pvt_arena_mark_ - For internal use, a checkpoint of an arena.
+ */
+typedef struct pvt_arena_mark_ {
+    pvt_arena_chunk_t *chunk; /*!< The current chunk at the checkpoint. */
+    char *top;                /*!< Next free byte at the checkpoint. */
+} pvt_arena_mark_t;
+
+/**
+ * @brief pvt_arena_round_ - For internal use, round a size up to the alignment
+ *                           of the arena.
+ * @param size - The size in bytes.
+ * @return The rounded size.
+ */
+pvt_inline_ size_t pvt_arena_round_(size_t size) {
+    return (size + pvt_arena_align_ - 1) & ~(size_t)(pvt_arena_align_ - 1);
+}
+
+/**
+ * @brief pvt_arena_init_ - For internal use, implementation of
+ *                          cstring_arena_init.
+ * @param arena      - Pointer to the arena.
+ * @param chunk_size - Minimum chunk size, zero for the default.
+ * @return void
+ */
+pvt_inline_ void pvt_arena_init_(pvt_arena_t *arena, size_t chunk_size) {
+    arena->chunk      = NULL;
+    arena->top        = NULL;
+    arena->end        = NULL;
+    arena->last       = NULL;
+    arena->chunk_size = pvt_arena_round_(chunk_size ? chunk_size : pvt_arena_chunk_size_);
+}
+
+/**
+ * @brief pvt_arena_alloc_ - For internal use, bump-allocate a block from an
+ *                           arena.
+ * @param arena - Pointer to the arena.
+ * @param size  - Number of bytes to allocate.
+ * @return Pointer to the block, or NULL.
+ */
+pvt_inline_ char *pvt_arena_alloc_(pvt_arena_t *arena, size_t size) {
+    char *blk;
+    size = pvt_arena_round_(size);
+    if (!arena->chunk || (size_t)(arena->end - arena->top) < size) {
+        const size_t payload     = (size > arena->chunk_size) ? size : arena->chunk_size;
+        pvt_arena_chunk_t *chunk = (pvt_arena_chunk_t *)pvt_clib_malloc(sizeof(pvt_arena_chunk_t) + payload);
+        if (!chunk) {
+            return NULL;
+        }
+        chunk->hdr.prev = arena->chunk;
+        chunk->hdr.end  = (char *)(chunk + 1) + payload;
+        arena->chunk    = chunk;
+        arena->top      = (char *)(chunk + 1);
+        arena->end      = chunk->hdr.end;
+    }
+    blk = arena->top;
+    arena->top += size;
+    return blk;
+}
+
+/**
+ * @brief pvt_arena_fn_ - For internal use, the entry point of the arena
+ *                        allocator.
+ * @details Every object is prefixed with the pointer to its arena. Releasing
+ *          an object is a no-op.
+ * @param req - Pointer to a `pvt_alloc_req_t`.
+ * @return void
+ */
+pvt_inline_ void pvt_arena_fn_(void *req) {
+    pvt_alloc_req_t *const r = (pvt_alloc_req_t *)req;
+    pvt_arena_t *arena;
+    pvt_metadata_t *base;
+    char *blk;
+    if (!r->size) {
+        return;
+    }
+    arena = (pvt_arena_t *)(r->base ? pvt_ctx_(r->base) : r->ctx);
+    if (r->base && r->base == arena->last) {
+        /* the object is the last one of the current chunk, try to resize it in place */
+        blk = (char *)r->base - sizeof(void *);
+        if ((size_t)(arena->end - blk) >= pvt_arena_round_(sizeof(void *) + r->size)) {
+            arena->top = blk + pvt_arena_round_(sizeof(void *) + r->size);
+            return;
+        }
+    }
+    blk = pvt_arena_alloc_(arena, sizeof(void *) + r->size);
+    if (!blk) {
+        r->base = NULL;
+        return;
+    }
+    base = (pvt_metadata_t *)(void *)(blk + sizeof(void *));
+    if (r->base) {
+        pvt_clib_memcpy(base, r->base, (r->keep < r->size) ? r->keep : r->size);
+    }
+    cstring_allocator_bind(base, pvt_arena_fn_, arena);
+    arena->last = base;
+    r->base     = base;
+}
+
+/**
+ * @brief pvt_arena_rollback_ - For internal use, implementation of
+ *                              cstring_arena_rollback.
+ * @param arena - Pointer to the arena.
+ * @param chunk - The current chunk at the checkpoint.
+ * @param top   - Next free byte at the checkpoint.
+ * @return void
+ */
+pvt_inline_ void pvt_arena_rollback_(pvt_arena_t *arena, pvt_arena_chunk_t *chunk, char *top) {
+    while (arena->chunk != chunk) {
+        pvt_arena_chunk_t *const prev = arena->chunk->hdr.prev;
+        pvt_clib_free(arena->chunk);
+        arena->chunk = prev;
+    }
+    arena->top  = top;
+    arena->end  = chunk ? chunk->hdr.end : NULL;
+    arena->last = NULL;
+}
+
+/**
+ * @brief pvt_arena_reset_ - For internal use, implementation of
+ *                           cstring_arena_reset and cstring_arena_release.
+ * @param arena - Pointer to the arena.
+ * @param keep  - Non-zero to keep the first chunk.
+ * @return void
+ */
+pvt_inline_ void pvt_arena_reset_(pvt_arena_t *arena, int keep) {
+    pvt_arena_chunk_t *first = arena->chunk;
+    while (first && first->hdr.prev) {
+        first = first->hdr.prev;
+    }
+    if (keep && first) {
+        pvt_arena_rollback_(arena, first, (char *)(first + 1));
+    } else {
+        pvt_arena_rollback_(arena, NULL, NULL);
+    }
+}
+
+/**
+ * @brief pvt_prefixed_fn_ - For internal use, common implementation of
+ *                           allocator entry points on top of a
+ *                           malloc/realloc/free family.
+ * @param req        - Pointer to a `pvt_alloc_req_t`.
+ * @param alloc_fn   - The entry point to bind to the object.
+ * @param realloc_fn - The realloc function, called with NULL to allocate.
+ * @param free_fn    - The free function.
+ * @return void
+ */
+pvt_inline_ void pvt_prefixed_fn_(pvt_alloc_req_t *req, void (*alloc_fn)(void *), void *(*realloc_fn)(void *, size_t), void (*free_fn)(void *)) {
+    char *blk = req->base ? (char *)req->base - sizeof(void *) : NULL;
+    void *ctx = req->base ? pvt_ctx_(req->base) : req->ctx;
+    if (!req->size) {
+        free_fn(blk);
+        return;
+    }
+    blk = (char *)realloc_fn(blk, sizeof(void *) + req->size);
+    if (!blk) {
+        req->base = NULL;
+        return;
+    }
+    req->base = (pvt_metadata_t *)(void *)(blk + sizeof(void *));
+    cstring_allocator_bind(req->base, alloc_fn, ctx);
+}
+
+/**
+ * @brief pvt_clib_realloc_fn_ - For internal use, `pvt_clib_realloc` as a
+ *                               function.
+ */
+pvt_inline_ void *pvt_clib_realloc_fn_(void *ptr, size_t size) {
+    return pvt_clib_realloc(ptr, size);
+}
+
+/**
+ * @brief pvt_clib_free_fn_ - For internal use, `pvt_clib_free` as a function.
+ */
+pvt_inline_ void pvt_clib_free_fn_(void *ptr) {
+    pvt_clib_free(ptr);
+}
+
+/**
+ * @brief pvt_heap_fn_ - For internal use, the entry point of the heap
+ *                       allocator.
+ * @param req - Pointer to a `pvt_alloc_req_t`.
+ * @return void
+ */
+pvt_inline_ void pvt_heap_fn_(void *req) {
+    pvt_prefixed_fn_((pvt_alloc_req_t *)req, pvt_heap_fn_, pvt_clib_realloc_fn_, pvt_clib_free_fn_);
+}
+
+/**
+ * @brief pvt_slab_fn_ - For internal use, the entry point of the slab
+ *                       allocator.
+ * @param req - Pointer to a `pvt_alloc_req_t`.
+ * @return void
+ */
+pvt_inline_ void pvt_slab_fn_(void *req) {
+    pvt_prefixed_fn_((pvt_alloc_req_t *)req, pvt_slab_fn_, pvt_slab_realloc_, pvt_slab_free_);
+}
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_WIN32) && !defined(pvt_no_mmap)
+#include <sys/mman.h>
+#include <unistd.h>
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
+
+#if defined(MAP_ANONYMOUS)
+/**
+ * @brief pvt_mmap_fn_ - For internal use, the entry point of the mmap
+ *                       allocator.
+ * @details The prefix of an object holds the length of its mapping. Objects
+ *          are resized in place as long as they fit into the mapping.
+ * @param req - Pointer to a `pvt_alloc_req_t`.
+ * @return void
+ */
+pvt_inline_ void pvt_mmap_fn_(void *req) {
+    pvt_alloc_req_t *const r = (pvt_alloc_req_t *)req;
+    char *const old          = r->base ? (char *)r->base - sizeof(void *) : NULL;
+    const size_t oldlen      = r->base ? (size_t)pvt_ctx_(r->base) : 0;
+    size_t pagesize;
+    size_t len;
+    char *blk;
+    if (!r->size) {
+        munmap(old, oldlen);
+        return;
+    }
+    if (sizeof(void *) + r->size <= oldlen) {
+        return;
+    }
+    pagesize = (size_t)sysconf(_SC_PAGESIZE);
+    len      = (sizeof(void *) + r->size + pagesize - 1) / pagesize * pagesize;
+    blk      = (char *)mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (blk == (char *)MAP_FAILED) {
+        r->base = NULL;
+        return;
+    }
+    if (old) {
+        pvt_clib_memcpy(blk + sizeof(void *), r->base, (r->keep < r->size) ? r->keep : r->size);
+        munmap(old, oldlen);
+    }
+    r->base = (pvt_metadata_t *)(void *)(blk + sizeof(void *));
+    cstring_allocator_bind(r->base, pvt_mmap_fn_, len);
+}
+#else
+#define pvt_mmap_fn_ pvt_heap_fn_
+#endif
+
+/**
+ * @brief pvt_local_fn_ - For internal use, the entry point bound to a
+ *                        cstring_local.
+ * @details The prefix holds the size of the buffer in bytes, incl. metadata.
+ *          Releasing the buffer is a no-op. If it is outgrown, the content is
+ *          moved to a block of the `pvt_clib_*` functions, which is not bound
+ *          to an allocator.
+ * @param req - Pointer to a `pvt_alloc_req_t`.
+ * @return void
+ */
+pvt_inline_ void pvt_local_fn_(void *req) {
+    pvt_alloc_req_t *const r = (pvt_alloc_req_t *)req;
+    pvt_metadata_t *base;
+    if (!r->size) {
+        return;
+    }
+    if (r->base && r->size <= (size_t)pvt_ctx_(r->base)) {
+        r->size = (size_t)pvt_ctx_(r->base);
+        return;
+    }
+    base = (pvt_metadata_t *)pvt_clib_malloc(r->size);
+    if (base && r->base) {
+        pvt_clib_memcpy(base, r->base, (r->keep < r->size) ? r->keep : r->size);
+    }
+    if (base) {
+        base->unused = NULL;
+    }
+    r->base = base;
+}
+
+/**
+ * @brief pvt_local_init_ - For internal use, set up the buffer of a
+ *                          cstring_local as an empty string bound to
+ *                          pvt_local_fn_.
+ * @param buf    - The buffer, suitably aligned for the metadata.
+ * @param bytes  - The size of the buffer in bytes, incl. prefix and metadata.
+ * @param elsize - The size of a character.
+ * @return The data pointer of the string.
+ */
+pvt_inline_ void *pvt_local_init_(unsigned char *buf, size_t bytes, size_t elsize) {
+    pvt_metadata_t *const base = (pvt_metadata_t *)(void *)(buf + sizeof(void *));
+    unsigned char *const data  = (unsigned char *)(void *)(base + 1);
+    size_t i;
+    cstring_allocator_bind(base, pvt_local_fn_, bytes - sizeof(void *));
+    base->size     = 1;
+    base->capacity = (bytes - sizeof(void *) - sizeof(pvt_metadata_t)) / elsize;
+    for (i = 0; i < elsize; ++i) {
+        data[i] = 0;
+    }
+    return data;
+}
+
+/**
+ * @brief pvt_packed_slot_ - For internal use, get the size of the slot of a
+ *                           string in a packed cstring_array.
+ * @param len    - The number of characters.
+ * @param elsize - The size of a character.
+ * @return The size in bytes, incl. the context prefix and metadata.
+ */
+pvt_inline_ size_t pvt_packed_slot_(size_t len, size_t elsize) {
+    return (sizeof(void *) + sizeof(pvt_metadata_t) + (len + 1) * elsize + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+}
+
+/**
+ * @brief pvt_packed_bound_ - For internal use, get an upper bound of the
+ *                            payload of a packed cstring_array.
+ * @param n      - The number of strings.
+ * @param total  - The total number of characters of all strings.
+ * @param elsize - The size of a character.
+ * @return The size in bytes.
+ */
+pvt_inline_ size_t pvt_packed_bound_(size_t n, size_t total, size_t elsize) {
+    return n * pvt_packed_slot_(0, elsize) + total * elsize + n * (sizeof(void *) - 1);
+}
+
+/**
+ * @brief pvt_packed_fn_ - For internal use, the entry point bound to a packed
+ *                         cstring_array.
+ * @details The vector is resized in place as long as it fits into its part of
+ *          the block. Otherwise, it is converted into an ordinary
+ *          cstring_array by moving the vector and the strings still stored in
+ *          their slots to blocks of the `pvt_clib_*` functions, and the whole
+ *          block is released. New strings of a packed vector are not bound to
+ *          an allocator.
+ * @param req - Pointer to a `pvt_alloc_req_t`.
+ * @return void
+ */
+pvt_inline_ void pvt_packed_fn_(void *req) {
+    pvt_alloc_req_t *const r   = (pvt_alloc_req_t *)req;
+    pvt_metadata_t *const base = r->base;
+    pvt_metadata_t *moved;
+    size_t vecsize, keep, elsize, n, i;
+    void **vec;
+    if (!base) {
+        moved = (pvt_metadata_t *)pvt_clib_malloc(r->size);
+        if (moved) {
+            moved->unused = NULL;
+        }
+        r->base = moved;
+        return;
+    }
+    if (!r->size) {
+        pvt_clib_free((char *)base - sizeof(void *));
+        return;
+    }
+    vecsize = sizeof(pvt_metadata_t) + base->capacity * sizeof(void *);
+    if (r->size <= vecsize) {
+        r->size = vecsize;
+        return;
+    }
+    moved = (pvt_metadata_t *)pvt_clib_malloc(r->size);
+    if (!moved) {
+        r->base = NULL;
+        return;
+    }
+    keep = (r->keep < r->size) ? r->keep : r->size;
+    pvt_clib_memcpy(moved, base, keep);
+    moved->unused = NULL;
+    elsize        = (size_t)pvt_ctx_(base);
+    n             = (keep - sizeof(pvt_metadata_t)) / sizeof(void *);
+    if (n > base->size - 1) {
+        n = base->size - 1;
+    }
+    vec = (void **)(moved + 1);
+    for (i = 0; i < n; ++i) {
+        pvt_metadata_t *const elem = pvt_dat_to_base_(vec[i]);
+        if (elem->unused == pvt_local_fn_) {
+            const size_t bytes         = sizeof(pvt_metadata_t) + elem->size * elsize;
+            pvt_metadata_t *const copy = (pvt_metadata_t *)pvt_clib_malloc(bytes);
+            pvt_clib_assert(copy);
+            pvt_clib_memcpy(copy, elem, bytes);
+            copy->capacity = elem->size;
+            copy->unused   = NULL;
+            vec[i]         = copy + 1;
+        }
+    }
+    pvt_clib_free((char *)base - sizeof(void *));
+    r->base = moved;
+}
+
+/**
+ * @brief pvt_packed_new_ - For internal use, allocate a packed cstring_array.
+ * @details The block consists of the context prefix holding `elsize`, the
+ *          metadata and pointers of the vector, and the slots of the strings.
+ *          The vector is empty, and `*ret_slot` receives the first slot.
+ * @param n        - The capacity of the vector.
+ * @param payload  - The number of bytes reserved for the slots.
+ * @param elsize   - The size of a character.
+ * @param ret_slot - Receives the pointer to the first slot.
+ * @return The data pointer of the vector, or NULL.
+ */
+pvt_inline_ void *pvt_packed_new_(size_t n, size_t payload, size_t elsize, char **ret_slot) {
+    const size_t head = sizeof(void *) + sizeof(pvt_metadata_t) + (n + 1) * sizeof(void *);
+    char *const blk   = (char *)pvt_clib_malloc(head + payload);
+    pvt_metadata_t *base;
+    if (!blk) {
+        return NULL;
+    }
+    base = (pvt_metadata_t *)(void *)(blk + sizeof(void *));
+    cstring_allocator_bind(base, pvt_packed_fn_, elsize);
+    base->size           = 1;
+    base->capacity       = n + 1;
+    *(void **)(base + 1) = NULL;
+    *ret_slot            = blk + head;
+    return base + 1;
+}
+
+/**
+ * @brief pvt_packed_put_ - For internal use, copy a string into the next slot
+ *                          of a packed cstring_array.
+ * @param slot   - Pointer to the slot pointer, advanced to the next slot.
+ * @param ptr    - Pointer to the first character.
+ * @param len    - The number of characters.
+ * @param elsize - The size of a character.
+ * @return The data pointer of the new string.
+ */
+pvt_inline_ void *pvt_packed_put_(char **slot, const void *ptr, size_t len, size_t elsize) {
+    const size_t slotsize      = pvt_packed_slot_(len, elsize);
+    pvt_metadata_t *const base = (pvt_metadata_t *)(void *)(*slot + sizeof(void *));
+    char *const dat            = (char *)(base + 1);
+    cstring_allocator_bind(base, pvt_local_fn_, slotsize - sizeof(void *));
+    base->size     = len + 1;
+    base->capacity = (slotsize - sizeof(void *) - sizeof(pvt_metadata_t)) / elsize;
+    if (len) {
+        pvt_clib_memcpy(dat, ptr, len * elsize);
+    }
+    pvt_clib_memset(dat + len * elsize, 0, elsize);
+    *slot += slotsize;
+    return dat;
+}
+
+/**
+ * @brief pvt_array_pack_ - For internal use, copy a cstring_array into a
+ *                          packed cstring_array.
+ * @param arr    - The data pointer of the cstring_array.
+ * @param elsize - The size of a character.
+ * @return The data pointer of the packed vector, or NULL.
+ */
+pvt_inline_ void *pvt_array_pack_(void *arr, size_t elsize) {
+    void **const vec = (void **)arr;
+    const size_t n   = pvt_dat_to_base_(arr)->size - 1;
+    size_t payload   = 0;
+    size_t i;
+    void **packed;
+    char *slot = NULL;
+    for (i = 0; i < n; ++i) {
+        payload += pvt_packed_slot_(pvt_dat_to_base_(vec[i])->size - 1, elsize);
+    }
+    packed = (void **)pvt_packed_new_(n, payload, elsize, &slot);
+    if (packed) {
+        for (i = 0; i < n; ++i) {
+            packed[i] = pvt_packed_put_(&slot, vec[i], pvt_dat_to_base_(vec[i])->size - 1, elsize);
+        }
+        packed[n]                      = NULL;
+        pvt_dat_to_base_(packed)->size = n + 1;
+    }
+    return packed;
+}
+
+/* ------------------------------ */
+/* --- vectorized text search --- */
+
+#include <wchar.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief pvt_ctz_ - For internal use, count the trailing zero bits.
+ * @param mask - The bit mask, must not be 0.
+ * @return The position of the lowest set bit.
+ */
+pvt_inline_ unsigned pvt_ctz_(unsigned mask) {
+#if defined(__GNUC__)
+    return (unsigned)__builtin_ctz(mask);
+#elif defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return (unsigned)idx;
+#else
+    unsigned idx = 0;
+    for (; !(mask & 1U); mask >>= 1) {
+        ++idx;
+    }
+    return idx;
+#endif
+}
+
+/**
+ * @brief pvt_msb_ - For internal use, get the position of the highest set bit.
+ * @param mask - The bit mask, must not be 0.
+ * @return The position of the highest set bit.
+ */
+pvt_inline_ unsigned pvt_msb_(unsigned mask) {
+#if defined(__GNUC__)
+    return (unsigned)(sizeof(unsigned) * CHAR_BIT - 1) - (unsigned)__builtin_clz(mask);
+#elif defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanReverse(&idx, mask);
+    return (unsigned)idx;
+#else
+    unsigned idx = 0;
+    for (; mask >>= 1;) {
+        ++idx;
+    }
+    return idx;
+#endif
+}
+
+#if defined(pvt_simd_avx2_)
+typedef __m256i pvt_simd_t;
+#define pvt_simd_bytes_ 32
+#define pvt_simd_all_ 0xFFFFFFFFU
+#define pvt_simd_loadu_(p) _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define pvt_simd_mask_(v) ((unsigned)_mm256_movemask_epi8(v))
+#define pvt_simd_and_ _mm256_and_si256
+#define pvt_simd_or_ _mm256_or_si256
+#define pvt_simd_eq8_ _mm256_cmpeq_epi8
+#define pvt_simd_eq16_ _mm256_cmpeq_epi16
+#define pvt_simd_eq32_ _mm256_cmpeq_epi32
+#define pvt_simd_set8_ _mm256_set1_epi8
+#define pvt_simd_set16_ _mm256_set1_epi16
+#define pvt_simd_set32_ _mm256_set1_epi32
+#elif defined(pvt_simd_sse2_)
+typedef __m128i pvt_simd_t;
+#define pvt_simd_bytes_ 16
+#define pvt_simd_all_ 0xFFFFU
+#define pvt_simd_loadu_(p) _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define pvt_simd_mask_(v) ((unsigned)_mm_movemask_epi8(v))
+#define pvt_simd_and_ _mm_and_si128
+#define pvt_simd_or_ _mm_or_si128
+#define pvt_simd_eq8_ _mm_cmpeq_epi8
+#define pvt_simd_eq16_ _mm_cmpeq_epi16
+#define pvt_simd_eq32_ _mm_cmpeq_epi32
+#define pvt_simd_set8_ _mm_set1_epi8
+#define pvt_simd_set16_ _mm_set1_epi16
+#define pvt_simd_set32_ _mm_set1_epi32
+#endif
+
+#if defined(pvt_simd_bytes_)
+/**
+ * @brief pvt_simd_bcast_ - For internal use, fill all lanes of a vector with a
+ *                          character.
+ * @param ptr    - Pointer to the character.
+ * @param elsize - Size of the character in bytes, either 1, 2 or 4.
+ * @return The vector.
+ */
+pvt_inline_ pvt_simd_t pvt_simd_bcast_(const void *ptr, size_t elsize) {
+    unsigned short u16;
+    unsigned int u32;
+    switch (elsize) {
+        case 1:
+            return pvt_simd_set8_(*(const char *)ptr);
+        case 2:
+            pvt_clib_memcpy(&u16, ptr, sizeof(u16));
+            return pvt_simd_set16_((short)u16);
+        default:
+            pvt_clib_memcpy(&u32, ptr, sizeof(u32));
+            return pvt_simd_set32_((int)u32);
+    }
+}
+
+/**
+ * @brief pvt_simd_eq_ - For internal use, compare the characters in the lanes
+ *                       of two vectors.
+ * @param a      - The first vector.
+ * @param b      - The second vector.
+ * @param elsize - Size of the characters in bytes, either 1, 2 or 4.
+ * @return Vector with all bits set in the lanes of equal characters.
+ */
+pvt_inline_ pvt_simd_t pvt_simd_eq_(pvt_simd_t a, pvt_simd_t b, size_t elsize) {
+    switch (elsize) {
+        case 1:
+            return pvt_simd_eq8_(a, b);
+        case 2:
+            return pvt_simd_eq16_(a, b);
+        default:
+            return pvt_simd_eq32_(a, b);
+    }
+}
+
+/**
+ * @brief pvt_simd_of_mask_ - For internal use, classify the characters of a
+ *                            vector using a small character set.
+ * @param s      - Pointer to the characters to be loaded.
+ * @param set    - Vectors filled with the characters of the set.
+ * @param count  - The number of characters in the set.
+ * @param elsize - Size of the characters in bytes, either 1, 2 or 4.
+ * @return Bit mask of the bytes of the characters that are in the set.
+ */
+pvt_inline_ unsigned pvt_simd_of_mask_(const char *s, const pvt_simd_t *set, ptrdiff_t count, size_t elsize) {
+    const pvt_simd_t v = pvt_simd_loadu_(s);
+    pvt_simd_t acc     = pvt_simd_eq_(v, set[0], elsize);
+    ptrdiff_t k        = 1;
+    for (; k < count; ++k) {
+        acc = pvt_simd_or_(acc, pvt_simd_eq_(v, set[k], elsize));
+    }
+    return pvt_simd_mask_(acc);
+}
+#endif
+
+/**
+ * @brief pvt_find_simd_ - For internal use, find the first occurrence of a
+ *                         substring using vector instructions.
+ * @details Positions where both the first and the last character of the
+ *          substring match are filtered for a whole vector at once, and only
+ *          those are compared. If the comparisons get too expensive for the
+ *          characters scanned, the search is given up to keep the worst case
+ *          linear.
+ * @param str    - Pointer to the first character of the string to search in.
+ * @param siz    - Length of the string to search in.
+ * @param ptr    - Pointer to the first character of the string to search for.
+ * @param count  - Length of the string to search for, at least 2.
+ * @param elsize - Size of the characters in bytes.
+ * @param resume - Receives -1 if the search is completed, or the position at
+ *                 which the search has to be continued otherwise.
+ * @return The position of the found substring, or -1.
+ */
+pvt_kernel_ ptrdiff_t pvt_find_simd_(const void *str, ptrdiff_t siz, const void *ptr, ptrdiff_t count, size_t elsize, ptrdiff_t *resume) {
+#if defined(pvt_simd_bytes_)
+    if (count >= 2 && siz >= count && (elsize == 1 || elsize == 2 || elsize == 4)) {
+        const char *const s    = (const char *)str;
+        const char *const p    = (const char *)ptr;
+        const size_t len       = (size_t)siz * elsize;
+        const size_t tail      = (size_t)(count - 1) * elsize;
+        const pvt_simd_t first = pvt_simd_bcast_(p, elsize);
+        const pvt_simd_t last  = pvt_simd_bcast_(p + tail, elsize);
+        const unsigned lane    = (1U << elsize) - 1U;
+        size_t cost            = 0;
+        size_t b               = 0;
+        for (; b + tail + pvt_simd_bytes_ <= len; b += pvt_simd_bytes_) {
+            unsigned mask = pvt_simd_mask_(pvt_simd_and_(pvt_simd_eq_(pvt_simd_loadu_(s + b), first, elsize),
+                                                         pvt_simd_eq_(pvt_simd_loadu_(s + b + tail), last, elsize)));
+            while (mask) {
+                const unsigned bit = pvt_ctz_(mask);
+                if (!pvt_clib_memcmp(s + b + bit + elsize, p + elsize, tail - elsize)) {
+                    *resume = -1;
+                    return (ptrdiff_t)((b + bit) / elsize);
+                }
+                cost += (size_t)count;
+                if (cost > 4 * (b / elsize) + 256) {
+                    *resume = (ptrdiff_t)((b + bit) / elsize) + 1;
+                    return -1;
+                }
+                mask &= ~(lane << bit);
+            }
+        }
+        *resume = (ptrdiff_t)(b / elsize);
+        return -1;
+    }
+#else
+    (void)str;
+    (void)siz;
+    (void)ptr;
+    (void)count;
+    (void)elsize;
+#endif
+    *resume = 0;
+    return -1;
+}
+
+/**
+ * @brief pvt_find_char_simd_ - For internal use, find the first character equal
+ *                              or not equal (depending on `not_eq`) to the
+ *                              character pointed to by `pchar`.
+ * @details Vectors are scanned for 1-, 2- and 4-byte characters if SSE2 is
+ *          available. Otherwise `pvt_clib_memchr` or `pvt_clib_wmemchr` are
+ *          used where they apply.
+ * @param str    - Pointer to the first character of the string to search in.
+ * @param siz    - Length of the string to search in.
+ * @param offset - Pointer to the position at which to begin searching. It
+ *                 receives the position of the found character or -1.
+ * @param pchar  - Pointer to the character to search for.
+ * @param elsize - Size of the characters in bytes.
+ * @param not_eq - 0 to find an equal character, 1 to find a different one.
+ * @return 1 if the search was performed, 0 if it has to be done by the caller.
+ */
+pvt_kernel_ int pvt_find_char_simd_(const void *str, ptrdiff_t siz, ptrdiff_t *offset, const void *pchar, size_t elsize, int not_eq) {
+    const char *const s = (const char *)str;
+    const ptrdiff_t pos = *offset;
+    if (pos < 0 || pos >= siz) {
+        return 0;
+    }
+#if defined(pvt_simd_bytes_)
+    if ((elsize == 1 || elsize == 2 || elsize == 4) && (size_t)siz * elsize >= pvt_simd_bytes_) {
+        const size_t len     = (size_t)siz * elsize;
+        const pvt_simd_t chr = pvt_simd_bcast_(pchar, elsize);
+        const unsigned flip  = not_eq ? pvt_simd_all_ : 0U;
+        size_t b             = (size_t)pos * elsize;
+        unsigned mask;
+        for (; b + pvt_simd_bytes_ <= len; b += pvt_simd_bytes_) {
+            mask = pvt_simd_mask_(pvt_simd_eq_(pvt_simd_loadu_(s + b), chr, elsize)) ^ flip;
+            if (mask) {
+                *offset = (ptrdiff_t)((b + pvt_ctz_(mask)) / elsize);
+                return 1;
+            }
+        }
+        if (b < len) {
+            const size_t tail = len - pvt_simd_bytes_;
+            mask              = (pvt_simd_mask_(pvt_simd_eq_(pvt_simd_loadu_(s + tail), chr, elsize)) ^ flip) & (~0U << (b - tail));
+            if (mask) {
+                *offset = (ptrdiff_t)((tail + pvt_ctz_(mask)) / elsize);
+                return 1;
+            }
+        }
+        *offset = (ptrdiff_t)-1;
+        return 1;
+    }
+#else
+    if (!not_eq && elsize == 1) {
+        const char *const hit = (const char *)pvt_clib_memchr(s + pos, *(const unsigned char *)pchar, (size_t)(siz - pos));
+        *offset               = hit ? (ptrdiff_t)(hit - s) : (ptrdiff_t)-1;
+        return 1;
+    }
+    if (!not_eq && elsize == sizeof(wchar_t)) {
+        wchar_t wc;
+        const wchar_t *hit;
+        pvt_clib_memcpy(&wc, pchar, sizeof(wc));
+        hit     = pvt_clib_wmemchr((const wchar_t *)str + pos, wc, (size_t)(siz - pos));
+        *offset = hit ? (ptrdiff_t)(hit - (const wchar_t *)str) : (ptrdiff_t)-1;
+        return 1;
+    }
+#endif
+    (void)s;
+    (void)pchar;
+    (void)elsize;
+    (void)not_eq;
+    return 0;
+}
+
+/**
+ * @brief pvt_rfind_char_simd_ - For internal use, find the last character equal
+ *                               or not equal (depending on `not_eq`) to the
+ *                               character pointed to by `pchar`.
+ * @details Vectors are scanned for 1-, 2- and 4-byte characters if SSE2 is
+ *          available.
+ * @param str    - Pointer to the first character of the string to search in.
+ * @param offset - Pointer to the position at which to begin searching,
+ *                 proceeded from right to left. It receives the position of
+ *                 the found character or -1.
+ * @param pchar  - Pointer to the character to search for.
+ * @param elsize - Size of the characters in bytes.
+ * @param not_eq - 0 to find an equal character, 1 to find a different one.
+ * @return 1 if the search was performed, 0 if it has to be done by the caller.
+ */
+pvt_kernel_ int pvt_rfind_char_simd_(const void *str, ptrdiff_t *offset, const void *pchar, size_t elsize, int not_eq) {
+#if defined(pvt_simd_bytes_)
+    const ptrdiff_t pos = *offset;
+    if (pos >= 0 && (elsize == 1 || elsize == 2 || elsize == 4) && (size_t)(pos + 1) * elsize >= pvt_simd_bytes_) {
+        const char *const s  = (const char *)str;
+        const pvt_simd_t chr = pvt_simd_bcast_(pchar, elsize);
+        const unsigned flip  = not_eq ? pvt_simd_all_ : 0U;
+        size_t end           = (size_t)(pos + 1) * elsize;
+        unsigned mask;
+        for (; end >= pvt_simd_bytes_; end -= pvt_simd_bytes_) {
+            mask = pvt_simd_mask_(pvt_simd_eq_(pvt_simd_loadu_(s + end - pvt_simd_bytes_), chr, elsize)) ^ flip;
+            if (mask) {
+                *offset = (ptrdiff_t)((end - pvt_simd_bytes_ + pvt_msb_(mask)) / elsize);
+                return 1;
+            }
+        }
+        if (end) {
+            mask = (pvt_simd_mask_(pvt_simd_eq_(pvt_simd_loadu_(s), chr, elsize)) ^ flip) & ((1U << end) - 1U);
+            if (mask) {
+                *offset = (ptrdiff_t)(pvt_msb_(mask) / elsize);
+                return 1;
+            }
+        }
+        *offset = (ptrdiff_t)-1;
+        return 1;
+    }
+#endif
+    (void)str;
+    (void)offset;
+    (void)pchar;
+    (void)elsize;
+    (void)not_eq;
+    return 0;
+}
+
+/* ---------------------- */
+/* --- character sets --- */
+
+/**
+ * @brief pvt_charset_clear_ - For internal use, empty a character set.
+ * @param set - The character set.
+ * @return void
+ */
+pvt_inline_ void pvt_charset_clear_(pvt_charset_t *set) {
+    pvt_clib_memset(set, 0, sizeof(*set));
+}
+
+/**
+ * @brief pvt_charset_slot_ - For internal use, get the preferred slot of a
+ *                            character in the hash table of a character set.
+ * @param chr - The character value.
+ * @return The slot index.
+ */
+pvt_inline_ size_t pvt_charset_slot_(size_t chr) {
+    return (chr ^ (chr >> 6) ^ (chr >> 12)) & (pvt_charset_slots_ - 1);
+}
+
+/**
+ * @brief pvt_charset_add_ - For internal use, add a character to a set.
+ * @details Values below 256 are kept in an exact bitmap. Greater values are
+ *          kept in a hash table that is filled at most half. Values that don't
+ *          fit any longer are not stored, and the set is marked as overflowed.
+ * @param set - The character set.
+ * @param chr - The character value.
+ * @return void
+ */
+pvt_inline_ void pvt_charset_add_(pvt_charset_t *set, size_t chr) {
+    size_t i;
+    if (chr < 256) {
+        set->low[chr >> 3] |= (unsigned char)(1U << (chr & 7));
+        return;
+    }
+    for (i = pvt_charset_slot_(chr); set->high[i] && set->high[i] != chr; i = (i + 1) & (pvt_charset_slots_ - 1))
+        ;
+    if (!set->high[i]) {
+        if (set->used < pvt_charset_slots_ / 2) {
+            set->high[i] = chr;
+            ++set->used;
+        } else {
+            set->overflow = 1;
+        }
+    }
+}
+
+/**
+ * @brief pvt_charset_test_ - For internal use, check whether a character is in
+ *                            a set.
+ * @param set - The character set.
+ * @param chr - The character value.
+ * @return 1 if the character is in the set, 0 if it isn't, -1 if this can't
+ *         be told because the set is overflowed.
+ */
+pvt_inline_ int pvt_charset_test_(const pvt_charset_t *set, size_t chr) {
+    size_t i;
+    if (chr < 256) {
+        return (set->low[chr >> 3] >> (chr & 7)) & 1;
+    }
+    for (i = pvt_charset_slot_(chr); set->high[i]; i = (i + 1) & (pvt_charset_slots_ - 1)) {
+        if (set->high[i] == chr) {
+            return 1;
+        }
+    }
+    return set->overflow ? -1 : 0;
+}
+
+/**
+ * @brief pvt_find_of_simd_ - For internal use, find the first character equal
+ *                            to one or none (depending on `not_of`) of the
+ *                            characters in a small set.
+ * @details Each vector is compared with every character of the set, which is
+ *          used for sets of up to 16 characters of 1, 2 or 4 bytes.
+ * @param str    - Pointer to the first character of the string to search in.
+ * @param siz    - Length of the string to search in.
+ * @param offset - Pointer to the position at which to begin searching. It
+ *                 receives the position of the found character or -1.
+ * @param ptr    - Pointer to the first character of the set.
+ * @param count  - The number of characters in the set.
+ * @param elsize - Size of the characters in bytes.
+ * @param not_of - 0 to find a character in the set, 1 to find one not in it.
+ * @return 1 if the search was performed, 0 if it has to be done by the caller.
+ */
+pvt_kernel_ int pvt_find_of_simd_(const void *str, ptrdiff_t siz, ptrdiff_t *offset, const void *ptr, ptrdiff_t count, size_t elsize, int not_of) {
+#if defined(pvt_simd_bytes_)
+    const ptrdiff_t pos = *offset;
+    if (pos >= 0 && pos < siz && count <= 16 && (elsize == 1 || elsize == 2 || elsize == 4) && (size_t)siz * elsize >= pvt_simd_bytes_) {
+        const char *const s = (const char *)str;
+        const size_t len    = (size_t)siz * elsize;
+        const unsigned flip = not_of ? pvt_simd_all_ : 0U;
+        size_t b            = (size_t)pos * elsize;
+        pvt_simd_t set[16];
+        unsigned mask;
+        ptrdiff_t k = 0;
+        for (; k < count; ++k) {
+            set[k] = pvt_simd_bcast_((const char *)ptr + (size_t)k * elsize, elsize);
+        }
+        for (; b + pvt_simd_bytes_ <= len; b += pvt_simd_bytes_) {
+            mask = pvt_simd_of_mask_(s + b, set, count, elsize) ^ flip;
+            if (mask) {
+                *offset = (ptrdiff_t)((b + pvt_ctz_(mask)) / elsize);
+                return 1;
+            }
+        }
+        if (b < len) {
+            const size_t tail = len - pvt_simd_bytes_;
+            mask              = (pvt_simd_of_mask_(s + tail, set, count, elsize) ^ flip) & (~0U << (b - tail));
+            if (mask) {
+                *offset = (ptrdiff_t)((tail + pvt_ctz_(mask)) / elsize);
+                return 1;
+            }
+        }
+        *offset = (ptrdiff_t)-1;
+        return 1;
+    }
+#endif
+    (void)str;
+    (void)siz;
+    (void)offset;
+    (void)ptr;
+    (void)count;
+    (void)elsize;
+    (void)not_of;
+    return 0;
+}
+
+/**
+ * @brief pvt_rfind_of_simd_ - For internal use, find the last character equal
+ *                             to one or none (depending on `not_of`) of the
+ *                             characters in a small set.
+ * @details Each vector is compared with every character of the set, which is
+ *          used for sets of up to 16 characters of 1, 2 or 4 bytes.
+ * @param str    - Pointer to the first character of the string to search in.
+ * @param offset - Pointer to the position at which to begin searching,
+ *                 proceeded from right to left. It receives the position of
+ *                 the found character or -1.
+ * @param ptr    - Pointer to the first character of the set.
+ * @param count  - The number of characters in the set.
+ * @param elsize - Size of the characters in bytes.
+ * @param not_of - 0 to find a character in the set, 1 to find one not in it.
+ * @return 1 if the search was performed, 0 if it has to be done by the caller.
+ */
+pvt_kernel_ int pvt_rfind_of_simd_(const void *str, ptrdiff_t *offset, const void *ptr, ptrdiff_t count, size_t elsize, int not_of) {
+#if defined(pvt_simd_bytes_)
+    const ptrdiff_t pos = *offset;
+    if (pos >= 0 && count <= 16 && (elsize == 1 || elsize == 2 || elsize == 4) && (size_t)(pos + 1) * elsize >= pvt_simd_bytes_) {
+        const char *const s = (const char *)str;
+        const unsigned flip = not_of ? pvt_simd_all_ : 0U;
+        size_t end          = (size_t)(pos + 1) * elsize;
+        pvt_simd_t set[16];
+        unsigned mask;
+        ptrdiff_t k = 0;
+        for (; k < count; ++k) {
+            set[k] = pvt_simd_bcast_((const char *)ptr + (size_t)k * elsize, elsize);
+        }
+        for (; end >= pvt_simd_bytes_; end -= pvt_simd_bytes_) {
+            mask = pvt_simd_of_mask_(s + end - pvt_simd_bytes_, set, count, elsize) ^ flip;
+            if (mask) {
+                *offset = (ptrdiff_t)((end - pvt_simd_bytes_ + pvt_msb_(mask)) / elsize);
+                return 1;
+            }
+        }
+        if (end) {
+            mask = (pvt_simd_of_mask_(s, set, count, elsize) ^ flip) & ((1U << end) - 1U);
+            if (mask) {
+                *offset = (ptrdiff_t)(pvt_msb_(mask) / elsize);
+                return 1;
+            }
+        }
+        *offset = (ptrdiff_t)-1;
+        return 1;
+    }
+#endif
+    (void)str;
+    (void)offset;
+    (void)ptr;
+    (void)count;
+    (void)elsize;
+    (void)not_of;
+    return 0;
+}
+
+/**
+ * @brief pvt_find_mismatch_ - For internal use, find the first position at
+ *                             which two character sequences differ.
+ * @details Whole vectors are compared if SSE2 is available, blocks of
+ *          `pvt_clib_memcmp` otherwise.
+ * @param s1     - Pointer to the first sequence.
+ * @param s2     - Pointer to the second sequence.
+ * @param n      - The number of characters to compare.
+ * @param elsize - Size of the characters in bytes.
+ * @return The position of the first differing character, or `n` if the
+ *         sequences are equal.
+ */
+pvt_kernel_ size_t pvt_find_mismatch_(const void *s1, const void *s2, size_t n, size_t elsize) {
+    const char *const a = (const char *)s1;
+    const char *const b = (const char *)s2;
+    const size_t len    = n * elsize;
+    size_t i            = 0;
+#if defined(pvt_simd_bytes_)
+    for (; i + pvt_simd_bytes_ <= len; i += pvt_simd_bytes_) {
+        const unsigned mask = pvt_simd_mask_(pvt_simd_eq8_(pvt_simd_loadu_(a + i), pvt_simd_loadu_(b + i))) ^ pvt_simd_all_;
+        if (mask) {
+            return (i + pvt_ctz_(mask)) / elsize;
+        }
+    }
+#else
+    for (; i + 64 <= len && !pvt_clib_memcmp(a + i, b + i, 64); i += 64)
+        ;
+#endif
+    for (; i < len && a[i] == b[i]; ++i)
+        ;
+    return i / elsize;
+}
+
+/* ----------------------------- */
+/* --- multi-pattern matcher --- */
+
+/**
+ * @brief pvt_matcher_build_ - For internal use, compile an Aho-Corasick
+ *                             automaton.
+ * @details The failure links are resolved into the transition table, so that
+ *          every byte of the searched string takes exactly one transition.
+ * @param pat    - The patterns, cstrings of the same character type.
+ * @param n      - The number of patterns.
+ * @param elsize - Size of the characters in bytes.
+ * @return The matcher, or NULL if the allocation failed.
+ */
+pvt_inline_ pvt_matcher_t *pvt_matcher_build_(void *const *pat, size_t n, size_t elsize) {
+    unsigned short cls[256];
+    size_t classes = 1, total = 0, used = 1, head = 0, tail = 0, i, j, c;
+    size_t bytes;
+    pvt_matcher_t *m;
+    unsigned *fail;
+    pvt_clib_memset(cls, 0, sizeof(cls));
+    for (i = 0; i < n; ++i) {
+        const unsigned char *const p = (const unsigned char *)pat[i];
+        const size_t len             = p ? (pvt_dat_to_const_base_(p)->size - 1) * elsize : 0;
+        total += len;
+        for (j = 0; j < len; ++j) {
+            if (!cls[p[j]]) {
+                cls[p[j]] = (unsigned short)classes++;
+            }
+        }
+    }
+    ++total;
+    bytes = sizeof(pvt_matcher_t) + n * sizeof(size_t) + (total * classes + 2 * total) * sizeof(unsigned);
+    m     = (pvt_matcher_t *)pvt_clib_malloc(bytes);
+    fail  = (unsigned *)pvt_clib_malloc(2 * total * sizeof(unsigned));
+    if (!m || !fail) {
+        pvt_clib_free(m);
+        pvt_clib_free(fail);
+        return NULL;
+    }
+    pvt_clib_memset(m, 0, bytes);
+    pvt_clib_memcpy(m->cls, cls, sizeof(cls));
+    m->classes  = classes;
+    m->patterns = n;
+    m->elsize   = elsize;
+    m->len      = (size_t *)(void *)(m + 1);
+    m->next     = (unsigned *)(void *)(m->len + n);
+    m->out      = m->next + total * classes;
+    m->link     = m->out + total;
+    /* trie */
+    for (i = 0; i < n; ++i) {
+        const unsigned char *const p = (const unsigned char *)pat[i];
+        const size_t len             = p ? (pvt_dat_to_const_base_(p)->size - 1) * elsize : 0;
+        unsigned state               = 0;
+        m->len[i]                    = len / elsize;
+        if (!len) {
+            continue;
+        }
+        for (j = 0; j < len; ++j) {
+            unsigned *const edge = &m->next[state * classes + cls[p[j]]];
+            if (!*edge) {
+                *edge = (unsigned)used++;
+            }
+            state = *edge;
+        }
+        if (!m->out[state]) {
+            m->out[state] = (unsigned)(i + 1);
+        }
+    }
+    m->states = used;
+    /* breadth-first resolution of the failure links, `fail + total` is the queue */
+    fail[0] = 0;
+    for (c = 0; c < classes; ++c) {
+        const unsigned s = m->next[c];
+        if (s) {
+            fail[s]              = 0;
+            fail[total + tail++] = s;
+        }
+    }
+    while (head < tail) {
+        const unsigned r = fail[total + head++];
+        for (c = 0; c < classes; ++c) {
+            const unsigned s = m->next[r * classes + c];
+            const unsigned f = m->next[fail[r] * classes + c];
+            if (s) {
+                fail[s]              = f;
+                m->link[s]           = m->out[f] ? f : m->link[f];
+                fail[total + tail++] = s;
+            } else {
+                m->next[r * classes + c] = f;
+            }
+        }
+    }
+    pvt_clib_free(fail);
+    return m;
+}
+
+/**
+ * @brief pvt_matcher_free_ - For internal use, release a matcher.
+ * @param m - The matcher. Can be NULL.
+ * @return void
+ */
+pvt_inline_ void pvt_matcher_free_(pvt_matcher_t *m) {
+    pvt_clib_free(m);
+}
+
+/**
+ * @brief pvt_matcher_next_ - For internal use, find the next occurrence of any
+ *                            pattern.
+ * @details The automaton takes the bytes of a whole character before it checks
+ *          for an output, so only occurrences that end at a character boundary
+ *          are reported.
+ * @param m          - The matcher.
+ * @param s          - Pointer to the first byte of the string to search in.
+ * @param len        - Length of the string in bytes.
+ * @param cur        - The cursor, initially zeroed.
+ * @param ret_offset - Receives the position of the occurrence in characters.
+ * @param ret_id     - Receives the ID of the pattern.
+ * @return 1 if an occurrence is found, 0 otherwise.
+ */
+pvt_inline_ int pvt_matcher_next_(const pvt_matcher_t *m, const unsigned char *s, size_t len, pvt_matcher_cursor_t *cur, ptrdiff_t *ret_offset, size_t *ret_id) {
+    const size_t elsize = m->elsize;
+    size_t pos          = cur->pos;
+    unsigned state      = cur->state;
+    unsigned t          = cur->chain;
+    if (elsize == 1) {
+        while (!t && pos < len) {
+            state = m->next[state * m->classes + m->cls[s[pos++]]];
+            t     = m->out[state] ? state : m->link[state];
+        }
+    } else {
+        while (!t && pos < len) {
+            const size_t end = pos + elsize;
+            do {
+                state = m->next[state * m->classes + m->cls[s[pos]]];
+            } while (++pos < end);
+            t = m->out[state] ? state : m->link[state];
+        }
+    }
+    cur->pos   = pos;
+    cur->state = state;
+    if (!t) {
+        return 0;
+    }
+    *ret_id     = m->out[t] - 1;
+    *ret_offset = (ptrdiff_t)(pos / elsize - m->len[*ret_id]);
+    cur->chain  = m->link[t];
+    return 1;
+}
+
+/**
+ * @brief pvt_matcher_first_ - For internal use, find the occurrence of any
+ *                             pattern that ends first.
+ * @param m          - The matcher.
+ * @param str        - Pointer to the first character of the string.
+ * @param siz        - Length of the string.
+ * @param elsize     - Size of the characters in bytes.
+ * @param ret_offset - Receives the position of the occurrence, or -1.
+ * @param ret_id     - Receives the ID of the pattern.
+ * @return void
+ */
+pvt_inline_ void pvt_matcher_first_(const pvt_matcher_t *m, const void *str, size_t siz, size_t elsize, ptrdiff_t *ret_offset, size_t *ret_id) {
+    pvt_matcher_cursor_t cur = {0, 0, 0};
+    *ret_offset              = (ptrdiff_t)-1;
+    if (m && str) {
+        pvt_clib_assert(m->elsize == elsize);
+        if (!pvt_matcher_next_(m, (const unsigned char *)str, siz * elsize, &cur, ret_offset, ret_id)) {
+            *ret_offset = (ptrdiff_t)-1;
+        }
+    }
+}
+
+/**
+ * @brief pvt_matcher_all_ - For internal use, find all occurrences of all
+ *                           patterns.
+ * @param m           - The matcher.
+ * @param str         - Pointer to the first character of the string.
+ * @param siz         - Length of the string.
+ * @param elsize      - Size of the characters in bytes.
+ * @param ret_offsets - Receives the vector of positions.
+ * @param ret_ids     - Receives the vector of pattern IDs.
+ * @return void
+ */
+pvt_inline_ void pvt_matcher_all_(const pvt_matcher_t *m, const void *str, size_t siz, size_t elsize, ptrdiff_t **ret_offsets, size_t **ret_ids) {
+    pvt_matcher_cursor_t cur = {0, 0, 0};
+    ptrdiff_t offset;
+    size_t id;
+    cstring_clear(*ret_offsets);
+    cstring_clear(*ret_ids);
+    if (m && str) {
+        pvt_clib_assert(m->elsize == elsize);
+        while (pvt_matcher_next_(m, (const unsigned char *)str, siz * elsize, &cur, &offset, &id)) {
+            cstring_push_back(*ret_offsets, offset);
+            cstring_push_back(*ret_ids, id);
+        }
+    }
+}
+
+/**
+ * @brief pvt_matcher_ids_ - For internal use, get the IDs of the patterns that
+ *                           occur.
+ * @param m       - The matcher.
+ * @param str     - Pointer to the first character of the string.
+ * @param siz     - Length of the string.
+ * @param elsize  - Size of the characters in bytes.
+ * @param ret_ids - Receives the vector of pattern IDs.
+ * @return void
+ */
+pvt_inline_ void pvt_matcher_ids_(const pvt_matcher_t *m, const void *str, size_t siz, size_t elsize, size_t **ret_ids) {
+    pvt_matcher_cursor_t cur = {0, 0, 0};
+    ptrdiff_t offset;
+    size_t id;
+    cstring_clear(*ret_ids);
+    if (m && str && m->patterns) {
+        unsigned char *const seen = (unsigned char *)pvt_clib_malloc((m->patterns + CHAR_BIT - 1) / CHAR_BIT);
+        pvt_clib_assert(m->elsize == elsize);
+        pvt_clib_assert(seen);
+        if (!seen) {
+            return;
+        }
+        pvt_clib_memset(seen, 0, (m->patterns + CHAR_BIT - 1) / CHAR_BIT);
+        while (pvt_matcher_next_(m, (const unsigned char *)str, siz * elsize, &cur, &offset, &id)) {
+            if (!(seen[id / CHAR_BIT] & (1U << (id % CHAR_BIT)))) {
+                seen[id / CHAR_BIT] |= (unsigned char)(1U << (id % CHAR_BIT));
+                cstring_push_back(*ret_ids, id);
+            }
+        }
+        pvt_clib_free(seen);
+    }
+}
+
+/* ------------------ */
+/* --- edit batch --- */
+
+#include <stdlib.h>
+
+/**
+ * @brief pvt_edit_cmp_ - For internal use, order the operations of an edit
+ *                        batch by position and insertion order.
+ * @param a - Pointer to the first operation.
+ * @param b - Pointer to the second operation.
+ * @return Negative, zero or positive like for `qsort()`.
+ */
+pvt_inline_ int pvt_edit_cmp_(const void *a, const void *b) {
+    const size_t *const x = (const size_t *)a, *const y = (const size_t *)b;
+    if (x[0] != y[0]) {
+        return x[0] < y[0] ? -1 : 1;
+    }
+    return x[2] < y[2] ? -1 : (x[2] > y[2]);
+}
+
+/**
+ * @brief pvt_edit_plan_ - For internal use, sort and normalize the operations
+ *                         of an edit batch.
+ * @details The erased ranges are clipped to the string and to each other. The
+ *          returned headroom is the maximum growth of any prefix of the result,
+ *          i.e. the distance by which the content has to be moved towards the
+ *          end of the buffer so that writing the result from the front never
+ *          overtakes reading the original.
+ * @param ops     - The operations.
+ * @param n       - Number of operations.
+ * @param siz     - Length of the original string.
+ * @param ret_siz - Receives the length of the result.
+ * @return The headroom.
+ */
+pvt_inline_ size_t pvt_edit_plan_(size_t *ops, size_t n, size_t siz, size_t *ret_siz) {
+    size_t i, end = 0, head = 0, grow = 0, shrink = 0;
+    for (i = 1; i < n; ++i) {
+        if (pvt_edit_cmp_(ops + 4 * (i - 1), ops + 4 * i) > 0) {
+            qsort(ops, n, 4 * sizeof(size_t), pvt_edit_cmp_);
+            break;
+        }
+    }
+    for (i = 0; i < n; ++i) {
+        size_t *const op = ops + 4 * i;
+        const size_t pos = op[0] < end ? end : (op[0] > siz ? siz : op[0]);
+        const size_t lim = op[0] < siz && op[1] < siz - op[0] ? op[0] + op[1] : siz;
+        op[0]            = pos;
+        op[1]            = lim > pos ? lim - pos : 0;
+        end              = pos + op[1];
+        grow += op[3];
+        shrink += op[1];
+        if (grow > shrink && grow - shrink > head) {
+            head = grow - shrink;
+        }
+    }
+    *ret_siz = siz + grow - shrink;
+    return head;
+}
+
+/**
+ * @brief pvt_edit_run_ - For internal use, apply the normalized operations of
+ *                        an edit batch.
+ * @param str    - Pointer to the first character of the string. The buffer
+ *                 must have room for `siz + head` characters.
+ * @param elsize - Size of the characters in bytes.
+ * @param siz    - Length of the original string.
+ * @param head   - The headroom returned by pvt_edit_plan_.
+ * @param ops    - The operations.
+ * @param n      - Number of operations.
+ * @param text   - The concatenated replacements.
+ * @return void
+ */
+pvt_inline_ void pvt_edit_run_(void *str, size_t elsize, size_t siz, size_t head, const size_t *ops, size_t n, const void *text) {
+    unsigned char *const s       = (unsigned char *)str;
+    const unsigned char *const t = (const unsigned char *)text;
+    size_t i, rd = 0, wr = 0;
+    if (head) {
+        pvt_clib_memmove(s + head * elsize, s, siz * elsize);
+    }
+    for (i = 0; i < n; ++i) {
+        const size_t *const op = ops + 4 * i;
+        pvt_clib_memmove(s + wr * elsize, s + (head + rd) * elsize, (op[0] - rd) * elsize);
+        wr += op[0] - rd;
+        if (op[3]) {
+            pvt_clib_memcpy(s + wr * elsize, t + op[2] * elsize, op[3] * elsize);
+            wr += op[3];
+        }
+        rd = op[0] + op[1];
+    }
+    pvt_clib_memmove(s + wr * elsize, s + (head + rd) * elsize, (siz - rd) * elsize);
+}
+
+/* ------------ */
+/* --- rope --- */
+
+/**
+ * @brief pvt_rope_leaf_max_ - For internal use, get the maximum number of
+ *                             characters in a leaf of a rope.
+ * @param elsize - Size of the characters in bytes.
+ * @return The number of characters.
+ */
+pvt_inline_ size_t pvt_rope_leaf_max_(size_t elsize) {
+    return (pvt_rope_leaf_bytes / elsize) ? (size_t)(pvt_rope_leaf_bytes / elsize) : (size_t)1;
+}
+
+/**
+ * @brief pvt_rope_height_ - For internal use, get the height of a rope node.
+ * @param n - The node. Can be NULL.
+ * @return The height, 0 for NULL.
+ */
+pvt_inline_ size_t pvt_rope_height_(const pvt_rope_node_t *n) {
+    return n ? n->height : 0;
+}
+
+/**
+ * @brief pvt_rope_retain_ - For internal use, add a reference to a rope node.
+ * @param n - The node. Can be NULL.
+ * @return The node.
+ */
+pvt_inline_ pvt_rope_node_t *pvt_rope_retain_(pvt_rope_node_t *n) {
+    if (n) {
+        ++n->refs;
+    }
+    return n;
+}
+
+/**
+ * @brief pvt_rope_release_ - For internal use, remove a reference to a rope
+ *                            node, and release it if it was the last one.
+ * @details The recursion depth is bounded by the height of the tree.
+ * @param n - The node. Can be NULL.
+ * @return void
+ */
+pvt_inline_ void pvt_rope_release_(pvt_rope_node_t *n) {
+    if (n && !--n->refs) {
+        pvt_rope_release_(n->left);
+        pvt_rope_release_(n->right);
+        pvt_clib_free(n);
+    }
+}
+
+/**
+ * @brief pvt_rope_leaf_ - For internal use, create a leaf from two pieces of
+ *                         characters.
+ * @param p1     - Pointer to the first piece.
+ * @param n1     - Number of characters in the first piece.
+ * @param p2     - Pointer to the second piece.
+ * @param n2     - Number of characters in the second piece.
+ * @param elsize - Size of the characters in bytes.
+ * @return The leaf, or NULL if it would be empty.
+ */
+pvt_inline_ pvt_rope_node_t *pvt_rope_leaf_(const void *p1, size_t n1, const void *p2, size_t n2, size_t elsize) {
+    pvt_rope_node_t *n;
+    if (!(n1 + n2)) {
+        return NULL;
+    }
+    n = (pvt_rope_node_t *)pvt_clib_malloc(sizeof(pvt_rope_node_t) + (n1 + n2) * elsize);
+    pvt_clib_assert(n);
+    if (!n) {
+        return NULL;
+    }
+    n->left   = NULL;
+    n->right  = NULL;
+    n->size   = n1 + n2;
+    n->height = 1;
+    n->refs   = 1;
+    if (n1) {
+        pvt_clib_memcpy(n + 1, p1, n1 * elsize);
+    }
+    if (n2) {
+        pvt_clib_memcpy((unsigned char *)(n + 1) + n1 * elsize, p2, n2 * elsize);
+    }
+    return n;
+}
+
+/**
+ * @brief pvt_rope_make_ - For internal use, create an inner node.
+ * @param l - The left subtree. Its reference is taken over.
+ * @param r - The right subtree. Its reference is taken over.
+ * @return The node.
+ */
+pvt_inline_ pvt_rope_node_t *pvt_rope_make_(pvt_rope_node_t *l, pvt_rope_node_t *r) {
+    pvt_rope_node_t *const n = (pvt_rope_node_t *)pvt_clib_malloc(sizeof(pvt_rope_node_t));
+    pvt_clib_assert(n);
+    if (!n) {
+        return NULL;
+    }
+    n->left   = l;
+    n->right  = r;
+    n->size   = l->size + r->size;
+    n->height = 1 + (l->height > r->height ? l->height : r->height);
+    n->refs   = 1;
+    return n;
+}
+
+/**
+ * @brief pvt_rope_balance_ - For internal use, create an inner node of two
+ *                            subtrees whose heights differ by at most 2, and
+ *                            rotate it if necessary.
+ * @details The nodes are immutable, so rotations create new nodes and share
+ *          the grandchildren.
+ * @param l - The left subtree. Its reference is taken over.
+ * @param r - The right subtree. Its reference is taken over.
+ * @return The node.
+ */
+pvt_inline_ pvt_rope_node_t *pvt_rope_balance_(pvt_rope_node_t *l, pvt_rope_node_t *r) {
+    pvt_rope_node_t *res;
+    if (r->height > l->height + 1) {
+        if (pvt_rope_height_(r->left) > pvt_rope_height_(r->right)) {
+            pvt_rope_node_t *const c = r->left;
+            res                      = pvt_rope_make_(pvt_rope_make_(l, pvt_rope_retain_(c->left)),
+                                                      pvt_rope_make_(pvt_rope_retain_(c->right), pvt_rope_retain_(r->right)));
+        } else {
+            res = pvt_rope_make_(pvt_rope_make_(l, pvt_rope_retain_(r->left)), pvt_rope_retain_(r->right));
+        }
+        pvt_rope_release_(r);
+    } else if (l->height > r->height + 1) {
+        if (pvt_rope_height_(l->right) > pvt_rope_height_(l->left)) {
+            pvt_rope_node_t *const c = l->right;
+            res                      = pvt_rope_make_(pvt_rope_make_(pvt_rope_retain_(l->left), pvt_rope_retain_(c->left)),
+                                                      pvt_rope_make_(pvt_rope_retain_(c->right), r));
+        } else {
+            res = pvt_rope_make_(pvt_rope_retain_(l->left), pvt_rope_make_(pvt_rope_retain_(l->right), r));
+        }
+        pvt_rope_release_(l);
+    } else {
+        res = pvt_rope_make_(l, r);
+    }
+    return res;
+}
+
+/**
+ * @brief pvt_rope_join_ - For internal use, concatenate two ropes.
+ * @details The higher tree is descended along its inner spine down to the
+ *          height of the lower one, hence the time is proportional to the
+ *          difference of the heights. Two small leaves are merged.
+ * @param l      - The left rope. Can be NULL. Its reference is taken over.
+ * @param r      - The right rope. Can be NULL. Its reference is taken over.
+ * @param elsize - Size of the characters in bytes.
+ * @return The concatenation.
+ */
+pvt_inline_ pvt_rope_node_t *pvt_rope_join_(pvt_rope_node_t *l, pvt_rope_node_t *r, size_t elsize) {
+    pvt_rope_node_t *res;
+    if (!l || !r) {
+        return l ? l : r;
+    }
+    if (l->height == 1 && r->height == 1 && l->size + r->size <= pvt_rope_leaf_max_(elsize)) {
+        res = pvt_rope_leaf_(l + 1, l->size, r + 1, r->size, elsize);
+        pvt_rope_release_(l);
+        pvt_rope_release_(r);
+    } else if (l->height > r->height + 1) {
+        res = pvt_rope_balance_(pvt_rope_retain_(l->left), pvt_rope_join_(pvt_rope_retain_(l->right), r, elsize));
+        pvt_rope_release_(l);
+    } else if (r->height > l->height + 1) {
+        res = pvt_rope_balance_(pvt_rope_join_(l, pvt_rope_retain_(r->left), elsize), pvt_rope_retain_(r->right));
+        pvt_rope_release_(r);
+    } else {
+        res = pvt_rope_make_(l, r);
+    }
+    return res;
+}
+
+/**
+ * @brief pvt_rope_build_ - For internal use, create a balanced rope from a
+ *                          string.
+ * @param ptr    - Pointer to the first character.
+ * @param count  - Number of characters.
+ * @param elsize - Size of the characters in bytes.
+ * @return The rope, NULL if `count` is zero.
+ */
+pvt_inline_ pvt_rope_node_t *pvt_rope_build_(const void *ptr, size_t count, size_t elsize) {
+    const size_t max = pvt_rope_leaf_max_(elsize);
+    size_t half;
+    if (!ptr || !count) {
+        return NULL;
+    }
+    if (count <= max) {
+        return pvt_rope_leaf_(ptr, count, NULL, 0, elsize);
+    }
+    half = (count / max + 1) / 2 * max;
+    return pvt_rope_join_(pvt_rope_build_(ptr, half, elsize),
+                          pvt_rope_build_((const unsigned char *)ptr + half * elsize, count - half, elsize), elsize);
+}
+
+/**
+ * @brief pvt_rope_split_ - For internal use, split a rope at a position.
+ * @param n         - The rope. It's borrowed, not taken over.
+ * @param pos       - The position, not greater than the length.
+ * @param ret_left  - Receives the characters in front of `pos`.
+ * @param ret_right - Receives the characters from `pos` on.
+ * @param elsize    - Size of the characters in bytes.
+ * @return void
+ */
+pvt_inline_ void pvt_rope_split_(pvt_rope_node_t *n, size_t pos, pvt_rope_node_t **ret_left, pvt_rope_node_t **ret_right, size_t elsize) {
+    if (!n || !pos) {
+        *ret_left  = NULL;
+        *ret_right = pvt_rope_retain_(n);
+    } else if (pos >= n->size) {
+        *ret_left  = pvt_rope_retain_(n);
+        *ret_right = NULL;
+    } else if (n->height == 1) {
+        *ret_left  = pvt_rope_leaf_(n + 1, pos, NULL, 0, elsize);
+        *ret_right = pvt_rope_leaf_((const unsigned char *)(n + 1) + pos * elsize, n->size - pos, NULL, 0, elsize);
+    } else if (pos < n->left->size) {
+        pvt_rope_node_t *r;
+        pvt_rope_split_(n->left, pos, ret_left, &r, elsize);
+        *ret_right = pvt_rope_join_(r, pvt_rope_retain_(n->right), elsize);
+    } else {
+        pvt_rope_node_t *l;
+        pvt_rope_split_(n->right, pos - n->left->size, &l, ret_right, elsize);
+        *ret_left = pvt_rope_join_(pvt_rope_retain_(n->left), l, elsize);
+    }
+}
+
+/**
+ * @brief pvt_rope_insert_ - For internal use, insert a rope into another one.
+ * @param n      - The rope. Its reference is taken over.
+ * @param pos    - The position.
+ * @param ins    - The inserted rope. Its reference is taken over.
+ * @param elsize - Size of the characters in bytes.
+ * @return The resulting rope.
+ */
+pvt_inline_ pvt_rope_node_t *pvt_rope_insert_(pvt_rope_node_t *n, size_t pos, pvt_rope_node_t *ins, size_t elsize) {
+    pvt_rope_node_t *l, *r;
+    if (!ins) {
+        return n;
+    }
+    pvt_rope_split_(n, pos, &l, &r, elsize);
+    pvt_rope_release_(n);
+    return pvt_rope_join_(pvt_rope_join_(l, ins, elsize), r, elsize);
+}
+
+/**
+ * @brief pvt_rope_sub_ - For internal use, get a part of a rope.
+ * @param n      - The rope. It's borrowed, not taken over.
+ * @param pos    - Position of the first character.
+ * @param count  - Number of characters.
+ * @param elsize - Size of the characters in bytes.
+ * @return The part of the rope.
+ */
+pvt_inline_ pvt_rope_node_t *pvt_rope_sub_(pvt_rope_node_t *n, size_t pos, size_t count, size_t elsize) {
+    pvt_rope_node_t *l, *r, *m, *rest;
+    pvt_rope_split_(n, pos, &l, &r, elsize);
+    pvt_rope_split_(r, count, &m, &rest, elsize);
+    pvt_rope_release_(l);
+    pvt_rope_release_(r);
+    pvt_rope_release_(rest);
+    return m;
+}
+
+/**
+ * @brief pvt_rope_erase_ - For internal use, erase characters from a rope.
+ * @param n      - The rope. Its reference is taken over.
+ * @param pos    - Position of the first erased character.
+ * @param count  - Number of erased characters.
+ * @param elsize - Size of the characters in bytes.
+ * @return The resulting rope.
+ */
+pvt_inline_ pvt_rope_node_t *pvt_rope_erase_(pvt_rope_node_t *n, size_t pos, size_t count, size_t elsize) {
+    pvt_rope_node_t *l, *r, *m, *rest;
+    if (!count) {
+        return n;
+    }
+    pvt_rope_split_(n, pos, &l, &r, elsize);
+    pvt_rope_release_(n);
+    pvt_rope_split_(r, count, &m, &rest, elsize);
+    pvt_rope_release_(r);
+    pvt_rope_release_(m);
+    return pvt_rope_join_(l, rest, elsize);
+}
+
+/**
+ * @brief pvt_rope_chunk_ - For internal use, find the leaf containing a
+ *                          position.
+ * @param n        - The rope.
+ * @param pos      - The position, less than the length.
+ * @param elsize   - Size of the characters in bytes.
+ * @param ret_size - Receives the number of characters from `pos` up to the end
+ *                   of the leaf. Can be NULL.
+ * @return Pointer to the character at `pos`.
+ */
+pvt_inline_ const void *pvt_rope_chunk_(const pvt_rope_node_t *n, size_t pos, size_t elsize, size_t *ret_size) {
+    while (n->height > 1) {
+        if (pos < n->left->size) {
+            n = n->left;
+        } else {
+            pos -= n->left->size;
+            n = n->right;
+        }
+    }
+    if (ret_size) {
+        *ret_size = n->size - pos;
+    }
+    return (const unsigned char *)(n + 1) + pos * elsize;
+}
+
+/**
+ * @brief pvt_rope_copy_ - For internal use, copy characters of a rope.
+ * @param n      - The rope.
+ * @param pos    - Position of the first copied character.
+ * @param count  - Number of characters, within the length of the rope.
+ * @param dst    - The destination buffer.
+ * @param elsize - Size of the characters in bytes.
+ * @return void
+ */
+pvt_inline_ void pvt_rope_copy_(const pvt_rope_node_t *n, size_t pos, size_t count, void *dst, size_t elsize) {
+    unsigned char *out = (unsigned char *)dst;
+    while (count) {
+        size_t len;
+        const void *const src = pvt_rope_chunk_(n, pos, elsize, &len);
+        if (len > count) {
+            len = count;
+        }
+        pvt_clib_memcpy(out, src, len * elsize);
+        out += len * elsize;
+        pos += len;
+        count -= len;
+    }
+}
+
+/**
+ * @brief pvt_rope_match_ - For internal use, compare characters of a rope with
+ *                          a string.
+ * @param n      - The rope.
+ * @param pos    - Position of the first compared character.
+ * @param ptr    - Pointer to the first character of the string.
+ * @param count  - Number of characters, within the length of the rope.
+ * @param elsize - Size of the characters in bytes.
+ * @return 1 if the characters are equal, 0 otherwise.
+ */
+pvt_inline_ int pvt_rope_match_(const pvt_rope_node_t *n, size_t pos, const void *ptr, size_t count, size_t elsize) {
+    const unsigned char *in = (const unsigned char *)ptr;
+    while (count) {
+        size_t len;
+        const void *const src = pvt_rope_chunk_(n, pos, elsize, &len);
+        if (len > count) {
+            len = count;
+        }
+        if (pvt_clib_memcmp(src, in, len * elsize)) {
+            return 0;
+        }
+        in += len * elsize;
+        pos += len;
+        count -= len;
+    }
+    return 1;
+}
+
+/**
+ * @brief pvt_rope_find_ - For internal use, find the first occurrence of a
+ *                         string in a rope.
+ * @details Characters are only compared for equality, so they are read as
+ *          unsigned integers of the same size.
+ * @param n      - The rope.
+ * @param pos    - Position at which to start the search.
+ * @param ptr    - Pointer to the first character of the string to search for.
+ * @param count  - Length of the string to search for.
+ * @param elsize - Size of the characters in bytes, either 1, 2 or 4.
+ * @return The position of the occurrence, or -1.
+ */
+pvt_inline_ ptrdiff_t pvt_rope_find_(const pvt_rope_node_t *n, ptrdiff_t pos, const void *ptr, ptrdiff_t count, size_t elsize) {
+    ptrdiff_t offset;
+    switch (elsize) {
+        case 1:
+            pvt_rope_find_as_(unsigned char, n, pos, ptr, count, offset);
+            break;
+        case 2:
+            pvt_rope_find_as_(unsigned short, n, pos, ptr, count, offset);
+            break;
+        default:
+            pvt_clib_assert(elsize == sizeof(unsigned int));
+            pvt_rope_find_as_(unsigned int, n, pos, ptr, count, offset);
+            break;
+    }
+    return offset;
+}
+
 /** @} */
 
 /** @endcond */